@@ -143,6 +143,162 @@ MDAL_EXPORT void MDAL_SetLoggerCallback( MDAL_LoggerCallback callback );
  */
 MDAL_EXPORT void MDAL_SetLogVerbosity( MDAL_LogLevel verbosity );
 
+/**
+ * Sets whether minimum and maximum values of datasets and dataset groups are calculated
+ * when the data is loaded (default) or on the first request (e.g. MDAL_D_minimumMaximum())
+ *
+ * With lazy statistics, loading of large files does not need to read all values,
+ * but the first request of group minimum and maximum reads all its datasets.
+ * Applies to datasets loaded after the call
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_SetLazyStatistics( bool lazy );
+
+/**
+ * Returns whether statistics are calculated on the first request, see MDAL_SetLazyStatistics()
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT bool MDAL_LazyStatistics();
+
+/**
+ * Enables or disables the persistent cache of minimum and maximum values
+ *
+ * When enabled, statistics known when the mesh is closed (MDAL_CloseMesh()) are stored
+ * in *.mdalstats file and restored when the same file is loaded again. The cache is
+ * invalidated when size or modification time of the source file changes.
+ * Only statistics that are not calculated during loading are restored, so the cache
+ * is meant to be used with lazy statistics, see MDAL_SetLazyStatistics()
+ *
+ * \param enabled whether the cache is used
+ * \param cacheDirectory directory to store the cache files. If null or empty, cache files are stored next to the source files
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_SetStatisticsCache( bool enabled, const char *cacheDirectory );
+
+/**
+ * Sets the memory budget of the process-wide cache of dataset values
+ *
+ * Datasets that read values from the file on request (e.g. NetCDF, XMDF, XDMF or Selafin)
+ * keep recently read blocks of values in the cache, the least recently used blocks
+ * are dropped when the budget is exceeded. Requests larger than the budget and reading of datasets
+ * for statistics use the cached blocks, but do not add new ones. Default budget is 64 MB, it can be also set by
+ * environment variable MDAL_BLOCK_CACHE_MB (in megabytes). Active flags cached by XMDF datasets are part of the budget.
+ *
+ * \param bytes maximum size of the cached values in bytes, 0 disables the cache
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_SetBlockCacheSize( long long bytes );
+
+/**
+ * Returns the memory budget of the cache of dataset values in bytes, see MDAL_SetBlockCacheSize()
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT long long MDAL_BlockCacheSize();
+
+/**
+ * Returns number of blocks of values found in the cache (hits) and read from
+ * the files to the cache (misses) since the last MDAL_ClearBlockCache() call
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_BlockCacheCounters( long long *hits, long long *misses );
+
+/**
+ * Drops all values from the cache of dataset values and resets its counters
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_ClearBlockCache();
+
+/**
+ * Sets the maximum size of the chunk cache of each variable of netCDF-4 files
+ *
+ * When a netCDF file is opened, the chunk cache of chunked variables is enlarged to hold all chunks
+ * touched by reading of one timestep or of a time series of one element, up to this size.
+ * Applies to files opened after the call. Default is 32 MB, it can be also set by environment
+ * variable MDAL_NETCDF_CHUNK_CACHE_MB (in megabytes).
+ *
+ * The size applies to each chunked variable of each open file separately, it is not a limit
+ * of the total memory. Memory used by the chunk caches grows with the number of open files
+ * and their variables read by MDAL.
+ *
+ * \param bytes maximum size of the chunk cache of one variable, 0 keeps the default cache of the netCDF library
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_SetNetCDFChunkCacheSize( long long bytes );
+
+/**
+ * Returns the maximum size of the chunk cache of netCDF variables, see MDAL_SetNetCDFChunkCacheSize()
+ * Returns 0 when MDAL is built without netCDF support
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT long long MDAL_NetCDFChunkCacheSize();
+
+/**
+ * Sets compression of netCDF files written by MDAL (e.g. UGRID driver)
+ *
+ * With deflate level 1-9, new files are created in netCDF-4 format, dataset variables are chunked
+ * by timesteps and all variables are compressed. With level 0, new files are created uncompressed
+ * in classic netCDF format. Datasets appended to existing classic files are never compressed.
+ * Default is level 0 (classic format, readable by netCDF-3 only tools), with shuffle filter
+ * used once the compression is enabled. It can be also set by environment variables
+ * MDAL_NETCDF_DEFLATE_LEVEL and MDAL_NETCDF_SHUFFLE (0 or 1).
+ *
+ * \param deflateLevel deflate level, clamped to 0-9
+ * \param shuffle whether to apply shuffle filter before the compression
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_SetNetCDFCompression( int deflateLevel, bool shuffle );
+
+/**
+ * Returns the deflate level of netCDF files written by MDAL, see MDAL_SetNetCDFCompression()
+ * Returns 0 when MDAL is built without netCDF support
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT int MDAL_NetCDFCompressionLevel();
+
+/**
+ * Sets sizes of the caches used to read HDF5 files (XMDF, XDMF, FLO-2D, HEC-RAS, ...)
+ *
+ * Applies to files and datasets opened after the call. Negative size keeps the current value,
+ * 0 means the default of the HDF5 library is used.
+ *
+ * \param chunkCacheBytes maximum size of the chunk cache of one dataset. The cache of chunked dataset is enlarged
+ *        to hold all chunks touched by reading of one timestep or of a time series of one element, up to this size.
+ *        Default is 32 MB, it can be also set by environment variable MDAL_HDF5_CHUNK_CACHE_MB (in megabytes).
+ *        The size applies to each open dataset separately, it is not a limit of the total memory. Drivers keep
+ *        datasets open (e.g. XMDF keeps one dataset open per output variable), so memory used by the chunk caches
+ *        grows with the number of open files and their variables.
+ * \param metadataCacheBytes initial size of the metadata cache of a file. Default is 8 MB, it can be also
+ *        set by environment variable MDAL_HDF5_METADATA_CACHE_MB (in megabytes)
+ * \param sieveBufferBytes size of the sieve buffer used for partial reads of contiguous datasets. Default is 1 MB,
+ *        it can be also set by environment variable MDAL_HDF5_SIEVE_BUFFER_KB (in kilobytes)
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_SetHdf5CacheSizes( long long chunkCacheBytes, long long metadataCacheBytes, long long sieveBufferBytes );
+
+/**
+ * Returns sizes of the caches used to read HDF5 files, see MDAL_SetHdf5CacheSizes()
+ * Sizes are 0 when MDAL is built without HDF5 support. Any of the pointers can be null
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_Hdf5CacheSizes( long long *chunkCacheBytes, long long *metadataCacheBytes, long long *sieveBufferBytes );
+
+/**
+ * Sets whether ASCII DAT files are loaded in indexed mode
+ *
+ * By default, all values of ASCII DAT files are read to memory. In indexed mode, only the positions
+ * of the timesteps are stored when the file is loaded and the values are parsed from the file
+ * when the dataset is read. Applies to files loaded after the call. Default is off,
+ * it can be also set by environment variable MDAL_ASCII_DAT_INDEXED (0 or 1).
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_SetAsciiDatIndexedMode( bool indexed );
+
+/**
+ * Returns whether ASCII DAT files are loaded in indexed mode, see MDAL_SetAsciiDatIndexedMode()
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT bool MDAL_AsciiDatIndexedMode();
+
 ///////////////////////////////////////////////////////////////////////////////////////
 /// DRIVERS
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -623,12 +779,94 @@ MDAL_EXPORT MDAL_DataLocation MDAL_G_dataLocation( MDAL_DatasetGroupH group );
  */
 MDAL_EXPORT int MDAL_G_maximumVerticalLevelCount( MDAL_DatasetGroupH group );
 
+/**
+ * Sets number of datasets (timesteps) to read in background after a dataset of the group is read
+ *
+ * When values of dataset t are read with MDAL_D_data(), datasets t+1 ... t+window are read
+ * in a background thread to the cache of dataset values (see MDAL_SetBlockCacheSize()),
+ * so animation over time does not wait for the file access. When the requested dataset
+ * is not a continuation of the previous requests, scheduled reading is cancelled.
+ * The window is limited by the cache budget. Only applies to drivers that read
+ * values from the file on request.
+ *
+ * While prefetching is enabled for any group, all functions that can access the files
+ * (loading, reading of values, vertices and faces, statistics, saving) are serialized,
+ * since the underlying libraries are not thread-safe. The background thread is stopped
+ * when prefetching is disabled for the last group.
+ *
+ * \param group handle to dataset group
+ * \param window number of datasets to read ahead, 0 disables prefetching (default)
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_G_setPrefetchWindow( MDAL_DatasetGroupH group, int window );
+
+/**
+ * Returns number of datasets read ahead, see MDAL_G_setPrefetchWindow()
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT int MDAL_G_prefetchWindow( MDAL_DatasetGroupH group );
+
+/**
+ * Waits until all datasets scheduled for reading in background are read or cancelled,
+ * see MDAL_G_setPrefetchWindow()
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_WaitForPrefetching();
+
+/**
+ * Returns values of one element (vertex, face or edge, based on data location) in \a count datasets of the group
+ * starting with dataset \a datasetIndexStart, e.g. hydrograph at a vertex
+ *
+ * Drivers that support it read the time series with a single (strided) read from the file,
+ * instead of reading each dataset separately.
+ *
+ * Only for groups with data on vertices, faces or edges.
+ *
+ * \param group handle to dataset group
+ * \param elementIndex index of the vertex, face or edge
+ * \param datasetIndexStart index of the first dataset
+ * \param count number of datasets
+ * \param buffer buffer for count doubles for scalar data, 2 * count doubles for vector data
+ * \returns number of datasets read, 0 on error
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT int MDAL_G_timeSeries( MDAL_DatasetGroupH group, int elementIndex, int datasetIndexStart, int count, double *buffer );
+
+/**
+ * Returns values of multiple elements in \a count datasets of the group, see MDAL_G_timeSeries()
+ *
+ * \param group handle to dataset group
+ * \param elementIndexes indexes of the vertices, faces or edges
+ * \param elementCount number of elements
+ * \param datasetIndexStart index of the first dataset
+ * \param count number of datasets
+ * \param buffer buffer for elementCount * count doubles for scalar data (2 * elementCount * count for vector data),
+ *        time series of the first element is followed by the time series of the second element, etc.
+ * \returns number of datasets read, 0 on error
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT int MDAL_G_timeSeriesBatch( MDAL_DatasetGroupH group,
+                                        const int *elementIndexes,
+                                        int elementCount,
+                                        int datasetIndexStart,
+                                        int count,
+                                        double *buffer );
+
 /**
  * Returns the minimum and maximum values of the group
  * Returns NaN on error
  */
 MDAL_EXPORT void MDAL_G_minimumMaximum( MDAL_DatasetGroupH group, double *min, double *max );
 
+/**
+ * Calculates the minimum and maximum values of all datasets of the group and of the group itself,
+ * if they are not calculated yet. This reads all values of the group
+ *
+ * \see MDAL_SetLazyStatistics()
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_G_computeStatistics( MDAL_DatasetGroupH group );
+
 /**
  * Adds empty (new) dataset to the group
  * This increases dataset group count MDAL_G_datasetCount() by 1
@@ -809,12 +1047,64 @@ enum MDAL_DataType
  */
 MDAL_EXPORT int MDAL_D_data( MDAL_DatasetH dataset, int indexStart, int count, MDAL_DataType dataType, void *buffer );
 
+/**
+ * Populates buffers with all values of the dataset and active flags of all faces
+ *
+ * The result is the same as MDAL_D_data() for all values and MDAL_D_data() with ACTIVE_INTEGER
+ * for all faces, but drivers can read both with a single access to the file.
+ * Only for datasets with data on vertices, faces or edges.
+ *
+ * \param dataset handle to dataset
+ * \param dataType SCALAR_DOUBLE or VECTOR_2D_DOUBLE, see MDAL_D_data()
+ * \param buffer output array for MDAL_D_valueCount() values, see MDAL_D_data()
+ * \param activeBuffer output array of faceCount * size_of(int) for the active flags, may be null.
+ *                     All faces are active when the dataset does not support active flag
+ * \returns number of values written to buffer. If return value != MDAL_D_valueCount(), see MDAL_LastStatus() for error type
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT int MDAL_D_dataWithActive( MDAL_DatasetH dataset, MDAL_DataType dataType, void *buffer, int *activeBuffer );
+
+/**
+ * Returns whether the values of the type can be accessed without copy with MDAL_D_dataPtr()
+ *
+ * This is the case for datasets that keep all values in memory, e.g. datasets
+ * created with MDAL_G_addDataset() or datasets of drivers that read the whole file
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT bool MDAL_D_hasDataPtrCapability( MDAL_DatasetH dataset, MDAL_DataType dataType );
+
+/**
+ * Returns read-only pointer to the internal storage of the values of the dataset
+ *
+ * The layout of the values is the same as in the buffer populated by MDAL_D_data() for all values
+ * of the dataset, the value with index i starts at pointer + i * stride (counted in doubles or ints).
+ * For VECTOR_2D_DOUBLE and VECTOR_2D_VOLUMES_DOUBLE, stride is 2 and y value follows x value.
+ * The pointer is valid until the mesh is closed
+ *
+ * \param dataset handle to dataset
+ * \param dataType type of values, see MDAL_D_data()
+ * \param stride output number of doubles/ints between two consecutive values
+ * \returns pointer to double or int values, nullptr if the dataset does not support direct access
+ *          for the type (see MDAL_D_hasDataPtrCapability()), use MDAL_D_data() instead
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT const void *MDAL_D_dataPtr( MDAL_DatasetH dataset, MDAL_DataType dataType, int *stride );
+
 /**
  * Returns the minimum and maximum values of the dataset
  * Returns NaN on error
  */
 MDAL_EXPORT void MDAL_D_minimumMaximum( MDAL_DatasetH dataset, double *min, double *max );
 
+/**
+ * Calculates the minimum and maximum values of the dataset, if they are not calculated yet.
+ * This reads all values of the dataset
+ *
+ * \see MDAL_SetLazyStatistics()
+ * \since MDAL 1.4.0
+ */
+MDAL_EXPORT void MDAL_D_computeStatistics( MDAL_DatasetH dataset );
+
 #ifdef __cplusplus
 }
 #endif
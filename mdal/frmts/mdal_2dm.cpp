@@ -14,11 +14,13 @@
 #include <cassert>
 #include <limits>
 #include <algorithm>
+#include <string.h>
 
 #include "mdal_2dm.hpp"
 #include "mdal.h"
 #include "mdal_utils.hpp"
 #include "mdal_logger.hpp"
+#include "mdal_memory_mapped_file.hpp"
 
 #define DRIVER_NAME "2DM"
 
@@ -115,198 +117,341 @@ bool MDAL::Driver2dm::canReadMesh( const std::string &uri )
   return true;
 }
 
-std::unique_ptr<MDAL::Mesh> MDAL::Driver2dm::load( const std::string &meshFile, const std::string & )
+/**
+ * Part of the 2dm file processed by one thread, always contains whole lines
+ * First pass counts the elements, second pass parses them to the
+ * arrays starting at first*Index
+ */
+struct Chunk2dm
 {
-  mMeshFile = meshFile;
-
-  MDAL::Log::resetLastStatus();
-
-  std::ifstream in = MDAL::openInputFile( meshFile );
-
-  std::string line;
-  if ( !std::getline( in, line ) || !startsWith( line, "MESH2D" ) )
-  {
-    MDAL::Log::error( MDAL_Status::Err_UnknownFormat, name(), meshFile + " could not be opened" );
-    return nullptr;
-  }
+  const char *begin = nullptr;
+  const char *end = nullptr;
 
   size_t faceCount = 0;
   size_t vertexCount = 0;
-  size_t edgesCount = 0;
+  size_t edgeCount = 0;
+  bool hasUnsupportedElement = false;
+  bool hasMaterialCount = false;
   size_t materialCount = 0;
-  bool hasMaterialsDefinitionsForElements = false;
 
-  std::vector<double> nativeVertexIds;
-  std::vector<double> nativeFaceIds;
-  std::vector<double> nativeEdgeIds;
+  size_t firstFaceIndex = 0;
+  size_t firstVertexIndex = 0;
+  size_t firstEdgeIndex = 0;
+  size_t maxVerticesPerFace = 2;
+  bool hasLegacyMaterial = false;
+  bool hasInvalidLine = false;
+};
 
-  // Find out how many nodes and elements are contained in the .2dm mesh file
-  while ( std::getline( in, line ) )
+static bool _startsWith( const char *line, const char *lineEnd, const char *prefix )
+{
+  const size_t length = strlen( prefix );
+  return static_cast<size_t>( lineEnd - line ) >= length && memcmp( line, prefix, length ) == 0;
+}
+
+static bool _isFaceLine( const char *line, const char *lineEnd )
+{
+  return _startsWith( line, lineEnd, "E4Q" ) ||
+         _startsWith( line, lineEnd, "E3T" ) ||
+         _startsWith( line, lineEnd, "E6T" );
+}
+
+static const char *_lineEnd( const char *line, const char *end )
+{
+  const void *found = memchr( line, '\n', static_cast<size_t>( end - line ) );
+  return found ? static_cast<const char *>( found ) : end;
+}
+
+//! Splits the file content to chunks of whole lines for parallel parsing
+static std::vector<Chunk2dm> _splitToChunks( const char *begin, const char *end )
+{
+  const size_t minChunkSize = 1 << 20;
+  const size_t size = static_cast<size_t>( end - begin );
+  const size_t chunksCount = std::max<size_t>( 1, std::min( MDAL::threadCount(), size / minChunkSize ) );
+
+  std::vector<Chunk2dm> chunks;
+  const char *chunkBegin = begin;
+  for ( size_t i = 1; i <= chunksCount && chunkBegin < end; ++i )
   {
-    if ( startsWith( line, "E4Q" ) ||
-         startsWith( line, "E3T" ) ||
-         startsWith( line, "E6T" ) )
+    const char *chunkEnd = end;
+    if ( i < chunksCount )
     {
-      faceCount++;
+      chunkEnd = _lineEnd( std::max( chunkBegin, begin + i * ( size / chunksCount ) ), end );
+      if ( chunkEnd < end )
+        ++chunkEnd; // include the new line character
     }
-    else if ( startsWith( line, "ND" ) )
+    Chunk2dm chunk;
+    chunk.begin = chunkBegin;
+    chunk.end = chunkEnd;
+    chunks.push_back( chunk );
+    chunkBegin = chunkEnd;
+  }
+  return chunks;
+}
+
+static void _countElements( Chunk2dm &chunk )
+{
+  std::vector<MDAL::StringView> tokens;
+  for ( const char *line = chunk.begin; line < chunk.end; )
+  {
+    const char *lineEnd = _lineEnd( line, chunk.end );
+
+    if ( _isFaceLine( line, lineEnd ) )
     {
-      vertexCount++;
+      chunk.faceCount++;
     }
-    else if ( startsWith( line, "E2L" ) )
+    else if ( _startsWith( line, lineEnd, "ND" ) )
     {
-      edgesCount++;
+      chunk.vertexCount++;
     }
-    else if ( startsWith( line, "E3L" ) ||
-              startsWith( line, "E8Q" ) ||
-              startsWith( line, "E9Q" ) )
+    else if ( _startsWith( line, lineEnd, "E2L" ) )
     {
-      MDAL::Log::warning( MDAL_Status::Err_UnsupportedElement, name(),  "found unsupported element" );
-      return nullptr;
+      chunk.edgeCount++;
+    }
+    else if ( _startsWith( line, lineEnd, "E3L" ) ||
+              _startsWith( line, lineEnd, "E8Q" ) ||
+              _startsWith( line, lineEnd, "E9Q" ) )
+    {
+      chunk.hasUnsupportedElement = true;
+      return;
     }
     // If specified, update the number of materials of the mesh
-    else if ( startsWith( line, "NUM_MATERIALS_PER_ELEM" ) )
+    else if ( _startsWith( line, lineEnd, "NUM_MATERIALS_PER_ELEM" ) )
     {
-      hasMaterialsDefinitionsForElements = true;
-      materialCount = MDAL::toSizeT( split( line, ' ' )[1] );
+      MDAL::split( line, lineEnd, ' ', tokens );
+      chunk.hasMaterialCount = true;
+      chunk.materialCount = tokens.size() > 1 ? MDAL::toSizeT( tokens[1].first, tokens[1].second ) : 0;
     }
-  }
-
-  // Allocate memory
-  Vertices vertices( vertexCount );
-  Edges edges( edgesCount );
-  Faces faces( faceCount );
-  size_t maxVerticesPerFace = 2;
-
-  // .2dm mesh files may have any number of material ID columns
-  std::vector<std::vector<double>> faceMaterials;
-
-  in.clear();
-  in.seekg( 0, std::ios::beg );
 
-  std::vector<std::string> chunks;
+    line = lineEnd + 1;
+  }
+}
 
-  size_t faceIndex = 0;
-  size_t vertexIndex = 0;
-  size_t edgeIndex = 0;
-  std::map<size_t, size_t> vertexIDtoIndex;
-  size_t lastVertexID = 0;
+static void _parseElements( Chunk2dm &chunk,
+                            bool hasMaterialsDefinitionsForElements,
+                            MDAL::Vertices &vertices,
+                            std::vector<size_t> &vertexIds,
+                            MDAL::Faces &faces,
+                            std::vector<size_t> &faceIds,
+                            MDAL::Edges &edges,
+                            std::vector<size_t> &edgeIds,
+                            std::vector<std::vector<double>> &faceMaterials )
+{
+  std::vector<MDAL::StringView> chunks;
+  size_t faceIndex = chunk.firstFaceIndex;
+  size_t vertexIndex = chunk.firstVertexIndex;
+  size_t edgeIndex = chunk.firstEdgeIndex;
+  const size_t materialCount = faceMaterials.size();
 
-  while ( std::getline( in, line ) )
+  for ( const char *line = chunk.begin; line < chunk.end; )
   {
-    if ( startsWith( line, "E4Q" ) ||
-         startsWith( line, "E3T" ) ||
-         startsWith( line, "E6T" )
-       )
+    const char *lineEnd = _lineEnd( line, chunk.end );
+
+    if ( _isFaceLine( line, lineEnd ) )
     {
-      chunks = split( line,  ' ' );
-      assert( faceIndex < faceCount );
+      MDAL::split( line, lineEnd, ' ', chunks );
 
-      const size_t faceVertexCount = MDAL::toSizeT( line[1] );
-      assert( ( faceVertexCount == 3 ) || ( faceVertexCount == 4 ) || ( faceVertexCount == 6 ) );
-      if ( maxVerticesPerFace < faceVertexCount )
-        maxVerticesPerFace = faceVertexCount;
-
-      Face &face = faces[faceIndex];
-      face.resize( faceVertexCount );
+      const size_t faceVertexCount = static_cast<size_t>( line[1] - '0' );
+      if ( chunk.maxVerticesPerFace < faceVertexCount )
+        chunk.maxVerticesPerFace = faceVertexCount;
 
       // chunks format here
       // E** id vertex_id1, vertex_id2, vertex_id3, ..., material_id [, aux_column_1, aux_column_2, ...]
       // vertex ids are numbered from 1
       // Right now we just store node IDs here - we will convert them to node indices afterwards
-      assert( chunks.size() > faceVertexCount + 1 );
+      if ( chunks.size() <= faceVertexCount + 1 ||
+           ( hasMaterialsDefinitionsForElements && chunks.size() < faceVertexCount + 2 + materialCount ) )
+      {
+        chunk.hasInvalidLine = true;
+        return;
+      }
 
-      // in case we have gaps/reorders in native indexes, store it
-      size_t nativeID = MDAL::toSizeT( chunks[1] );
-      _persist_native_index( nativeFaceIds, nativeID, faceIndex, faceCount );
+      faceIds[faceIndex] = MDAL::toSizeT( chunks[1].first, chunks[1].second );
 
+      MDAL::Face &face = faces[faceIndex];
+      face.resize( faceVertexCount );
       for ( size_t i = 0; i < faceVertexCount; ++i )
-        face[i] = MDAL::toSizeT( chunks[i + 2] ) - 1; // 2dm is numbered from 1
+        face[i] = MDAL::toSizeT( chunks[i + 2].first, chunks[i + 2].second ) - 1; // 2dm is numbered from 1
 
       // NUM_MATERIALS_PER_ELEM tag provided, use new MATID parser
       if ( hasMaterialsDefinitionsForElements )
       {
-        // This assertion will fail if a mesh has fewer material ID columns than
-        // promised by the NUM_MATERIAL_PER_ELEM tag.
-        assert( chunks.size() - 5 >= materialCount );
-
-        if ( faceMaterials.empty() ) // Initialize dataset if still empty
-        {
-          faceMaterials = std::vector<std::vector<double>>( materialCount, std::vector<double>(
-                            faceCount, std::numeric_limits<double>::quiet_NaN() ) );
-        }
-
         // Add material ID values
         for ( size_t i = 0; i < materialCount; ++i )
         {
           // Offset of 2 for E** tag and element ID
-          faceMaterials[i][faceIndex] = MDAL::toDouble( chunks[ faceVertexCount + 2 + i] );
+          const MDAL::StringView &token = chunks[ faceVertexCount + 2 + i];
+          faceMaterials[i][faceIndex] = MDAL::toDouble( token.first, token.second );
         }
       }
 
       // No NUM_MATERIALS_PER_ELEM tag provided, use legacy MATID parser
       else if ( chunks.size() == faceVertexCount + 4 )
       {
-        if ( faceMaterials.empty() ) // Initialize dataset if still empty
-        {
-          // Add a single vector dataset for the "Bed Elevation (Face)" dataset
-          faceMaterials = std::vector<std::vector<double>>( 1, std::vector<double>(
-                            faceCount, std::numeric_limits<double>::quiet_NaN() ) );
-        }
-
-        faceMaterials[0][faceIndex] = MDAL::toDouble( chunks[ faceVertexCount + 3 ] );
+        const MDAL::StringView &token = chunks[ faceVertexCount + 3 ];
+        faceMaterials[0][faceIndex] = MDAL::toDouble( token.first, token.second );
+        chunk.hasLegacyMaterial = true;
       }
 
       faceIndex++;
     }
-    else if ( startsWith( line, "E2L" ) )
+    else if ( _startsWith( line, lineEnd, "E2L" ) )
     {
       // format: E2L id n1 n2 matid
-      chunks = split( line,  ' ' );
-      assert( edgeIndex < edgesCount );
-      assert( chunks.size() > 4 );
-      // in case we have gaps/reorders in native indexes, store it
-      size_t nativeID = MDAL::toSizeT( chunks[1] );
-      _persist_native_index( nativeEdgeIds, nativeID, edgeIndex, edgesCount );
-
-      size_t startVertexIndex = MDAL::toSizeT( chunks[2] ) - 1; // 2dm is numbered from 1
-      size_t endVertexIndex = MDAL::toSizeT( chunks[3] ) - 1; // 2dm is numbered from 1
-      Edge &edge = edges[edgeIndex];
-      edge.startVertex = startVertexIndex;
-      edge.endVertex = endVertexIndex;
+      MDAL::split( line, lineEnd, ' ', chunks );
+      if ( chunks.size() < 4 )
+      {
+        chunk.hasInvalidLine = true;
+        return;
+      }
+
+      edgeIds[edgeIndex] = MDAL::toSizeT( chunks[1].first, chunks[1].second );
+      MDAL::Edge &edge = edges[edgeIndex];
+      edge.startVertex = MDAL::toSizeT( chunks[2].first, chunks[2].second ) - 1; // 2dm is numbered from 1
+      edge.endVertex = MDAL::toSizeT( chunks[3].first, chunks[3].second ) - 1; // 2dm is numbered from 1
       edgeIndex++;
     }
-    else if ( startsWith( line, "ND" ) )
+    else if ( _startsWith( line, lineEnd, "ND" ) )
     {
-      chunks = split( line,  ' ' );
-      size_t nodeID = toSizeT( chunks[1] );
-
-      if ( nodeID != 0 )
+      MDAL::split( line, lineEnd, ' ', chunks );
+      if ( chunks.size() < 5 )
       {
-        // specification of 2DM states that ID should be positive integer numbered from 1
-        // but it seems some formats do not respect that
-        if ( ( lastVertexID != 0 ) && ( nodeID <= lastVertexID ) )
-        {
-          // the algorithm requires that the file has NDs orderer by index
-          MDAL::Log::error( MDAL_Status::Err_InvalidData, name(), "nodes are not ordered by index" );
-          return nullptr;
-        }
-        lastVertexID = nodeID;
+        chunk.hasInvalidLine = true;
+        return;
       }
 
-      // in case we have gaps/reorders in native indexes, store it
-      _persist_native_index( nativeVertexIds, nodeID, vertexIndex, vertexCount );
-      _parse_vertex_id_gaps( vertexIDtoIndex, vertexIndex, nodeID - 1 );
-
-      assert( vertexIndex < vertexCount );
-      Vertex &vertex = vertices[vertexIndex];
-      vertex.x = toDouble( chunks[2] );
-      vertex.y = toDouble( chunks[3] );
-      vertex.z = toDouble( chunks[4] );
+      vertexIds[vertexIndex] = MDAL::toSizeT( chunks[1].first, chunks[1].second );
+      MDAL::Vertex &vertex = vertices[vertexIndex];
+      vertex.x = MDAL::toDouble( chunks[2].first, chunks[2].second );
+      vertex.y = MDAL::toDouble( chunks[3].first, chunks[3].second );
+      vertex.z = MDAL::toDouble( chunks[4].first, chunks[4].second );
       vertexIndex++;
     }
+
+    line = lineEnd + 1;
+  }
+}
+
+std::unique_ptr<MDAL::Mesh> MDAL::Driver2dm::load( const std::string &meshFile, const std::string & )
+{
+  mMeshFile = meshFile;
+
+  MDAL::Log::resetLastStatus();
+
+  // the file is parsed in place, without copying lines to strings
+  MDAL::MemoryMappedFile file( meshFile );
+  const char *headerEnd = file.isValid() ? _lineEnd( file.data(), file.end() ) : nullptr;
+  if ( !file.isValid() || file.size() == 0 || !_startsWith( file.data(), headerEnd, "MESH2D" ) )
+  {
+    MDAL::Log::error( MDAL_Status::Err_UnknownFormat, name(), meshFile + " could not be opened" );
+    return nullptr;
+  }
+
+  std::vector<Chunk2dm> fileChunks = _splitToChunks( std::min( headerEnd + 1, file.end() ), file.end() );
+
+  // Find out how many nodes and elements are contained in the .2dm mesh file
+  MDAL::parallelFor( fileChunks.size(), 1, [&fileChunks]( size_t begin, size_t end )
+  {
+    for ( size_t i = begin; i < end; ++i )
+      _countElements( fileChunks[i] );
+  } );
+
+  size_t faceCount = 0;
+  size_t vertexCount = 0;
+  size_t edgesCount = 0;
+  size_t materialCount = 0;
+  bool hasMaterialsDefinitionsForElements = false;
+
+  for ( Chunk2dm &chunk : fileChunks )
+  {
+    if ( chunk.hasUnsupportedElement )
+    {
+      MDAL::Log::warning( MDAL_Status::Err_UnsupportedElement, name(),  "found unsupported element" );
+      return nullptr;
+    }
+
+    if ( chunk.hasMaterialCount )
+    {
+      hasMaterialsDefinitionsForElements = true;
+      materialCount = chunk.materialCount;
+    }
+
+    chunk.firstFaceIndex = faceCount;
+    chunk.firstVertexIndex = vertexCount;
+    chunk.firstEdgeIndex = edgesCount;
+    faceCount += chunk.faceCount;
+    vertexCount += chunk.vertexCount;
+    edgesCount += chunk.edgeCount;
+  }
+
+  // Allocate memory
+  Vertices vertices( vertexCount );
+  Edges edges( edgesCount );
+  Faces faces( faceCount );
+  std::vector<size_t> vertexIds( vertexCount );
+  std::vector<size_t> faceIds( faceCount );
+  std::vector<size_t> edgeIds( edgesCount );
+
+  // .2dm mesh files may have any number of material ID columns
+  // without NUM_MATERIALS_PER_ELEM tag, a single "Bed Elevation (Face)" column may be present
+  std::vector<std::vector<double>> faceMaterials( hasMaterialsDefinitionsForElements ? materialCount : 1,
+      std::vector<double>( faceCount, std::numeric_limits<double>::quiet_NaN() ) );
+
+  MDAL::parallelFor( fileChunks.size(), 1, [&]( size_t begin, size_t end )
+  {
+    for ( size_t i = begin; i < end; ++i )
+      _parseElements( fileChunks[i], hasMaterialsDefinitionsForElements, vertices, vertexIds, faces, faceIds, edges, edgeIds, faceMaterials );
+  } );
+
+  size_t maxVerticesPerFace = 2;
+  bool hasLegacyMaterial = false;
+  for ( const Chunk2dm &chunk : fileChunks )
+  {
+    if ( chunk.hasInvalidLine )
+    {
+      MDAL::Log::error( MDAL_Status::Err_InvalidData, name(), "element definition with missing values" );
+      return nullptr;
+    }
+    maxVerticesPerFace = std::max( maxVerticesPerFace, chunk.maxVerticesPerFace );
+    hasLegacyMaterial |= chunk.hasLegacyMaterial;
   }
 
+  if ( !hasMaterialsDefinitionsForElements && !hasLegacyMaterial )
+    faceMaterials.clear();
+
+  std::vector<double> nativeVertexIds;
+  std::vector<double> nativeFaceIds;
+  std::vector<double> nativeEdgeIds;
+  std::map<size_t, size_t> vertexIDtoIndex;
+  size_t lastVertexID = 0;
+
+  for ( size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex )
+  {
+    size_t nodeID = vertexIds[vertexIndex];
+
+    if ( nodeID != 0 )
+    {
+      // specification of 2DM states that ID should be positive integer numbered from 1
+      // but it seems some formats do not respect that
+      if ( ( lastVertexID != 0 ) && ( nodeID <= lastVertexID ) )
+      {
+        // the algorithm requires that the file has NDs orderer by index
+        MDAL::Log::error( MDAL_Status::Err_InvalidData, name(), "nodes are not ordered by index" );
+        return nullptr;
+      }
+      lastVertexID = nodeID;
+    }
+
+    // in case we have gaps/reorders in native indexes, store it
+    _persist_native_index( nativeVertexIds, nodeID, vertexIndex, vertexCount );
+    _parse_vertex_id_gaps( vertexIDtoIndex, vertexIndex, nodeID - 1 );
+  }
+
+  for ( size_t faceIndex = 0; faceIndex < faceCount; ++faceIndex )
+    _persist_native_index( nativeFaceIds, faceIds[faceIndex], faceIndex, faceCount );
+
+  for ( size_t edgeIndex = 0; edgeIndex < edgesCount; ++edgeIndex )
+    _persist_native_index( nativeEdgeIds, edgeIds[edgeIndex], edgeIndex, edgesCount );
+
   for ( std::vector<Face>::iterator it = faces.begin(); it != faces.end(); ++it )
   {
     Face &face = *it;
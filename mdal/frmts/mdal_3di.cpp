@@ -270,9 +270,9 @@ void MDAL::Driver3Di::addBedElevation( MemoryMesh *mesh )
     }
   }
 
-  dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+  MDAL::updateStatistics( dataset );
   group->datasets.push_back( dataset );
-  group->setStatistics( MDAL::calculateStatistics( group ) );
+  MDAL::updateStatistics( group );
   mesh->datasetGroups.emplace_back( std::move( group ) );
 }
 
@@ -303,7 +303,7 @@ std::shared_ptr<MDAL::Dataset> MDAL::Driver3Di::create2DDataset( std::shared_ptr
         mNcFile,
         mRequestedMeshFaceIds
       );
-  dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+  MDAL::updateStatistics( dataset );
   return std::move( dataset );
 }
 
@@ -566,6 +566,22 @@ MDAL::CF3DiDataset2D::CF3DiDataset2D( MDAL::DatasetGroup *parent,
 
 MDAL::CF3DiDataset2D::~CF3DiDataset2D() = default;
 
+bool MDAL::CF3DiDataset2D::timeSeriesData( const size_t *elementIndexes, size_t elementCount, size_t datasetCount, double *buffer )
+{
+  if ( mRequestedMeshFaceIds.empty() )
+    return CFDataset2D::timeSeriesData( elementIndexes, elementCount, datasetCount, buffer );
+
+  // map the faces of the sub-mesh to the indexes in the file
+  std::vector<size_t> fileIndexes( elementCount );
+  for ( size_t e = 0; e < elementCount; ++e )
+  {
+    if ( elementIndexes[e] >= mRequestedMeshFaceIds.size() )
+      return false;
+    fileIndexes[e] = mRequestedMeshFaceIds[ elementIndexes[e] ];
+  }
+  return CFDataset2D::timeSeriesData( fileIndexes.data(), elementCount, datasetCount, buffer );
+}
+
 size_t MDAL::CF3DiDataset2D::scalarData( size_t indexStart, size_t count, double *buffer )
 {
   // Use the basic CF implementation if we don't have sub-mesh face ids
@@ -586,15 +602,16 @@ size_t MDAL::CF3DiDataset2D::scalarData( size_t indexStart, size_t count, double
   // This is the amound of data we need to fetch from the file.
   // It may be larger than count, since we might also fetch values that are not in mRequestedMeshFaceIds
   const size_t copyValues = requestEnd - requestStart + 1;
-  std::vector<double> values_x;
+  std::vector<double> values_x( copyValues );
 
   if ( mTimeLocation == CFDatasetGroupInfo::NoTimeDimension )
   {
-    values_x = mNcFile->readDoubleArr(
-                 mNcidX,
-                 requestStart,
-                 copyValues
-               );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      requestStart,
+      copyValues,
+      values_x.data()
+    );
   }
   else
   {
@@ -604,13 +621,14 @@ size_t MDAL::CF3DiDataset2D::scalarData( size_t indexStart, size_t count, double
     const size_t count_dim1 = timeFirstDim ?  1 : copyValues;
     const size_t count_dim2 = timeFirstDim ?  copyValues : 1;
 
-    values_x = mNcFile->readDoubleArr(
-                 mNcidX,
-                 start_dim1,
-                 start_dim2,
-                 count_dim1,
-                 count_dim2
-               );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      start_dim1,
+      start_dim2,
+      count_dim1,
+      count_dim2,
+      values_x.data()
+    );
   }
 
   for ( size_t i = 0; i < dataCount; ++i )
@@ -646,22 +664,24 @@ size_t MDAL::CF3DiDataset2D::vectorData( size_t indexStart, size_t count, double
   // This is the amound of data we need to fetch from the file.
   // It may be larger than count, since we might also fetch values that are not in mRequestedMeshFaceIds
   const size_t copyValues = requestEnd - requestStart + 1;
-  std::vector<double> values_x;
-  std::vector<double> values_y;
+  std::vector<double> values_x( copyValues );
+  std::vector<double> values_y( copyValues );
 
   if ( mTimeLocation == CFDatasetGroupInfo::NoTimeDimension )
   {
-    values_x = mNcFile->readDoubleArr(
-                 mNcidX,
-                 requestStart,
-                 copyValues
-               );
-
-    values_y = mNcFile->readDoubleArr(
-                 mNcidX,
-                 requestStart,
-                 copyValues
-               );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      requestStart,
+      copyValues,
+      values_x.data()
+    );
+
+    mNcFile->readDoubleArr(
+      mNcidX,
+      requestStart,
+      copyValues,
+      values_y.data()
+    );
   }
   else
   {
@@ -671,20 +691,22 @@ size_t MDAL::CF3DiDataset2D::vectorData( size_t indexStart, size_t count, double
     const size_t count_dim1 = timeFirstDim ?  1 : copyValues;
     const size_t count_dim2 = timeFirstDim ?  copyValues : 1;
 
-    values_x = mNcFile->readDoubleArr(
-                 mNcidX,
-                 start_dim1,
-                 start_dim2,
-                 count_dim1,
-                 count_dim2
-               );
-    values_y = mNcFile->readDoubleArr(
-                 mNcidY,
-                 start_dim1,
-                 start_dim2,
-                 count_dim1,
-                 count_dim2
-               );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      start_dim1,
+      start_dim2,
+      count_dim1,
+      count_dim2,
+      values_x.data()
+    );
+    mNcFile->readDoubleArr(
+      mNcidY,
+      start_dim1,
+      start_dim2,
+      count_dim1,
+      count_dim2,
+      values_y.data()
+    );
   }
 
   //if values component are classified convert from index to value
@@ -38,6 +38,8 @@ namespace MDAL
       virtual size_t scalarData( size_t indexStart, size_t count, double *buffer ) override;
       virtual size_t vectorData( size_t indexStart, size_t count, double *buffer ) override;
 
+      bool timeSeriesData( const size_t *elementIndexes, size_t elementCount, size_t datasetCount, double *buffer ) override;
+
     private:
       std::vector< size_t > mRequestedMeshFaceIds;
   };
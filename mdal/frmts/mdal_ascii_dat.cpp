@@ -14,17 +14,60 @@
 #include <cassert>
 #include <memory>
 #include <limits>
+#include <string.h>
 
 #include "mdal_ascii_dat.hpp"
 #include "mdal_utils.hpp"
 #include "mdal_2dm.hpp"
 #include "mdal.h"
 #include "mdal_logger.hpp"
+#include "mdal_memory_mapped_file.hpp"
 
 #include <math.h>
 
+//! Number of decoded timesteps kept in memory in indexed mode
+static const size_t CACHED_TIMESTEPS = 4;
+
+//! Non-zero when files are loaded in indexed mode
+static MDAL::Setting sIndexedMode( "MDAL_ASCII_DAT_INDEXED", 1, 0 );
+
 #define EXIT_WITH_ERROR(error, mssg)       {  MDAL::Log::errorf( error, "ASCII_DAT", mssg); return; }
 
+//! Same as std::getline for the buffer, reads the line starting at \a pos and moves \a pos to the next line
+static bool _getLine( const char *&pos, const char *end, const char *&lineBegin, const char *&lineEnd )
+{
+  if ( pos >= end )
+    return false;
+
+  lineBegin = pos;
+  const void *found = memchr( pos, '\n', static_cast<size_t>( end - pos ) );
+  lineEnd = found ? static_cast<const char *>( found ) : end;
+  pos = found ? lineEnd + 1 : end;
+  return true;
+}
+
+static bool _getLine( const char *&pos, const char *end, std::string &line )
+{
+  const char *lineBegin = nullptr;
+  const char *lineEnd = nullptr;
+  if ( !_getLine( pos, end, lineBegin, lineEnd ) )
+    return false;
+
+  line.assign( lineBegin, lineEnd );
+  return true;
+}
+
+//! Returns position behind \a count lines starting at \a pos
+static const char *_skipLines( const char *pos, const char *end, size_t count )
+{
+  for ( size_t i = 0; i < count && pos < end; ++i )
+  {
+    const void *found = memchr( pos, '\n', static_cast<size_t>( end - pos ) );
+    pos = found ? static_cast<const char *>( found ) + 1 : end;
+  }
+  return pos;
+}
+
 MDAL::DriverAsciiDat::DriverAsciiDat( ):
   Driver( "ASCII_DAT",
           "DAT",
@@ -69,13 +112,17 @@ bool MDAL::DriverAsciiDat::canReadNewFormat( const std::string &line ) const
 }
 
 
-void MDAL::DriverAsciiDat::loadOldFormat( std::ifstream &in,
+void MDAL::DriverAsciiDat::loadOldFormat( std::shared_ptr<AsciiDatFile> file,
+    const char *begin,
     Mesh *mesh ) const
 {
   std::shared_ptr<DatasetGroup> group; // DAT outputs data
   std::string groupName( MDAL::baseName( mDatFile ) );
+  std::vector<PendingTimestep> timesteps;
+  const char *pos = begin;
+  const char *end = file->file().end();
   std::string line;
-  std::getline( in, line );
+  _getLine( pos, end, line );
 
 // Read the first line
   bool isVector = MDAL::contains( line, "VECTOR" );
@@ -125,7 +172,7 @@ void MDAL::DriverAsciiDat::loadOldFormat( std::ifstream &in,
     {
       double rawTime = toDouble( items[ 1 ] );
       MDAL::RelativeTimestamp t( rawTime, timeUnits );
-      readVertexTimestep( mesh, group, t, isVector, false, in );
+      readVertexTimestep( mesh, group, t, isVector, false, file, pos, timesteps );
     }
     else
     {
@@ -134,7 +181,7 @@ void MDAL::DriverAsciiDat::loadOldFormat( std::ifstream &in,
       MDAL::Log::debug( str.str() );
     }
   }
-  while ( std::getline( in, line ) );
+  while ( _getLine( pos, end, line ) );
 
   if ( group->datasets.size() == 0 )
   {
@@ -142,19 +189,24 @@ void MDAL::DriverAsciiDat::loadOldFormat( std::ifstream &in,
     return;
   }
 
-  group->setStatistics( MDAL::calculateStatistics( group ) );
+  parseTimesteps( file.get(), mesh, timesteps );
+  MDAL::updateStatistics( group );
   mesh->datasetGroups.push_back( group );
   group.reset();
 }
 
 void MDAL::DriverAsciiDat::loadNewFormat(
-  std::ifstream &in,
+  std::shared_ptr<AsciiDatFile> file,
+  const char *begin,
   Mesh *mesh ) const
 {
   bool isVector = false;
   MDAL_DataLocation dataLocation = MDAL_DataLocation::DataOnVertices;
   std::shared_ptr<DatasetGroup> group; // DAT outputs data
   std::string groupName( MDAL::baseName( mDatFile ) );
+  std::vector<PendingTimestep> timesteps;
+  const char *pos = begin;
+  const char *end = file->file().end();
   std::string line;
   MDAL::DateTime referenceTime;
   // see if it contains face-centered results - supported by BASEMENT
@@ -174,7 +226,7 @@ void MDAL::DriverAsciiDat::loadNewFormat(
       dataLocation = MDAL_DataLocation::DataOnEdges;
   }
 
-  while ( std::getline( in, line ) )
+  while ( _getLine( pos, end, line ) )
   {
     // Replace tabs by spaces,
     // since basement v.2.8 uses tabs instead of spaces (e.g. 'TS 0\t0.0')
@@ -244,7 +296,8 @@ void MDAL::DriverAsciiDat::loadNewFormat(
         MDAL::Log::error( MDAL_Status::Err_UnknownFormat, name(), "ENDDS card for no active dataset!" );
         return;
       }
-      group->setStatistics( MDAL::calculateStatistics( group ) );
+      parseTimesteps( file.get(), mesh, timesteps );
+      MDAL::updateStatistics( group );
       mesh->datasetGroups.push_back( group );
       group.reset();
     }
@@ -288,12 +341,12 @@ void MDAL::DriverAsciiDat::loadNewFormat(
 
       if ( dataLocation != MDAL_DataLocation::DataOnVertices )
       {
-        readElementTimestep( mesh, group, t, isVector, in );
+        readElementTimestep( mesh, group, t, isVector, file, pos, timesteps );
       }
       else
       {
         bool hasStatus = ( toBool( items[1] ) );
-        readVertexTimestep( mesh, group, t, isVector, hasStatus, in );
+        readVertexTimestep( mesh, group, t, isVector, hasStatus, file, pos, timesteps );
       }
 
     }
@@ -341,9 +394,13 @@ void MDAL::DriverAsciiDat::load( const std::string &datFile, MDAL::Mesh *mesh )
     return;
   }
 
-  std::ifstream in = MDAL::openInputFile( mDatFile );
+  mIndexed = isIndexedMode();
+
+  // timestep values are parsed in place from the mapped file
+  std::shared_ptr<AsciiDatFile> file = std::make_shared<AsciiDatFile>( mDatFile );
+  const char *pos = file->file().data();
   std::string line;
-  if ( !std::getline( in, line ) )
+  if ( !file->file().isValid() || !_getLine( pos, file->file().end(), line ) )
   {
     MDAL::Log::error( MDAL_Status::Err_UnknownFormat, name(), "could not read file " +  mDatFile );
     return;
@@ -352,15 +409,13 @@ void MDAL::DriverAsciiDat::load( const std::string &datFile, MDAL::Mesh *mesh )
   if ( canReadNewFormat( line ) )
   {
     // we do not need to parse first line again
-    loadNewFormat( in, mesh );
+    loadNewFormat( file, pos, mesh );
   }
   else
   {
     // we need to parse first line again to see
     // scalar/vector flag or timestep flag
-    in.clear();
-    in.seekg( 0 );
-    loadOldFormat( in, mesh );
+    loadOldFormat( file, file->file().data(), mesh );
   }
 }
 
@@ -370,112 +425,251 @@ void MDAL::DriverAsciiDat::readVertexTimestep(
   MDAL::RelativeTimestamp t,
   bool isVector,
   bool hasStatus,
-  std::ifstream &stream ) const
+  std::shared_ptr<AsciiDatFile> file,
+  const char *&pos,
+  std::vector<PendingTimestep> &timesteps ) const
 {
   assert( group );
-  size_t faceCount = mesh->facesCount();
-  size_t vertexCount = mesh->verticesCount();
 
-  std::shared_ptr<MDAL::MemoryDataset2D> dataset = std::make_shared< MDAL::MemoryDataset2D >( group.get(), hasStatus );
+  AsciiDatTimestep timestep;
+  timestep.begin = pos;
+  // only for new format
+  timestep.activeCount = hasStatus ? mesh->facesCount() : 0;
+  // these are native format indexes (IDs). For formats without gaps it equals vertex array index
+  timestep.valuesCount = maximumId( mesh ) + 1;
+  timestep.isOnVertices = true;
+  timestep.isVector = isVector;
+
+  pos = _skipLines( pos, file->file().end(), timestep.activeCount + timestep.valuesCount );
+
+  std::shared_ptr<Dataset> dataset = createDataset( group.get(), file, timestep, hasStatus );
   dataset->setTime( t );
+  group->datasets.push_back( dataset );
+  timesteps.push_back( PendingTimestep( dataset, timestep ) );
+}
 
-  // only for new format
-  for ( size_t i = 0; i < faceCount; ++i )
+void MDAL::DriverAsciiDat::readElementTimestep(
+  const MDAL::Mesh *mesh,
+  std::shared_ptr<DatasetGroup> group,
+  MDAL::RelativeTimestamp t,
+  bool isVector,
+  std::shared_ptr<AsciiDatFile> file,
+  const char *&pos,
+  std::vector<PendingTimestep> &timesteps ) const
+{
+  assert( group );
+
+  AsciiDatTimestep timestep;
+  timestep.begin = pos;
+  // element is either edge of face, mixed meshes are not supported
+  timestep.valuesCount = mesh->edgesCount() + mesh->facesCount();
+  timestep.isOnVertices = false;
+  timestep.isVector = isVector;
+
+  pos = _skipLines( pos, file->file().end(), timestep.valuesCount );
+
+  std::shared_ptr<Dataset> dataset = createDataset( group.get(), file, timestep, false );
+  dataset->setTime( t );
+  group->datasets.push_back( dataset );
+  timesteps.push_back( PendingTimestep( dataset, timestep ) );
+}
+
+std::shared_ptr<MDAL::Dataset> MDAL::DriverAsciiDat::createDataset( DatasetGroup *group,
+    std::shared_ptr<AsciiDatFile> file,
+    const AsciiDatTimestep &timestep,
+    bool hasStatus ) const
+{
+  if ( mIndexed )
+    return std::make_shared< MDAL::DatasetAsciiDat >( group, file, timestep );
+  else
+    return std::make_shared< MDAL::MemoryDataset2D >( group, hasStatus );
+}
+
+void MDAL::DriverAsciiDat::parseTimesteps( AsciiDatFile *file, const MDAL::Mesh *mesh, std::vector<PendingTimestep> &timesteps ) const
+{
+  if ( mIndexed )
   {
-    if ( hasStatus )
+    // values are not kept, only statistics need to be calculated
+    if ( MDAL::lazyStatistics() )
     {
-      std::string line;
-      std::getline( stream, line );
-      dataset->setActive( i, toBool( line ) );
+      for ( const PendingTimestep &timestep : timesteps )
+        MDAL::updateStatistics( timestep.first );
     }
+    else
+    {
+      std::vector<MDAL::Statistics> statistics( timesteps.size() );
+      MDAL::parallelFor( timesteps.size(), 1, [&]( size_t begin, size_t end )
+      {
+        for ( size_t i = begin; i < end; ++i )
+          statistics[i] = MDAL::calculateStatistics( timesteps[i].first.get() );
+      } );
+
+      for ( size_t i = 0; i < timesteps.size(); ++i )
+        timesteps[i].first->setStatistics( statistics[i] );
+    }
+    timesteps.clear();
+    return;
   }
 
-  const Mesh2dm *m2dm = dynamic_cast<const Mesh2dm *>( mesh );
-  size_t meshIdCount = maximumId( mesh ) + 1; // these are native format indexes (IDs). For formats without gaps it equals vertex array index
+  std::vector<size_t> invalidLines( timesteps.size(), 0 );
+  MDAL::parallelFor( timesteps.size(), 1, [&]( size_t begin, size_t end )
+  {
+    for ( size_t i = begin; i < end; ++i )
+    {
+      MDAL::MemoryDataset2D *dataset = static_cast<MDAL::MemoryDataset2D *>( timesteps[i].first.get() );
+      const AsciiDatTimestep &timestep = timesteps[i].second;
+      std::vector<int> active( timestep.activeCount, 1 );
+      invalidLines[i] = file->parseTimestep( mesh, timestep, dataset->values(), active.data() );
+      if ( timestep.activeCount > 0 )
+        dataset->setActive( active.data() );
+    }
+  } );
 
-  for ( size_t id = 0; id < meshIdCount; ++id )
+  for ( size_t i = 0; i < timesteps.size(); ++i )
   {
-    std::string line;
-    std::getline( stream, line );
-    std::vector<std::string> tsItems = split( line,  ' ' );
+    if ( invalidLines[i] > 0 )
+      MDAL::Log::debug( "invalid timestep line" );
 
-    size_t index;
+    MDAL::updateStatistics( timesteps[i].first );
+  }
+  timesteps.clear();
+}
+
+MDAL::AsciiDatFile::AsciiDatFile( const std::string &fileName )
+  : mFile( fileName )
+{
+}
+
+size_t MDAL::AsciiDatFile::parseTimestep( const MDAL::Mesh *mesh, const AsciiDatTimestep &timestep, double *values, int *active ) const
+{
+  const MDAL::Mesh2dm *m2dm = timestep.isOnVertices ? dynamic_cast<const MDAL::Mesh2dm *>( mesh ) : nullptr;
+  const size_t vertexCount = mesh->verticesCount();
+  const char *end = mFile.end();
+  const char *pos = timestep.begin;
+  const char *lineBegin = pos;
+  const char *lineEnd = pos;
+  size_t invalidLines = 0;
+
+  for ( size_t i = 0; i < timestep.activeCount; ++i )
+  {
+    if ( !_getLine( pos, end, lineBegin, lineEnd ) )
+      lineBegin = lineEnd = end;
+    active[i] = MDAL::toBool( lineBegin, lineEnd );
+  }
+
+  std::vector<MDAL::StringView> tsItems;
+  for ( size_t id = 0; id < timestep.valuesCount; ++id )
+  {
+    if ( !_getLine( pos, end, lineBegin, lineEnd ) )
+      lineBegin = lineEnd = end;
+
+    size_t index = id;
     if ( m2dm )
       index = m2dm->vertexIndex( id ); //this index may be out of values array
-    else
-      index = id;
 
-    if ( index >= vertexCount ) continue;
+    if ( timestep.isOnVertices && index >= vertexCount ) continue;
 
-    if ( isVector )
+    MDAL::split( lineBegin, lineEnd, ' ', tsItems );
+    if ( timestep.isVector )
     {
       if ( tsItems.size() >= 2 ) // BASEMENT files with vectors have 3 columns
       {
-        dataset->setVectorValue( index, toDouble( tsItems[0] ), toDouble( tsItems[1] ) );
+        values[2 * index] = MDAL::toDouble( tsItems[0].first, tsItems[0].second );
+        values[2 * index + 1] = MDAL::toDouble( tsItems[1].first, tsItems[1].second );
       }
       else
-      {
-        MDAL::Log::debug( "invalid timestep line" );
-      }
+        ++invalidLines;
     }
     else
     {
       if ( tsItems.size() >= 1 )
-        dataset->setScalarValue( index, toDouble( tsItems[0] ) );
+        values[index] = MDAL::toDouble( tsItems[0].first, tsItems[0].second );
       else
-      {
-        MDAL::Log::debug( "invalid timestep line" );
-      }
+        ++invalidLines;
     }
   }
 
-  dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
-  group->datasets.push_back( dataset );
+  return invalidLines;
 }
 
-void MDAL::DriverAsciiDat::readElementTimestep(
-  const MDAL::Mesh *mesh,
-  std::shared_ptr<DatasetGroup> group,
-  MDAL::RelativeTimestamp t,
-  bool isVector,
-  std::ifstream &stream ) const
+std::shared_ptr<const MDAL::AsciiDatFile::Values> MDAL::AsciiDatFile::timestepValues( const Dataset *dataset, const AsciiDatTimestep &timestep )
 {
-  assert( group );
-
-  // element is either edge of face, mixed meshes are not supported
-  size_t elementCount = mesh->edgesCount() + mesh->facesCount();
-  std::shared_ptr<MDAL::MemoryDataset2D> dataset = std::make_shared< MDAL::MemoryDataset2D >( group.get() );
-  dataset->setTime( t );
-  for ( size_t index = 0; index < elementCount; ++index )
   {
-    std::string line;
-    std::getline( stream, line );
-    std::vector<std::string> tsItems = split( line, ' ' );
-
-    if ( isVector )
+    std::lock_guard<std::mutex> lock( mCacheMutex );
+    for ( auto it = mCache.begin(); it != mCache.end(); ++it )
     {
-      if ( tsItems.size() >= 2 ) // BASEMENT files with vectors have 3 columns
+      if ( it->first == timestep.begin )
       {
-        dataset->setVectorValue( index, toDouble( tsItems[0] ), toDouble( tsItems[1] ) );
-      }
-      else
-      {
-        MDAL::Log::debug( "invalid timestep line" );
-      }
-    }
-    else
-    {
-      if ( tsItems.size() >= 1 )
-        dataset->setScalarValue( index, toDouble( tsItems[0] ) ) ;
-      else
-      {
-        MDAL::Log::debug( "invalid timestep line" );
+        mCache.splice( mCache.begin(), mCache, it );
+        return mCache.front().second;
       }
     }
   }
 
-  dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
-  group->datasets.push_back( dataset );
+  // parse without lock, other timesteps can be parsed in parallel
+  std::shared_ptr<Values> decoded = std::make_shared<Values>();
+  decoded->values.resize( ( timestep.isVector ? 2 : 1 ) * dataset->valuesCount(), std::numeric_limits<double>::quiet_NaN() );
+  decoded->active.resize( timestep.activeCount, 1 );
+  if ( parseTimestep( dataset->mesh(), timestep, decoded->values.data(), decoded->active.data() ) > 0 )
+    MDAL::Log::debug( "invalid timestep line" );
+
+  std::lock_guard<std::mutex> lock( mCacheMutex );
+  mCache.emplace_front( timestep.begin, decoded );
+  if ( mCache.size() > CACHED_TIMESTEPS )
+    mCache.pop_back();
+
+  return decoded;
+}
+
+MDAL::DatasetAsciiDat::DatasetAsciiDat( MDAL::DatasetGroup *parent,
+                                        std::shared_ptr<MDAL::AsciiDatFile> file,
+                                        const MDAL::AsciiDatTimestep &timestep )
+  : Dataset2D( parent )
+  , mFile( std::move( file ) )
+  , mTimestep( timestep )
+{
+  setSupportsActiveFlag( timestep.activeCount > 0 );
+}
+
+MDAL::DatasetAsciiDat::~DatasetAsciiDat() = default;
+
+size_t MDAL::DatasetAsciiDat::scalarData( size_t indexStart, size_t count, double *buffer )
+{
+  assert( group()->isScalar() ); //checked in C API interface
+  const size_t nValues = valuesCount();
+  if ( ( count < 1 ) || ( indexStart >= nValues ) )
+    return 0;
+
+  std::shared_ptr<const AsciiDatFile::Values> decoded = mFile->timestepValues( this, mTimestep );
+  const size_t copyValues = std::min( nValues - indexStart, count );
+  memcpy( buffer, decoded->values.data() + indexStart, copyValues * sizeof( double ) );
+  return copyValues;
+}
+
+size_t MDAL::DatasetAsciiDat::vectorData( size_t indexStart, size_t count, double *buffer )
+{
+  assert( !group()->isScalar() ); //checked in C API interface
+  const size_t nValues = valuesCount();
+  if ( ( count < 1 ) || ( indexStart >= nValues ) )
+    return 0;
+
+  std::shared_ptr<const AsciiDatFile::Values> decoded = mFile->timestepValues( this, mTimestep );
+  const size_t copyValues = std::min( nValues - indexStart, count );
+  memcpy( buffer, decoded->values.data() + 2 * indexStart, 2 * copyValues * sizeof( double ) );
+  return copyValues;
+}
+
+size_t MDAL::DatasetAsciiDat::activeData( size_t indexStart, size_t count, int *buffer )
+{
+  assert( supportsActiveFlag() );
+  const size_t nValues = mTimestep.activeCount;
+  if ( ( count < 1 ) || ( indexStart >= nValues ) )
+    return 0;
+
+  std::shared_ptr<const AsciiDatFile::Values> decoded = mFile->timestepValues( this, mTimestep );
+  const size_t copyValues = std::min( nValues - indexStart, count );
+  memcpy( buffer, decoded->active.data() + indexStart, copyValues * sizeof( int ) );
+  return copyValues;
 }
 
 bool MDAL::DriverAsciiDat::persist( MDAL::DatasetGroup *group )
@@ -574,3 +768,13 @@ std::string MDAL::DriverAsciiDat::writeDatasetOnFileSuffix() const
 {
   return "dat";
 }
+
+bool MDAL::DriverAsciiDat::isIndexedMode()
+{
+  return sIndexedMode.value() != 0;
+}
+
+void MDAL::DriverAsciiDat::setIndexedMode( bool indexed )
+{
+  sIndexedMode.setValue( indexed ? 1 : 0 );
+}
@@ -12,13 +12,86 @@
 #include <iosfwd>
 #include <iostream>
 #include <fstream>
+#include <list>
+#include <mutex>
 
 #include "mdal_data_model.hpp"
+#include "mdal_memory_data_model.hpp"
 #include "mdal.h"
 #include "mdal_driver.hpp"
+#include "mdal_memory_mapped_file.hpp"
 
 namespace MDAL
 {
+  //! Position and layout of the values of one timestep (TS card) in the file
+  struct AsciiDatTimestep
+  {
+    const char *begin = nullptr; //!< first line of the active flags or values
+    size_t activeCount = 0; //!< number of lines with active flags
+    size_t valuesCount = 0; //!< number of lines with values
+    bool isOnVertices = true;
+    bool isVector = false;
+  };
+
+  /**
+   * Mapped ASCII DAT file shared by the datasets read from it
+   *
+   * Keeps few recently decoded timesteps, so repeated requests
+   * of the same timestep (e.g. in chunks) parse the file only once
+   */
+  class AsciiDatFile
+  {
+    public:
+      //! Decoded values and active flags of a timestep
+      struct Values
+      {
+        std::vector<double> values;
+        std::vector<int> active;
+      };
+
+      explicit AsciiDatFile( const std::string &fileName );
+
+      const MemoryMappedFile &file() const { return mFile; }
+
+      /**
+       * Parses the active flags and values of the timestep to the buffers
+       * \param values buffer with one (scalar) or two (vector) values for each value of the dataset
+       * \param active buffer for timestep.activeCount flags, may be null when there are no flags
+       * \returns number of lines with missing values
+       */
+      size_t parseTimestep( const Mesh *mesh, const AsciiDatTimestep &timestep, double *values, int *active ) const;
+
+      //! Returns the decoded timestep from the cache, the timestep is parsed when it is not cached
+      std::shared_ptr<const Values> timestepValues( const Dataset *dataset, const AsciiDatTimestep &timestep );
+
+    private:
+      MemoryMappedFile mFile;
+
+      std::mutex mCacheMutex;
+      //! recently used timesteps, the most recent first
+      std::list<std::pair<const char *, std::shared_ptr<const Values>>> mCache;
+  };
+
+  /**
+   * Dataset of the indexed mode of ASCII DAT driver, see DriverAsciiDat.
+   * Values are parsed from the file on request
+   */
+  class DatasetAsciiDat: public Dataset2D
+  {
+    public:
+      DatasetAsciiDat( DatasetGroup *parent,
+                       std::shared_ptr<AsciiDatFile> file,
+                       const AsciiDatTimestep &timestep );
+      ~DatasetAsciiDat() override;
+
+      size_t scalarData( size_t indexStart, size_t count, double *buffer ) override;
+      size_t vectorData( size_t indexStart, size_t count, double *buffer ) override;
+      size_t activeData( size_t indexStart, size_t count, int *buffer ) override;
+
+    private:
+      std::shared_ptr<AsciiDatFile> mFile;
+      AsciiDatTimestep mTimestep;
+  };
 
   /**
    * ASCII Dat format is used by various solvers and the output
@@ -47,6 +120,11 @@ namespace MDAL
    * keyword. The older format does not have "active" flags for faces
    * and does not recognize most of the keywords. Old format data
    * are always defined on vertices
+   *
+   * By default, all values are read to memory. In indexed mode (see
+   * MDAL_SetAsciiDatIndexedMode()), only the positions of the timesteps
+   * are stored when the file is loaded and values are parsed when
+   * the dataset is read
    */
   class DriverAsciiDat: public Driver
   {
@@ -61,12 +139,19 @@ namespace MDAL
 
       std::string writeDatasetOnFileSuffix() const override;
 
+      //! Returns whether files are loaded in indexed mode, see MDAL_SetAsciiDatIndexedMode()
+      static bool isIndexedMode();
+      static void setIndexedMode( bool indexed );
+
     private:
       bool canReadOldFormat( const std::string &line ) const;
       bool canReadNewFormat( const std::string &line ) const;
 
-      void loadOldFormat( std::ifstream &in, Mesh *mesh ) const;
-      void loadNewFormat( std::ifstream &in, Mesh *mesh ) const;
+      //! Timestep dataset and position of its values, to be parsed when dataset group is complete
+      typedef std::pair<std::shared_ptr<Dataset>, AsciiDatTimestep> PendingTimestep;
+
+      void loadOldFormat( std::shared_ptr<AsciiDatFile> file, const char *begin, Mesh *mesh ) const;
+      void loadNewFormat( std::shared_ptr<AsciiDatFile> file, const char *begin, Mesh *mesh ) const;
 
       //! Gets maximum (native) index.
       //! For meshes without indexing gap it is vertexCount - 1
@@ -74,20 +159,39 @@ namespace MDAL
       //! maximum native index of the vertex in defined in the mesh
       size_t maximumId( const Mesh *mesh ) const;
 
+      //! Adds dataset for the timestep to the group and moves \a pos behind its lines
       void readVertexTimestep( const Mesh *mesh,
                                std::shared_ptr<DatasetGroup> group,
                                RelativeTimestamp t,
                                bool isVector,
                                bool hasStatus,
-                               std::ifstream &stream ) const;
+                               std::shared_ptr<AsciiDatFile> file,
+                               const char *&pos,
+                               std::vector<PendingTimestep> &timesteps ) const;
 
+      //! Adds dataset for the timestep to the group and moves \a pos behind its lines
       void readElementTimestep( const Mesh *mesh,
                                 std::shared_ptr<DatasetGroup> group,
                                 RelativeTimestamp t,
                                 bool isVector,
-                                std::ifstream &stream ) const;
+                                std::shared_ptr<AsciiDatFile> file,
+                                const char *&pos,
+                                std::vector<PendingTimestep> &timesteps ) const;
+
+      /**
+       * Parses values of all \a timesteps in parallel, calculates their statistics and clears the list
+       * In indexed mode, the values are only used for statistics
+       */
+      void parseTimesteps( AsciiDatFile *file, const Mesh *mesh, std::vector<PendingTimestep> &timesteps ) const;
+
+      //! Creates in-memory or indexed dataset for the timestep
+      std::shared_ptr<Dataset> createDataset( DatasetGroup *group,
+                                              std::shared_ptr<AsciiDatFile> file,
+                                              const AsciiDatTimestep &timestep,
+                                              bool hasStatus ) const;
 
       std::string mDatFile;
+      bool mIndexed = false;
   };
 
 } // namespace MDAL
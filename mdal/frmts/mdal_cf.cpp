@@ -15,6 +15,7 @@
 #include "mdal_cf.hpp"
 #include "mdal_utils.hpp"
 #include "mdal_logger.hpp"
+#include "mdal_block_cache.hpp"
 
 static std::pair<std::string, std::string> metadataFromClassification( const MDAL::Classification &classes )
 {
@@ -380,7 +381,7 @@ void MDAL::DriverCF::addDatasetGroups( MDAL::Mesh *mesh, const std::vector<Relat
     // Add to mesh
     if ( !group->datasets.empty() )
     {
-      group->setStatistics( MDAL::calculateStatistics( group ) );
+      MDAL::updateStatistics( group );
       group->setReferenceTime( referenceTime );
       mesh->datasetGroups.emplace_back( std::move( group ) );
     }
@@ -434,7 +435,7 @@ std::shared_ptr<MDAL::Dataset> MDAL::DriverCF::create2DDataset( std::shared_ptr<
         ts,
         mNcFile
       );
-  dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+  MDAL::updateStatistics( dataset );
   return std::move( dataset );
 }
 
@@ -685,21 +686,98 @@ MDAL::CFDataset2D::~CFDataset2D() = default;
 size_t MDAL::CFDataset2D::scalarData( size_t indexStart, size_t count, double *buffer )
 {
   assert( group()->isScalar() ); //checked in C API interface
+  return MDAL::BlockCache::read( this, mValues, 1, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readScalarData( start, n, values ); } );
+}
+
+size_t MDAL::CFDataset2D::vectorData( size_t indexStart, size_t count, double *buffer )
+{
+  assert( !group()->isScalar() ); //checked in C API interface
+  return MDAL::BlockCache::read( this, mValues, 2, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readVectorData( start, n, values ); } );
+}
+
+bool MDAL::CFDataset2D::timeSeriesData( const size_t *elementIndexes, size_t elementCount, size_t datasetCount, double *buffer )
+{
+  if ( mTimeLocation == CFDatasetGroupInfo::NoTimeDimension || mTs + datasetCount > mTimesteps )
+    return false;
+
+  const size_t index = indexInGroup();
+  const Datasets &datasets = group()->datasets;
+  if ( index + datasetCount > datasets.size() )
+    return false;
+
+  for ( size_t i = 1; i < datasetCount; ++i )
+  {
+    const CFDataset2D *dataset = dynamic_cast<const CFDataset2D *>( datasets[index + i].get() );
+    if ( !dataset || dataset->mNcidX != mNcidX || dataset->mNcidY != mNcidY || dataset->mTs != mTs + i )
+      return false;
+  }
+
+  // one strided read of the variable along the time dimension for each element
+  const bool timeFirstDim = mTimeLocation == CFDatasetGroupInfo::TimeDimensionFirst;
+  const size_t count_dim1 = timeFirstDim ?  datasetCount : 1;
+  const size_t count_dim2 = timeFirstDim ?  1 : datasetCount;
+  const bool isScalar = group()->isScalar();
+
+  for ( size_t e = 0; e < elementCount; ++e )
+  {
+    const size_t idx = elementIndexes[e];
+    if ( idx >= mValues )
+      return false;
+
+    const size_t start_dim1 = timeFirstDim ?  mTs : idx;
+    const size_t start_dim2 = timeFirstDim ?  idx : mTs;
+
+    if ( isScalar )
+    {
+      double *target = buffer + e * datasetCount;
+      mNcFile->readDoubleArr( mNcidX, start_dim1, start_dim2, count_dim1, count_dim2, target );
+      for ( size_t i = 0; i < datasetCount; ++i )
+        target[i] = MDAL::safeValue( target[i], mFillValX );
+      continue;
+    }
+
+    std::vector<double> values_x( datasetCount );
+    std::vector<double> values_y( datasetCount );
+    mNcFile->readDoubleArr( mNcidX, start_dim1, start_dim2, count_dim1, count_dim2, values_x.data() );
+    mNcFile->readDoubleArr( mNcidY, start_dim1, start_dim2, count_dim1, count_dim2, values_y.data() );
+
+    if ( !mClassificationX.empty() )
+      fromClassificationToValue( mClassificationX, values_x, 1 );
+    if ( !mClassificationY.empty() )
+      fromClassificationToValue( mClassificationY, values_y, 1 );
+
+    double *target = buffer + 2 * e * datasetCount;
+    for ( size_t i = 0; i < datasetCount; ++i )
+    {
+      if ( group()->isPolar() )
+        populate_polar_vector_vals( target, i, values_x, values_y, i, mFillValX, mFillValY, group()->referenceAngles() );
+      else
+        populate_vector_vals( target, i, values_x, values_y, i, mFillValX, mFillValY );
+    }
+  }
+  return true;
+}
+
+size_t MDAL::CFDataset2D::readScalarData( size_t indexStart, size_t count, double *buffer )
+{
   if ( ( count < 1 ) || ( indexStart >= mValues ) )
     return 0;
   if ( mTs >= mTimesteps )
     return 0;
 
   size_t copyValues = std::min( mValues - indexStart, count );
-  std::vector<double> values_x;
 
+  // values are read directly to the buffer
   if ( mTimeLocation == CFDatasetGroupInfo::NoTimeDimension )
   {
-    values_x = mNcFile->readDoubleArr(
-                 mNcidX,
-                 indexStart,
-                 copyValues
-               );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      indexStart,
+      copyValues,
+      buffer
+    );
   }
   else
   {
@@ -709,29 +787,24 @@ size_t MDAL::CFDataset2D::scalarData( size_t indexStart, size_t count, double *b
     size_t count_dim1 = timeFirstDim ?  1 : copyValues;
     size_t count_dim2 = timeFirstDim ?  copyValues : 1;
 
-    values_x = mNcFile->readDoubleArr(
-                 mNcidX,
-                 start_dim1,
-                 start_dim2,
-                 count_dim1,
-                 count_dim2
-               );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      start_dim1,
+      start_dim2,
+      count_dim1,
+      count_dim2,
+      buffer
+    );
   }
 
   for ( size_t i = 0; i < copyValues; ++i )
-  {
-    populate_scalar_vals( buffer,
-                          i,
-                          values_x,
-                          i,
-                          mFillValX );
-  }
+    buffer[i] = MDAL::safeValue( buffer[i], mFillValX );
+
   return copyValues;
 }
 
-size_t MDAL::CFDataset2D::vectorData( size_t indexStart, size_t count, double *buffer )
+size_t MDAL::CFDataset2D::readVectorData( size_t indexStart, size_t count, double *buffer )
 {
-  assert( !group()->isScalar() ); //checked in C API interface
   if ( ( count < 1 ) || ( indexStart >= mValues ) )
     return 0;
 
@@ -740,22 +813,24 @@ size_t MDAL::CFDataset2D::vectorData( size_t indexStart, size_t count, double *b
 
   size_t copyValues = std::min( mValues - indexStart, count );
 
-  std::vector<double> values_x;
-  std::vector<double> values_y;
+  std::vector<double> values_x( copyValues );
+  std::vector<double> values_y( copyValues );
 
   if ( mTimeLocation == CFDatasetGroupInfo::NoTimeDimension )
   {
-    values_x = mNcFile->readDoubleArr(
-                 mNcidX,
-                 indexStart,
-                 copyValues
-               );
-
-    values_y = mNcFile->readDoubleArr(
-                 mNcidX,
-                 indexStart,
-                 copyValues
-               );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      indexStart,
+      copyValues,
+      values_x.data()
+    );
+
+    mNcFile->readDoubleArr(
+      mNcidX,
+      indexStart,
+      copyValues,
+      values_y.data()
+    );
   }
   else
   {
@@ -765,20 +840,22 @@ size_t MDAL::CFDataset2D::vectorData( size_t indexStart, size_t count, double *b
     size_t count_dim1 = timeFirstDim ?  1 : copyValues;
     size_t count_dim2 = timeFirstDim ?  copyValues : 1;
 
-    values_x = mNcFile->readDoubleArr(
-                 mNcidX,
-                 start_dim1,
-                 start_dim2,
-                 count_dim1,
-                 count_dim2
-               );
-    values_y = mNcFile->readDoubleArr(
-                 mNcidY,
-                 start_dim1,
-                 start_dim2,
-                 count_dim1,
-                 count_dim2
-               );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      start_dim1,
+      start_dim2,
+      count_dim1,
+      count_dim2,
+      values_x.data()
+    );
+    mNcFile->readDoubleArr(
+      mNcidY,
+      start_dim1,
+      start_dim2,
+      count_dim1,
+      count_dim2,
+      values_y.data()
+    );
   }
 
   //if values component are classified convert from index to value
@@ -97,6 +97,8 @@ namespace MDAL
       virtual size_t scalarData( size_t indexStart, size_t count, double *buffer ) override;
       virtual size_t vectorData( size_t indexStart, size_t count, double *buffer ) override;
 
+      bool timeSeriesData( const size_t *elementIndexes, size_t elementCount, size_t datasetCount, double *buffer ) override;
+
       static void populate_vector_vals( double *vals, size_t i,
                                         const std::vector<double> &vals_x, const std::vector<double> &vals_y,
                                         size_t idx, double fill_val_x, double fill_val_y );
@@ -109,6 +111,10 @@ namespace MDAL
                                         double fill_val );
       static void fromClassificationToValue( const MDAL::Classification &classification, std::vector<double> &values, size_t classStartAt = 0 );
     protected:
+      //! Reads values from the file, see BlockCache
+      size_t readScalarData( size_t indexStart, size_t count, double *buffer );
+      size_t readVectorData( size_t indexStart, size_t count, double *buffer );
+
       double mFillValX;
       double mFillValY;
       int mNcidX; //!< NetCDF variable id
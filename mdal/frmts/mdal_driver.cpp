@@ -113,7 +113,7 @@ void MDAL::Driver::createDataset( MDAL::DatasetGroup *group, MDAL::RelativeTimes
   memcpy( dataset->values(), values, sizeof( double ) * count );
   if ( supportsActiveFlag && dataset->supportsActiveFlag() )
     dataset->setActive( active );
-  dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+  MDAL::updateStatistics( dataset );
   group->datasets.push_back( dataset );
 }
 
@@ -136,7 +136,7 @@ void MDAL::Driver::createDataset( MDAL::DatasetGroup *group, MDAL::RelativeTimes
 
   memcpy( dataset->values(), values, sizeof( double ) * count );
 
-  dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+  MDAL::updateStatistics( dataset );
   group->datasets.push_back( dataset );
 }
 
@@ -258,7 +258,7 @@ bool MDAL::MeshDynamicDriver::populateDatasetGroups()
           if ( !dataset2D->loadSymbol() )
             return false;
 
-          dataset2D->setStatistics( MDAL::calculateStatistics( dataset2D ) );
+          MDAL::updateStatistics( dataset2D );
           dataset2D->unloadData();
           dataset = dataset2D;
         }
@@ -273,7 +273,7 @@ bool MDAL::MeshDynamicDriver::populateDatasetGroups()
           if ( ! dataset3D->loadSymbol() )
             return false;
 
-          dataset3D->setStatistics( MDAL::calculateStatistics( dataset3D ) );
+          MDAL::updateStatistics( dataset3D );
           dataset3D->unloadData();
           dataset = dataset3D;
         }
@@ -289,7 +289,7 @@ bool MDAL::MeshDynamicDriver::populateDatasetGroups()
       group->datasets.emplace_back( std::move( dataset ) );
     }
 
-    group->setStatistics( MDAL::calculateStatistics( group ) );
+    MDAL::updateStatistics( group );
     datasetGroups.emplace_back( std::move( group ) );
   }
   return true;
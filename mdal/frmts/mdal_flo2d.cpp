@@ -14,6 +14,7 @@
 #include <string>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
 #include <assert.h>
 
 #include "mdal_utils.hpp"
@@ -79,9 +80,9 @@ void MDAL::DriverFlo2D::addStaticDataset(
   dataset->setTime( MDAL::RelativeTimestamp() );
   double *values = dataset->values();
   memcpy( values, vals.data(), vals.size() * sizeof( double ) );
-  dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+  MDAL::updateStatistics( dataset );
   group->datasets.push_back( dataset );
-  group->setStatistics( MDAL::calculateStatistics( group ) );
+  MDAL::updateStatistics( group );
   mMesh->datasetGroups.emplace_back( std::move( group ) );
 }
 
@@ -376,9 +377,9 @@ void MDAL::DriverFlo2D::parseHYCHANFile( const std::string &datFileName, const s
   for ( std::shared_ptr<DatasetGroup> datasetGroup : datasetGroups )
   {
     for ( std::shared_ptr<Dataset> dataset : datasetGroup->datasets )
-      dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+      MDAL::updateStatistics( dataset );
 
-    datasetGroup->setStatistics( MDAL::calculateStatistics( datasetGroup ) );
+    MDAL::updateStatistics( datasetGroup );
     mMesh->datasetGroups.emplace_back( std::move( datasetGroup ) );
   }
 }
@@ -531,7 +532,7 @@ static void addDatasetToGroup( std::shared_ptr<MDAL::DatasetGroup> group, std::s
 {
   if ( group && dataset && dataset->valuesCount() > 0 )
   {
-    dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+    MDAL::updateStatistics( dataset );
     group->datasets.push_back( dataset );
   }
 }
@@ -640,9 +641,9 @@ void MDAL::DriverFlo2D::parseTIMDEPFile( const std::string &datFileName, const s
   if ( flowDataset ) addDatasetToGroup( flowDsGroup, std::move( flowDataset ) );
   if ( waterLevelDataset ) addDatasetToGroup( waterLevelDsGroup, std::move( waterLevelDataset ) );
 
-  depthDsGroup->setStatistics( MDAL::calculateStatistics( depthDsGroup ) );
-  flowDsGroup->setStatistics( MDAL::calculateStatistics( flowDsGroup ) );
-  waterLevelDsGroup->setStatistics( MDAL::calculateStatistics( waterLevelDsGroup ) );
+  MDAL::updateStatistics( depthDsGroup );
+  MDAL::updateStatistics( flowDsGroup );
+  MDAL::updateStatistics( waterLevelDsGroup );
 
   mMesh->datasetGroups.emplace_back( std::move( depthDsGroup ) );
   mMesh->datasetGroups.emplace_back( std::move( flowDsGroup ) );
@@ -928,7 +929,13 @@ bool MDAL::DriverFlo2D::parseHDF5Datasets( MemoryMesh *mesh, const std::string &
 
     // Read data
     std::vector<double> times = timesDs.readArrayDouble();
-    std::vector<float> values = valuesDs.readArray();
+
+    // values of each timestep are read directly to the dataset, when the timesteps are rows of the array
+    std::vector<hsize_t> valuesDims = valuesDs.dims();
+    const bool readByTimesteps = !valuesDims.empty() && valuesDims[0] == timesteps;
+    std::vector<double> values;
+    if ( !readByTimesteps )
+      values = valuesDs.readArrayDouble();
 
     // Create dataset now
     std::shared_ptr<DatasetGroup> ds = std::make_shared< DatasetGroup >(
@@ -945,32 +952,29 @@ bool MDAL::DriverFlo2D::parseHDF5Datasets( MemoryMesh *mesh, const std::string &
       std::shared_ptr< MemoryDataset2D > output = std::make_shared< MemoryDataset2D >( ds.get() );
       output->setTime( times[ts], parseDurationTimeUnit( timeUnitString ) );
 
-      if ( isVector )
+      double *outputValues = output->values();
+      const size_t outputCount = isVector ? 2 * nFaces : nFaces;
+      if ( readByTimesteps )
       {
-        // vector
-        for ( size_t i = 0; i < nFaces; ++i )
-        {
-          size_t idx = 2 * ( ts * nFaces + i );
-          double x = getDouble( static_cast<double>( values[idx] ) );
-          double y = getDouble( static_cast<double>( values[idx + 1] ) );
-          output->setVectorValue( i, x, y );
-        }
+        std::vector<hsize_t> offsets( valuesDims.size(), 0 );
+        std::vector<hsize_t> counts( valuesDims );
+        offsets[0] = ts;
+        counts[0] = 1;
+        if ( !valuesDs.readArrayDouble( offsets, counts, outputValues ) )
+          return true;
       }
       else
       {
-        // scalar
-        for ( size_t i = 0; i < nFaces; ++i )
-        {
-          size_t idx = ts * nFaces + i;
-          double val = getDouble( static_cast<double>( values[idx] ) );
-          output->setScalarValue( i, val );
-        }
+        std::copy( values.begin() + ts * outputCount, values.begin() + ( ts + 1 ) * outputCount, outputValues );
       }
+
+      for ( size_t i = 0; i < outputCount; ++i )
+        outputValues[i] = getDouble( outputValues[i] );
       addDatasetToGroup( ds, std::move( output ) );
     }
 
     // TODO use mins & maxs arrays
-    ds->setStatistics( MDAL::calculateStatistics( ds ) );
+    MDAL::updateStatistics( ds );
     mesh->datasetGroups.emplace_back( std::move( ds ) );
 
   }
@@ -6,6 +6,7 @@
 #include "mdal_gdal.hpp"
 #include <assert.h>
 #include <limits>
+#include <algorithm>
 #include <gdal.h>
 #include <cmath>
 #include "ogr_api.h"
@@ -13,6 +14,7 @@
 #include "gdal_alg.h"
 #include "mdal_utils.hpp"
 #include "mdal_logger.hpp"
+#include "mdal_block_cache.hpp"
 
 #define MDAL_NODATA -9999
 
@@ -41,9 +43,6 @@ void MDAL::GdalDataset::parseParameters()
 
   mYSize = static_cast<unsigned int>( GDALGetRasterYSize( mHDataset ) ); //raster height in pixels
   if ( mYSize == 0 ) throw MDAL::Error( MDAL_Status::Err_InvalidData, "Raster height is zero" );
-
-  mNPoints = mXSize * mYSize;
-  mNVolumes = ( mXSize - 1 ) * ( mYSize - 1 );
 }
 
 void MDAL::GdalDataset::parseProj()
@@ -55,111 +54,181 @@ void MDAL::GdalDataset::parseProj()
   }
 }
 
+MDAL::GdalHandlePool::GdalHandlePool( const std::string &dsName )
+  : mDatasetName( dsName )
+{
+}
+
+MDAL::GdalHandlePool::~GdalHandlePool()
+{
+  for ( GDALDatasetH handle : mHandles )
+    GDALClose( handle );
+}
+
+GDALDatasetH MDAL::GdalHandlePool::acquire()
+{
+  {
+    std::lock_guard<std::mutex> lock( mMutex );
+    if ( !mHandles.empty() )
+    {
+      GDALDatasetH handle = mHandles.back();
+      mHandles.pop_back();
+      return handle;
+    }
+  }
+
+  GDALDatasetH handle = GDALOpen( mDatasetName.data(), GA_ReadOnly );
+  if ( !handle ) throw MDAL::Error( MDAL_Status::Err_FileNotFound, "Unable to open dataset " + mDatasetName );
+  return handle;
+}
+
+void MDAL::GdalHandlePool::release( GDALDatasetH handle )
+{
+  std::lock_guard<std::mutex> lock( mMutex );
+  mHandles.push_back( handle );
+}
+
 /******************************************************************************************************/
 
-bool MDAL::DriverGdal::meshes_equals( const MDAL::GdalDataset *ds1, const MDAL::GdalDataset *ds2 ) const
+MDAL::DatasetGdal::DatasetGdal( MDAL::DatasetGroup *parent, const MDAL::RegularGridMesh *grid, std::vector<Band> bands )
+  : Dataset2D( parent )
+  , mGrid( grid )
+  , mBands( std::move( bands ) )
 {
-  return ( ( ds1->mXSize == ds2->mXSize ) &&
-           ( ds1->mYSize == ds2->mYSize ) &&
-           ( MDAL::equals( ds1->mGT[0], ds2->mGT[0] ) ) &&
-           ( MDAL::equals( ds1->mGT[1], ds2->mGT[1] ) ) &&
-           ( MDAL::equals( ds1->mGT[2], ds2->mGT[2] ) ) &&
-           ( MDAL::equals( ds1->mGT[3], ds2->mGT[3] ) ) &&
-           ( MDAL::equals( ds1->mGT[4], ds2->mGT[4] ) ) &&
-           ( MDAL::equals( ds1->mGT[5], ds2->mGT[5] ) ) &&
-           ds1->mProj == ds2->mProj );
+  assert( mGrid );
+  assert( mBands.size() == ( group()->isScalar() ? 1 : 2 ) );
+  setSupportsActiveFlag( true );
 }
 
+size_t MDAL::DatasetGdal::scalarData( size_t indexStart, size_t count, double *buffer )
+{
+  assert( group()->isScalar() );
+  return MDAL::BlockCache::read( this, valuesCount(), 1, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readData( start, n, values ); } );
+}
 
-bool MDAL::DriverGdal::initVertices( Vertices &vertices )
+size_t MDAL::DatasetGdal::vectorData( size_t indexStart, size_t count, double *buffer )
 {
-  Vertex *VertexsPtr = vertices.data();
-  unsigned int mXSize = meshGDALDataset()->mXSize;
-  unsigned int mYSize = meshGDALDataset()->mYSize;
-  const double *mGT = meshGDALDataset()->mGT;
+  assert( !group()->isScalar() );
+  return MDAL::BlockCache::read( this, valuesCount(), 2, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readData( start, n, values ); } );
+}
 
-  for ( unsigned int y = 0; y < mYSize; ++y )
+size_t MDAL::DatasetGdal::readData( size_t indexStart, size_t count, double *buffer )
+{
+  const size_t xSize = mGrid->xSize();
+  const size_t ySize = mGrid->ySize();
+  if ( indexStart >= valuesCount() )
+    return 0;
+  count = std::min( count, valuesCount() - indexStart );
+  if ( count == 0 )
+    return 0;
+
+  // only the rows of the requested values, natural blocks decoded for them stay in GDAL block cache
+  const size_t firstRow = indexStart / xSize;
+  const size_t endRow = std::min( ySize, ( indexStart + count - 1 ) / xSize + 1 );
+  const size_t stride = mBands.size();
+  std::vector<double> rows( ( endRow - firstRow ) * xSize );
+  for ( size_t component = 0; component < stride; ++component )
   {
-    for ( unsigned int x = 0; x < mXSize; ++x, ++VertexsPtr )
+    const Band &band = mBands[component];
+    GDALDatasetH handle = band.handles->acquire();
+    GDALRasterBandH hBand = GDALGetRasterBand( handle, band.number );
+    CPLErr err = CE_Failure;
+    if ( hBand )
     {
-      // VertexsPtr->setId(x + mXSize*y);
-      VertexsPtr->x = mGT[0] + ( x + 0.5 ) * mGT[1] + ( y + 0.5 ) * mGT[2];
-      VertexsPtr->y = mGT[3] + ( x + 0.5 ) * mGT[4] + ( y + 0.5 ) * mGT[5];
-      VertexsPtr->z = 0.0;
+      err = GDALRasterIO(
+              hBand,
+              GF_Read,
+              0, //nXOff
+              static_cast<int>( firstRow ), //nYOff
+              static_cast<int>( xSize ), //nXSize
+              static_cast<int>( endRow - firstRow ), //nYSize
+              rows.data(), //pData
+              static_cast<int>( xSize ), //nBufXSize
+              static_cast<int>( endRow - firstRow ), //nBufYSize
+              GDT_Float64, //eBufType
+              0, //nPixelSpace
+              0 //nLineSpace
+            );
     }
-  }
+    band.handles->release( handle );
 
-  BBox extent = computeExtent( vertices );
-  // we want to detect situation when there is whole earth represented in dataset
-  bool is_longitude_shifted = ( extent.minX >= 0.0 ) &&
-                              ( fabs( extent.minX + extent.maxX - 360.0 ) < 1.0 ) &&
-                              ( extent.minY >= -90.0 ) &&
-                              ( extent.maxX <= 360.0 ) &&
-                              ( extent.maxX > 180.0 ) &&
-                              ( extent.maxY <= 90.0 );
-  if ( is_longitude_shifted )
-  {
-    for ( Vertices::size_type n = 0; n < vertices.size(); ++n )
+    if ( err != CE_None )
+      throw MDAL::Error( MDAL_Status::Err_InvalidData, "Error while reading GDAL band" );
+
+    const double *values = rows.data() + ( indexStart - firstRow * xSize );
+    const bool hasNoData = !std::isnan( band.nodata );
+    for ( size_t i = 0; i < count; ++i )
     {
-      if ( vertices[n].x > 180.0 )
-      {
-        vertices[n].x -= 360.0;
-      }
+      const double val = values[i];
+      if ( hasNoData && MDAL::equals( val, band.nodata ) )
+        buffer[stride * i + component] = std::numeric_limits<double>::quiet_NaN();
+      else
+        buffer[stride * i + component] = val * band.scale + band.offset; // Apply scale and offset
     }
   }
 
-  return is_longitude_shifted;
+  return count;
 }
 
-void MDAL::DriverGdal::initFaces( const Vertices &Vertexs, Faces &Faces, bool is_longitude_shifted )
+size_t MDAL::DatasetGdal::activeData( size_t indexStart, size_t count, int *buffer )
 {
-  int reconnected = 0;
-  ( void ) reconnected; //avoid warning for unused variable
-  unsigned int mXSize = meshGDALDataset()->mXSize;
-  unsigned int mYSize = meshGDALDataset()->mYSize;
-
-  size_t i = 0;
-
-  for ( unsigned int y = 0; y < mYSize - 1; ++y )
+  const size_t facesCount = mGrid->facesCount();
+  if ( indexStart >= facesCount )
+    return 0;
+  count = std::min( count, facesCount - indexStart );
+  if ( count == 0 )
+    return 0;
+
+  // faces of the range have vertices in the rows of the faces and the following row
+  const size_t xSize = mGrid->xSize();
+  const size_t firstVertex = indexStart / ( xSize - 1 ) * xSize;
+  const size_t endVertex = ( ( indexStart + count - 1 ) / ( xSize - 1 ) + 2 ) * xSize;
+  const size_t stride = mBands.size();
+  std::vector<double> values( ( endVertex - firstVertex ) * stride );
+  const size_t valuesRead = stride == 1 ?
+                            scalarData( firstVertex, endVertex - firstVertex, values.data() ) :
+                            vectorData( firstVertex, endVertex - firstVertex, values.data() );
+  if ( valuesRead != endVertex - firstVertex )
+    return 0;
+
+  // Activate only Faces that do all Vertex's outputs with some data
+  size_t vertexIndices[4];
+  for ( size_t i = 0; i < count; ++i )
   {
-    for ( unsigned int x = 0; x < mXSize - 1; ++x )
+    mGrid->faceVertices( indexStart + i, vertexIndices );
+    buffer[i] = 1;
+    for ( size_t j = 0; j < 4 && buffer[i] == 1; ++j )
     {
-      if ( is_longitude_shifted &&
-           ( Vertexs[x + mXSize * y].x > 0.0 ) &&
-           ( Vertexs[x + 1 + mXSize * y].x < 0.0 ) )
-        // omit border face
+      const double *value = values.data() + ( vertexIndices[j] - firstVertex ) * stride;
+      for ( size_t component = 0; component < stride; ++component )
       {
-        --reconnected;
-        continue;
+        if ( std::isnan( value[component] ) )
+          buffer[i] = 0; //NOT ACTIVE
       }
+    }
+  }
 
-      if ( is_longitude_shifted && ( x == 0 ) )
-      {
-        // create extra faces around prime meridian
-        Faces[i].resize( 4 );
-        Faces[i][0] = mXSize * ( y + 1 );
-        Faces[i][3] = mXSize * y;
-        Faces[i][2] = mXSize - 1 + mXSize * y;
-        Faces[i][1] = mXSize - 1 + mXSize * ( y + 1 );
-
-        ++reconnected;
-        ++i;
-      }
+  return count;
+}
 
-      // other faces
-      Faces[i].resize( 4 );
-      Faces[i][0] = x + 1 + mXSize * ( y + 1 );
-      Faces[i][3] = x + 1 + mXSize * y;
-      Faces[i][2] = x + mXSize * y;
-      Faces[i][1] = x + mXSize * ( y + 1 );
+/******************************************************************************************************/
 
-      ++i;
-    }
-  }
-  //make sure we have discarded same amount of faces that we have added
-  assert( reconnected == 0 );
+bool MDAL::DriverGdal::meshes_equals( const MDAL::GdalDataset *ds1, const MDAL::GdalDataset *ds2 ) const
+{
+  return ( ( ds1->mXSize == ds2->mXSize ) &&
+           ( ds1->mYSize == ds2->mYSize ) &&
+           ( MDAL::equals( ds1->mGT[0], ds2->mGT[0] ) ) &&
+           ( MDAL::equals( ds1->mGT[1], ds2->mGT[1] ) ) &&
+           ( MDAL::equals( ds1->mGT[2], ds2->mGT[2] ) ) &&
+           ( MDAL::equals( ds1->mGT[3], ds2->mGT[3] ) ) &&
+           ( MDAL::equals( ds1->mGT[4], ds2->mGT[4] ) ) &&
+           ( MDAL::equals( ds1->mGT[5], ds2->mGT[5] ) ) &&
+           ds1->mProj == ds2->mProj );
 }
 
+
 std::string MDAL::DriverGdal::GDALFileName( const std::string &fileName )
 {
   return fileName;
@@ -318,89 +387,56 @@ MDAL::DateTime MDAL::DriverGdal::referenceTime() const
   return MDAL::DateTime();
 }
 
-void MDAL::DriverGdal::addDataToOutput( GDALRasterBandH raster_band, std::shared_ptr<MemoryDataset2D> tos, bool is_vector, bool is_x )
+MDAL::DatasetGdal::Band MDAL::DriverGdal::bandInfo( GDALRasterBandH raster_band )
 {
   assert( raster_band );
 
+  DatasetGdal::Band band;
+  GDALDatasetH hDataset = GDALGetBandDataset( raster_band );
+  std::shared_ptr<GdalHandlePool> &handles = mHandlePools[hDataset];
+  if ( !handles )
+  {
+    // the pool takes over the handle opened for parsing
+    for ( const std::shared_ptr<GdalDataset> &ds : gdal_datasets )
+    {
+      if ( ds->mHDataset == hDataset )
+      {
+        handles = std::make_shared<GdalHandlePool>( ds->mDatasetName );
+        handles->release( hDataset );
+        ds->mHDataset = nullptr;
+        break;
+      }
+    }
+  }
+  if ( !handles )
+    throw MDAL::Error( MDAL_Status::Err_InvalidData, "Unknown dataset of GDAL band" );
+
+  band.handles = handles;
+  band.number = GDALGetBandNumber( raster_band );
+
   // nodata
   int pbSuccess;
   double nodata =  GDALGetRasterNoDataValue( raster_band, &pbSuccess );
-  if ( pbSuccess == 0 ) nodata = std::numeric_limits<double>::quiet_NaN();
-  bool hasNoData = !std::isnan( nodata );
+  if ( pbSuccess != 0 )
+    band.nodata = nodata;
 
   // offset and scale
-  double offset = 0.0;
   double scale = GDALGetRasterScale( raster_band, &pbSuccess );
-  if ( ( pbSuccess == 0 ) || MDAL::equals( scale, 0.0 ) || std::isnan( scale ) )
+  if ( ( pbSuccess != 0 ) && !MDAL::equals( scale, 0.0 ) && !std::isnan( scale ) )
   {
-    scale = 1.0;
+    band.scale = scale;
+    double offset = GDALGetRasterOffset( raster_band, &pbSuccess );
+    if ( ( pbSuccess != 0 ) && !std::isnan( offset ) )
+      band.offset = offset;
   }
-  else
-  {
-    offset = GDALGetRasterOffset( raster_band, &pbSuccess );
-    if ( ( pbSuccess == 0 ) || std::isnan( offset ) )
-    {
-      offset = 0.0;
-    }
-  }
-
-  unsigned int mXSize = meshGDALDataset()->mXSize;
-  unsigned int mYSize = meshGDALDataset()->mYSize;
-
-  for ( unsigned int y = 0; y < mYSize; ++y )
-  {
-    // buffering per-line
-    CPLErr err = GDALRasterIO(
-                   raster_band,
-                   GF_Read,
-                   0, //nXOff
-                   static_cast<int>( y ), //nYOff
-                   static_cast<int>( mXSize ), //nXSize
-                   1, //nYSize
-                   mPafScanline, //pData
-                   static_cast<int>( mXSize ), //nBufXSize
-                   1, //nBufYSize
-                   GDT_Float64, //eBufType
-                   0, //nPixelSpace
-                   0 //nLineSpace
-                 );
-    if ( err != CE_None )
-    {
-      throw MDAL::Error( MDAL_Status::Err_InvalidData, "Error while buffering data to output" );
-    }
-
-    for ( unsigned int x = 0; x < mXSize; ++x )
-    {
-      unsigned int idx = x + mXSize * y;
-      double val = mPafScanline[x];
-      if ( !hasNoData || !MDAL::equals( val, nodata ) )
-      {
-        // Apply scale and offset
-        val = val * scale + offset;
 
-        // values is prepolulated with NODATA values, so store only legal values
-        if ( is_vector )
-        {
-          if ( is_x )
-          {
-            tos->setValueX( idx, val );
-          }
-          else
-          {
-            tos->setValueY( idx, val );
-          }
-        }
-        else
-        {
-          tos->setScalarValue( idx, val );
-        }
-      }
-    }
-  }
+  return band;
 }
 
 void MDAL::DriverGdal::addDatasetGroups()
 {
+  std::vector<std::shared_ptr<Dataset>> datasets;
+
   // Add dataset to mMesh
   for ( data_hash::const_iterator band = mBands.begin(); band != mBands.end(); band++ )
   {
@@ -419,44 +455,72 @@ void MDAL::DriverGdal::addDatasetGroups()
 
     for ( timestep_map::const_iterator time_step = band->second.begin(); time_step != band->second.end(); time_step++ )
     {
-      std::vector<GDALRasterBandH> raster_bands = time_step->second;
-      std::shared_ptr<MDAL::MemoryDataset2D> dataset = std::make_shared< MDAL::MemoryDataset2D >( group.get(), true );
+      std::vector<DatasetGdal::Band> raster_bands;
+      for ( GDALRasterBandH raster_band : time_step->second )
+        raster_bands.push_back( bandInfo( raster_band ) );
 
+      std::shared_ptr<MDAL::DatasetGdal> dataset = std::make_shared< MDAL::DatasetGdal >( group.get(), mMesh.get(), std::move( raster_bands ) );
       dataset->setTime( time_step->first );
-      for ( std::vector<GDALRasterBandH>::size_type i = 0; i < raster_bands.size(); ++i )
-      {
-        addDataToOutput( raster_bands[i], dataset, is_vector, i == 0 );
-      }
-      dataset->activateFaces( mMesh.get() );
-      dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
       group->datasets.push_back( dataset );
+      datasets.push_back( dataset );
     }
 
-    // TODO use GDALComputeRasterMinMax
-    group->setStatistics( MDAL::calculateStatistics( group ) );
     group->setReferenceTime( referenceTime() );
     mMesh->datasetGroups.emplace_back( std::move( group ) );
   }
+
+  // bands are independent, statistics of the datasets are computed in parallel, each thread
+  // with its own GDAL handle. The loop inside calculateStatistics() runs serially, see parallelFor()
+  if ( MDAL::lazyStatistics() )
+  {
+    for ( const std::shared_ptr<Dataset> &dataset : datasets )
+      MDAL::updateStatistics( dataset );
+  }
+  else
+  {
+    std::vector<MDAL::Statistics> statistics( datasets.size() );
+    std::vector<std::string> errors( datasets.size() );
+    MDAL::parallelFor( datasets.size(), 1, [&]( size_t begin, size_t end )
+    {
+      for ( size_t i = begin; i < end; ++i )
+      {
+        try
+        {
+          statistics[i] = MDAL::calculateStatistics( datasets[i].get() );
+        }
+        catch ( MDAL::Error &err )
+        {
+          errors[i] = err.mssg;
+        }
+      }
+    } );
+
+    for ( size_t i = 0; i < datasets.size(); ++i )
+    {
+      if ( !errors[i].empty() )
+        throw MDAL::Error( MDAL_Status::Err_InvalidData, errors[i] );
+      datasets[i]->setStatistics( statistics[i] );
+    }
+  }
+
+  // statistics of the groups are combined from the statistics of their datasets computed above
+  for ( const std::shared_ptr<DatasetGroup> &group : mMesh->datasetGroups )
+    MDAL::updateStatistics( group );
 }
 
 void MDAL::DriverGdal::createMesh()
 {
-  Vertices vertices( meshGDALDataset()->mNPoints );
-  bool is_longitude_shifted = initVertices( vertices );
-
-  Faces faces( meshGDALDataset()->mNVolumes );
-  initFaces( vertices, faces, is_longitude_shifted );
-
-  mMesh.reset( new MemoryMesh(
+  const GdalDataset *meshDataset = meshGDALDataset();
+  mMesh.reset( new RegularGridMesh(
                  name(),
-                 4, //maximum quads
-                 mFileName
+                 mFileName,
+                 meshDataset->mXSize,
+                 meshDataset->mYSize,
+                 meshDataset->mGT
                )
              );
-  mMesh->setVertices( std::move( vertices ) );
-  mMesh->setFaces( std::move( faces ) );
   bool proj_added = addSrcProj();
-  if ( ( !proj_added ) && is_longitude_shifted )
+  if ( ( !proj_added ) && mMesh->isLongitudeShifted() )
   {
     std::string wgs84( "+proj=longlat +ellps=WGS84 +datum=WGS84 +no_defs" );
     mMesh->setSourceCrs( wgs84 );
@@ -525,8 +589,7 @@ MDAL::DriverGdal::DriverGdal( const std::string &name,
                               const std::string &filter,
                               const std::string &gdalDriverName ):
   Driver( name, description, filter, Capability::ReadMesh ),
-  mGdalDriverName( gdalDriverName ),
-  mPafScanline( nullptr )
+  mGdalDriverName( gdalDriverName )
 {}
 
 bool MDAL::DriverGdal::canReadMesh( const std::string &uri )
@@ -556,7 +619,6 @@ std::unique_ptr<MDAL::Mesh> MDAL::DriverGdal::load( const std::string &fileName,
   mFileName = fileName;
   MDAL::Log::resetLastStatus();
 
-  mPafScanline = nullptr;
   mMesh.reset();
 
   try
@@ -595,9 +657,6 @@ std::unique_ptr<MDAL::Mesh> MDAL::DriverGdal::load( const std::string &fileName,
     // Construct the mesh with the first dataset
     if ( !gdal_datasets.empty() )
     {
-      std::shared_ptr<MDAL::GdalDataset> meshDataset = gdal_datasets.at( 0 );
-      // Init memory for data reader
-      mPafScanline = new double [meshDataset->mXSize];
       // Create mMesh
       createMesh();
     }
@@ -630,8 +689,7 @@ std::unique_ptr<MDAL::Mesh> MDAL::DriverGdal::load( const std::string &fileName,
   }
 
   gdal_datasets.clear();
-
-  if ( mPafScanline ) delete[] mPafScanline;
+  mHandlePools.clear();
 
 // do not allow mesh without any valid datasets
   if ( mMesh && ( mMesh->datasetGroups.empty() ) )
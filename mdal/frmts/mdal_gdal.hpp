@@ -11,8 +11,11 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
 
 #include "mdal_data_model.hpp"
+#include "mdal_regular_grid_mesh.hpp"
 #include "mdal.h"
 #include "mdal_utils.hpp"
 #include "mdal_driver.hpp"
@@ -39,8 +42,6 @@ namespace MDAL
       unsigned int mNBands = 0; /* number of bands */
       unsigned int mXSize = 0; /* number of x pixels */
       unsigned int mYSize = 0; /* number of y pixels */
-      unsigned int mNPoints = 0; /* nodes count */
-      unsigned int mNVolumes = 0; /* Faces count */
       double mGT[6] = {0, 0, 0, 0, 0, 0}; /* affine transform matrix */
 
     private:
@@ -48,6 +49,70 @@ namespace MDAL
       void parseProj();
   };
 
+  /**
+   * Open handles of one GDAL (sub)dataset shared by the datasets read from it
+   *
+   * GDAL handle must not be used from more threads at once, so each read takes
+   * a handle from the pool and returns it back. New handle is opened when all
+   * the handles are in use, so parallel reads do not wait for each other
+   */
+  class GdalHandlePool
+  {
+    public:
+      explicit GdalHandlePool( const std::string &dsName );
+      ~GdalHandlePool();
+
+      GdalHandlePool( const GdalHandlePool & ) = delete;
+      GdalHandlePool &operator=( const GdalHandlePool & ) = delete;
+
+      //! Returns free handle, throws MDAL::Error when the dataset cannot be opened
+      GDALDatasetH acquire();
+
+      //! Returns the handle to the pool, the pool takes ownership of handles opened elsewhere
+      void release( GDALDatasetH handle );
+
+    private:
+      const std::string mDatasetName;
+      std::mutex mMutex;
+      std::vector<GDALDatasetH> mHandles; //!< handles not in use
+  };
+
+  /**
+   * Dataset of one raster band (two bands for vector) defined on vertices of RegularGridMesh
+   *
+   * Values are read on request through BlockCache. Only the rows of the requested
+   * values are read, the decoded natural blocks are kept by GDAL block cache
+   */
+  class DatasetGdal: public Dataset2D
+  {
+    public:
+      //! Location of the values in the GDAL dataset and their conversion
+      struct Band
+      {
+        std::shared_ptr<GdalHandlePool> handles;
+        int number = 0; //!< starts with 1
+        double nodata = std::numeric_limits<double>::quiet_NaN(); //!< NaN when band has no nodata value
+        double scale = 1.0;
+        double offset = 0.0;
+      };
+
+      //! Constructs dataset with one band for scalar group or X and Y bands for vector group
+      DatasetGdal( DatasetGroup *parent, const RegularGridMesh *grid, std::vector<Band> bands );
+
+      size_t scalarData( size_t indexStart, size_t count, double *buffer ) override;
+      size_t vectorData( size_t indexStart, size_t count, double *buffer ) override;
+
+      //! Face is active when all its vertices have valid value
+      size_t activeData( size_t indexStart, size_t count, int *buffer ) override;
+
+    private:
+      //! Reads values from the file, see BlockCache
+      size_t readData( size_t indexStart, size_t count, double *buffer );
+
+      const RegularGridMesh *mGrid;
+      std::vector<Band> mBands;
+  };
+
   class DriverGdal: public Driver
   {
     public:
@@ -79,15 +144,12 @@ namespace MDAL
 
       void registerDriver();
 
-      void initFaces( const Vertices &nodes, Faces &Faces, bool is_longitude_shifted );
-      bool initVertices( Vertices &vertices ); //returns is_longitude_shifted
-
       const GdalDataset *meshGDALDataset();
 
       bool meshes_equals( const GdalDataset *ds1, const GdalDataset *ds2 ) const;
 
       metadata_hash parseMetadata( GDALMajorObjectH gdalBand, const char *pszDomain = nullptr );
-      void addDataToOutput( GDALRasterBandH raster_band, std::shared_ptr<MemoryDataset2D> tos, bool is_vector, bool is_x );
+      DatasetGdal::Band bandInfo( GDALRasterBandH raster_band );
       bool addSrcProj();
       void addDatasetGroups();
       void createMesh();
@@ -98,8 +160,8 @@ namespace MDAL
 
       std::string mFileName;
       const std::string mGdalDriverName; /* GDAL driver name */
-      double *mPafScanline; /* temporary buffer for reading one raster line */
-      std::unique_ptr< MemoryMesh > mMesh;
+      std::map<GDALDatasetH, std::shared_ptr<GdalHandlePool>> mHandlePools; /* GDAL (Sub)Dataset handle, pool taking it over */
+      std::unique_ptr< RegularGridMesh > mMesh;
       gdal_datasets_vector gdal_datasets;
       data_hash mBands; /* raster bands GDAL handle */
   };
@@ -7,6 +7,70 @@
 #include <cstring>
 #include <algorithm>
 
+static MDAL::Setting sChunkCacheBudget( "MDAL_HDF5_CHUNK_CACHE_MB", 1024 * 1024, 32LL * 1024 * 1024 );
+static MDAL::Setting sMetadataCacheSize( "MDAL_HDF5_METADATA_CACHE_MB", 1024 * 1024, 8LL * 1024 * 1024 );
+static MDAL::Setting sSieveBufferSize( "MDAL_HDF5_SIEVE_BUFFER_KB", 1024, 1024LL * 1024 );
+
+size_t HdfFile::chunkCacheBudget()
+{
+  return static_cast<size_t>( sChunkCacheBudget.value() );
+}
+
+size_t HdfFile::metadataCacheSize()
+{
+  return static_cast<size_t>( sMetadataCacheSize.value() );
+}
+
+size_t HdfFile::sieveBufferSize()
+{
+  return static_cast<size_t>( sSieveBufferSize.value() );
+}
+
+void HdfFile::setCacheSizes( size_t chunkCacheBudget, size_t metadataCacheSize, size_t sieveBufferSize )
+{
+  sChunkCacheBudget.setValue( static_cast<long long>( chunkCacheBudget ) );
+  sMetadataCacheSize.setValue( static_cast<long long>( metadataCacheSize ) );
+  sSieveBufferSize.setValue( static_cast<long long>( sieveBufferSize ) );
+}
+
+//! Returns file access property list with MDAL cache settings, must be closed by caller
+static hid_t _createFileAccessPropertyList()
+{
+  hid_t fapl = H5Pcreate( H5P_FILE_ACCESS );
+  if ( fapl < 0 )
+    return fapl;
+
+  const size_t sieveBufferSize = HdfFile::sieveBufferSize();
+  if ( sieveBufferSize > 0 )
+    H5Pset_sieve_buf_size( fapl, sieveBufferSize );
+
+  const size_t metadataCacheSize = HdfFile::metadataCacheSize();
+  if ( metadataCacheSize > 0 )
+  {
+    H5AC_cache_config_t config;
+    config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+    if ( H5Pget_mdc_config( fapl, &config ) >= 0 )
+    {
+      config.set_initial_size = true;
+      config.initial_size = metadataCacheSize;
+      config.min_size = std::min( config.min_size, metadataCacheSize );
+      config.max_size = std::max( config.max_size, metadataCacheSize );
+      if ( H5Pset_mdc_config( fapl, &config ) < 0 )
+        MDAL::Log::debug( "Unable to set HDF5 metadata cache size" );
+    }
+  }
+  return fapl;
+}
+
+static hid_t _openFile( const std::string &path, unsigned flags )
+{
+  hid_t fapl = _createFileAccessPropertyList();
+  hid_t id = H5Fopen( path.c_str(), flags, fapl < 0 ? H5P_DEFAULT : fapl );
+  if ( fapl >= 0 )
+    H5Pclose( fapl );
+  return id;
+}
+
 HdfFile::HdfFile( const std::string &path, HdfFile::Mode mode )
   : mPath( path )
 {
@@ -14,11 +78,11 @@ HdfFile::HdfFile( const std::string &path, HdfFile::Mode mode )
   {
     case HdfFile::ReadOnly:
       if ( H5Fis_hdf5( mPath.c_str() ) > 0 )
-        d = std::make_shared< Handle >( H5Fopen( path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT ) );
+        d = std::make_shared< Handle >( _openFile( path, H5F_ACC_RDONLY ) );
       break;
     case HdfFile::ReadWrite:
       if ( H5Fis_hdf5( mPath.c_str() ) > 0 )
-        d = std::make_shared< Handle >( H5Fopen( path.c_str(), H5F_ACC_RDWR, H5P_DEFAULT ) );
+        d = std::make_shared< Handle >( _openFile( path, H5F_ACC_RDWR ) );
       break;
     case HdfFile::Create:
       d = std::make_shared< Handle >( H5Fcreate( path.c_str(), H5F_ACC_EXCL, H5P_DEFAULT, H5P_DEFAULT ) );
@@ -178,9 +242,103 @@ HdfDataset::HdfDataset( HdfFile::SharedHandle file, const std::string &path, Hdf
   d = std::make_shared< Handle >( H5Dcreate2( file->id, path.c_str(), dtype.id(), dataspace.id(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT ) );
 }
 
+static size_t _nextPrime( size_t n )
+{
+  if ( n <= 2 )
+    return 2;
+  for ( n |= 1; ; n += 2 )
+  {
+    bool isPrime = true;
+    for ( size_t d = 3; d * d <= n && isPrime; d += 2 )
+      isPrime = n % d != 0;
+    if ( isPrime )
+      return n;
+  }
+}
+
+//! Returns size of the chunk cache of chunked dataset limited by \a budget, 0 if the dataset is not chunked, see MDAL::chunkCacheSize()
+static size_t _chunkCacheSize( hid_t datasetId, size_t budget, size_t &chunkBytes )
+{
+  hid_t dcpl = H5Dget_create_plist( datasetId );
+  if ( dcpl < 0 )
+    return 0;
+
+  std::vector<hsize_t> chunks;
+  if ( H5Pget_layout( dcpl ) == H5D_CHUNKED )
+  {
+    const int rank = H5Pget_chunk( dcpl, 0, nullptr );
+    if ( rank > 0 )
+    {
+      chunks.resize( static_cast<size_t>( rank ) );
+      if ( H5Pget_chunk( dcpl, rank, chunks.data() ) != rank )
+        chunks.clear();
+    }
+  }
+  H5Pclose( dcpl );
+  if ( chunks.empty() )
+    return 0;
+
+  hid_t space = H5Dget_space( datasetId );
+  std::vector<hsize_t> dims( chunks.size() );
+  const bool validSpace = H5Sget_simple_extent_ndims( space ) == static_cast<int>( dims.size() ) &&
+                          H5Sget_simple_extent_dims( space, dims.data(), nullptr ) >= 0;
+  H5Sclose( space );
+  hid_t type = H5Dget_type( datasetId );
+  const size_t valueBytes = H5Tget_size( type );
+  H5Tclose( type );
+  if ( !validSpace )
+    return 0;
+
+  return MDAL::chunkCacheSize( std::vector<size_t>( dims.begin(), dims.end() ),
+                               std::vector<size_t>( chunks.begin(), chunks.end() ),
+                               valueBytes, budget, chunkBytes );
+}
+
+//! Opens the dataset, chunked datasets with chunk cache sized by HdfFile::chunkCacheBudget()
+static hid_t _openDataset( hid_t fileId, const std::string &path )
+{
+  hid_t id = H5Dopen2( fileId, path.c_str(), H5P_DEFAULT );
+  const size_t budget = HdfFile::chunkCacheBudget();
+  if ( id < 0 || budget == 0 )
+    return id;
+
+  size_t chunkBytes = 0;
+  const size_t cacheSize = _chunkCacheSize( id, budget, chunkBytes );
+  if ( cacheSize == 0 )
+    return id;
+
+  size_t currentSlots = 0;
+  size_t currentSize = 0;
+  double preemption = 0.75;
+  hid_t currentDapl = H5Dget_access_plist( id );
+  if ( currentDapl < 0 )
+    return id;
+  const bool hasCurrent = H5Pget_chunk_cache( currentDapl, &currentSlots, &currentSize, &preemption ) >= 0;
+  H5Pclose( currentDapl );
+
+  if ( !hasCurrent || cacheSize <= currentSize )
+    return id;
+
+  // the cache can be only set when the dataset is opened
+  hid_t dapl = H5Pcreate( H5P_DATASET_ACCESS );
+  if ( dapl < 0 )
+    return id;
+
+  // HDF5 recommends prime number of hash slots, about 100 times the number of chunks in the cache
+  const size_t slots = std::max( currentSlots, _nextPrime( cacheSize / chunkBytes * 100 ) );
+  H5Pset_chunk_cache( dapl, slots, cacheSize, preemption );
+  hid_t tunedId = H5Dopen2( fileId, path.c_str(), dapl );
+  H5Pclose( dapl );
+  if ( tunedId < 0 )
+    return id;
+
+  H5Dclose( id );
+  return tunedId;
+}
+
 HdfDataset::HdfDataset( HdfFile::SharedHandle file, const std::string &path )
   : mFile( file ),
-    d( std::make_shared< Handle >( H5Dopen2( file->id, path.c_str(), H5P_DEFAULT ) ) )
+    d( std::make_shared< Handle >( _openDataset( file->id, path ) ) )
 {
 }
 
@@ -226,6 +384,10 @@ std::vector<double> HdfDataset::readArrayDouble( const std::vector<hsize_t> &off
 
 std::vector<int> HdfDataset::readArrayInt( const std::vector<hsize_t> &offsets, const std::vector<hsize_t> &counts ) const { return readArray<int>( H5T_NATIVE_INT, offsets, counts ); }
 
+bool HdfDataset::readArrayDouble( const std::vector<hsize_t> &offsets, const std::vector<hsize_t> &counts, double *buffer, hsize_t stride ) const { return readArray<double>( H5T_NATIVE_DOUBLE, offsets, counts, buffer, stride ); }
+
+bool HdfDataset::readArrayInt( const std::vector<hsize_t> &offsets, const std::vector<hsize_t> &counts, int *buffer, hsize_t stride ) const { return readArray<int>( H5T_NATIVE_INT, offsets, counts, buffer, stride ); }
+
 std::vector<uchar> HdfDataset::readArrayUint8() const { return readArray<uchar>( H5T_NATIVE_UINT8 ); }
 
 std::vector<float> HdfDataset::readArray() const { return readArray<float>( H5T_NATIVE_FLOAT ); }
@@ -362,6 +524,18 @@ void HdfDataspace::selectHyperslab( hsize_t start, hsize_t count )
   }
 }
 
+void HdfDataspace::selectHyperslab( hsize_t start, hsize_t count, hsize_t stride )
+{
+  // this function works only for 1D arrays
+  assert( H5Sget_simple_extent_ndims( d->id ) == 1 );
+
+  herr_t status = H5Sselect_hyperslab( d->id, H5S_SELECT_SET, &start, &stride, &count, NULL );
+  if ( status < 0 )
+  {
+    MDAL::Log::debug( "Failed to select 1D hyperslab!" );
+  }
+}
+
 void HdfDataspace::selectHyperslab( const std::vector<hsize_t> offsets,
                                     const std::vector<hsize_t> counts )
 {
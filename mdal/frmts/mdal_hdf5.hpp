@@ -93,6 +93,30 @@ class HdfFile
     inline bool pathExists( const std::string &path ) const;
     std::string filePath() const;
 
+    /**
+     * Returns maximum size of the chunk cache of one dataset in bytes. When a chunked dataset is opened,
+     * its cache is enlarged to hold all chunks touched by reading of one timestep (row) or of a time series
+     * of one element (column), up to this size. 0 means the default cache of the HDF5 library is used.
+     * Default is 32 MB, it can be also set by environment variable MDAL_HDF5_CHUNK_CACHE_MB (in megabytes)
+     */
+    static size_t chunkCacheBudget();
+
+    /**
+     * Returns initial size of the metadata cache of opened files in bytes, 0 means the default of the HDF5 library.
+     * Default is 8 MB, it can be also set by environment variable MDAL_HDF5_METADATA_CACHE_MB (in megabytes)
+     */
+    static size_t metadataCacheSize();
+
+    /**
+     * Returns size of the sieve buffer used for partial reads of contiguous datasets in bytes, 0 means
+     * the default of the HDF5 library. Default is 1 MB, it can be also set by environment variable
+     * MDAL_HDF5_SIEVE_BUFFER_KB (in kilobytes)
+     */
+    static size_t sieveBufferSize();
+
+    //! Sets sizes of the caches applied to files and datasets opened afterwards
+    static void setCacheSizes( size_t chunkCacheBudget, size_t metadataCacheSize, size_t sieveBufferSize );
+
   protected:
     SharedHandle d;
     std::string mPath;
@@ -240,6 +264,8 @@ class HdfDataspace
 
     //! select from 1D array
     void selectHyperslab( hsize_t start, hsize_t count );
+    //! select every stride-th item from 1D array
+    void selectHyperslab( hsize_t start, hsize_t count, hsize_t stride );
     //! select from N-D array
     void selectHyperslab( const std::vector<hsize_t> offsets,
                           const std::vector<hsize_t> counts );
@@ -309,6 +335,13 @@ class HdfDataset
     std::vector<double> readArrayDouble( const std::vector<hsize_t> &offsets, const std::vector<hsize_t> &counts ) const;
     std::vector<int> readArrayInt( const std::vector<hsize_t> &offsets, const std::vector<hsize_t> &counts ) const;
 
+    //! Reads part of the N-D array directly to the buffer, values are converted by HDF5 library,
+    //! buffer must have space for ( n - 1 ) * stride + 1 values, where n is product of counts
+    //! \param stride distance of two consecutive values in the buffer, e.g. 2 to fill one component of vector values
+    //! \returns false when the read fails
+    bool readArrayDouble( const std::vector<hsize_t> &offsets, const std::vector<hsize_t> &counts, double *buffer, hsize_t stride = 1 ) const;
+    bool readArrayInt( const std::vector<hsize_t> &offsets, const std::vector<hsize_t> &counts, int *buffer, hsize_t stride = 1 ) const;
+
     inline bool hasAttribute( const std::string &attr_name ) const;
     inline HdfAttribute attribute( const std::string &attr_name ) const;
 
@@ -329,25 +362,45 @@ class HdfDataset
         const std::vector<hsize_t> &offsets,
         const std::vector<hsize_t> &counts ) const
     {
-      HdfDataspace dataspace( d->id );
-      dataspace.selectHyperslab( offsets, counts );
+      hsize_t totalItems = 1;
+      for ( auto it = counts.begin(); it != counts.end(); ++it )
+        totalItems *= *it;
+
+      std::vector<T> data( totalItems );
+      if ( !readArray( mem_type_id, offsets, counts, data.data() ) )
+        return std::vector<T>();
+      return data;
+    }
 
+    template <typename T> bool readArray( hid_t mem_type_id,
+                                          const std::vector<hsize_t> &offsets,
+                                          const std::vector<hsize_t> &counts,
+                                          T *buffer,
+                                          hsize_t stride = 1 ) const
+    {
       hsize_t totalItems = 1;
       for ( auto it = counts.begin(); it != counts.end(); ++it )
         totalItems *= *it;
+      if ( totalItems == 0 )
+        return true;
+
+      HdfDataspace dataspace( d->id );
+      dataspace.selectHyperslab( offsets, counts );
 
-      std::vector<hsize_t> dims = {totalItems};
+      std::vector<hsize_t> dims = {( totalItems - 1 ) * stride + 1};
       HdfDataspace memspace( dims );
-      memspace.selectHyperslab( 0, totalItems );
+      if ( stride == 1 )
+        memspace.selectHyperslab( 0, totalItems );
+      else
+        memspace.selectHyperslab( 0, totalItems, stride );
 
-      std::vector<T> data( totalItems );
-      herr_t status = H5Dread( d->id, mem_type_id, memspace.id(), dataspace.id(), H5P_DEFAULT, data.data() );
+      herr_t status = H5Dread( d->id, mem_type_id, memspace.id(), dataspace.id(), H5P_DEFAULT, buffer );
       if ( status < 0 )
       {
         MDAL::Log::debug( "Failed to read data!" );
-        return std::vector<T>();
+        return false;
       }
-      return data;
+      return true;
     }
 
     //! Reads float value
@@ -9,12 +9,14 @@
 #include <cmath>
 #include <limits>
 #include <iterator>
+#include <algorithm>
 #include "assert.h"
 
 #include "mdal_hec2d.hpp"
 #include "mdal_hdf5.hpp"
 #include "mdal_utils.hpp"
 #include "mdal_logger.hpp"
+#include "mdal_block_cache.hpp"
 
 static HdfFile openHdfFile( const std::string &fileName )
 {
@@ -206,8 +208,302 @@ static std::vector<MDAL::RelativeTimestamp> readTimes( const HdfFile &hdfFile )
   return convertTimeData( times, dataTimeUnits );
 }
 
+MDAL::DatasetHec2D::DatasetHec2D( MDAL::DatasetGroup *parent,
+                                  std::shared_ptr<const std::vector<MDAL::Hec2DAreaOutput>> areas,
+                                  hsize_t timeIndex,
+                                  Filter filter,
+                                  std::shared_ptr<MDAL::MemoryDataset2D> bedElevation )
+  : Dataset2D( parent )
+  , mAreas( std::move( areas ) )
+  , mTimeIndex( timeIndex )
+  , mFilter( filter )
+  , mBedElevation( std::move( bedElevation ) )
+{
+}
+
+MDAL::DatasetHec2D::~DatasetHec2D() = default;
+
+size_t MDAL::DatasetHec2D::scalarData( size_t indexStart, size_t count, double *buffer )
+{
+  assert( group()->isScalar() ); //checked in C API interface
+  return MDAL::BlockCache::read( this, valuesCount(), 1, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readScalarData( start, n, values ); } );
+}
+
+bool MDAL::DatasetHec2D::readRow( const HdfDataset &values, size_t start, size_t count, double *buffer ) const
+{
+  // summary outputs and geometry have single row (1D array)
+  if ( values.dims().size() == 1 )
+    return values.readArrayDouble( {start}, {count}, buffer );
+  else
+    return values.readArrayDouble( {mTimeIndex, start}, {1, count}, buffer );
+}
+
+size_t MDAL::DatasetHec2D::readScalarData( size_t indexStart, size_t count, double *buffer )
+{
+  const double eps = static_cast<double>( std::numeric_limits<float>::epsilon() ); //hecras use float so comparison needs to use float epsilon
+
+  const size_t nValues = valuesCount();
+  if ( ( count < 1 ) || ( indexStart >= nValues ) )
+    return 0;
+  count = std::min( nValues - indexStart, count );
+
+  std::fill( buffer, buffer + count, std::numeric_limits<double>::quiet_NaN() );
+
+  for ( const Hec2DAreaOutput &area : *mAreas )
+  {
+    // part of the requested range in this area
+    const size_t first = std::max( indexStart, area.cellStart );
+    const size_t last = std::min( indexStart + count, area.cellStart + area.cellCount );
+    if ( first >= last )
+      continue;
+
+    // values are read in place and filtered
+    double *areaBuffer = buffer + ( first - indexStart );
+    if ( !readRow( area.values, first - area.cellStart, last - first, areaBuffer ) )
+    {
+      std::fill( areaBuffer, areaBuffer + ( last - first ), std::numeric_limits<double>::quiet_NaN() );
+      continue;
+    }
+
+    for ( size_t eInx = first; eInx < last; ++eInx )
+    {
+      double &val = buffer[eInx - indexStart];
+      if ( std::isnan( val ) )
+        continue;
+
+      if ( mFilter == Depth )
+      {
+        if ( fabs( val ) <= eps ) // 0 Depth is no-data
+          val = std::numeric_limits<double>::quiet_NaN();
+      }
+      else if ( mFilter == WaterSurface )
+      {
+        assert( mBedElevation );
+        double bed_elev = mBedElevation->scalarValue( eInx );
+        if ( !std::isnan( bed_elev ) && fabs( val - bed_elev ) <= ( val + bed_elev )*eps ) // no change from bed elevation
+          val = std::numeric_limits<double>::quiet_NaN();
+      }
+    }
+  }
+
+  return count;
+}
+
+size_t MDAL::DatasetHec2D::vectorData( size_t indexStart, size_t count, double *buffer )
+{
+  assert( !group()->isScalar() ); //checked in C API interface
+  return MDAL::BlockCache::read( this, valuesCount(), 2, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readVectorData( start, n, values ); } );
+}
+
+size_t MDAL::DatasetHec2D::readVectorData( size_t indexStart, size_t count, double *buffer )
+{
+  const size_t nValues = valuesCount();
+  if ( ( count < 1 ) || ( indexStart >= nValues ) )
+    return 0;
+  count = std::min( nValues - indexStart, count );
+
+  std::fill( buffer, buffer + 2 * count, std::numeric_limits<double>::quiet_NaN() );
+
+  for ( const Hec2DAreaOutput &area : *mAreas )
+  {
+    const size_t first = std::max( indexStart, area.cellStart );
+    const size_t last = std::min( indexStart + count, area.cellStart + area.cellCount );
+    if ( first >= last )
+      continue;
+
+    averageFaceValues( area, first - area.cellStart, last - first, buffer + 2 * ( first - indexStart ) );
+  }
+
+  return count;
+}
+
+void MDAL::DatasetHec2D::averageFaceValues( const MDAL::Hec2DAreaOutput &area, size_t cellIndex, size_t count, double *buffer ) const
+{
+  const Hec2DFaceToCellOperator &faceToCell = *area.faceToCell;
+
+  // faces of the cells are not ordered by cells, only the range of faces used by the cells is read
+  size_t firstFace = 0;
+  size_t endFace = 0;
+  faceToCell.faceRange( cellIndex, count, firstFace, endFace );
+  if ( firstFace >= endFace )
+    return;
+
+  std::vector<double> vals( endFace - firstFace );
+  if ( !readRow( area.values, firstFace, vals.size(), vals.data() ) )
+    return;
+
+  faceToCell.apply( vals.data(), firstFace, cellIndex, count, buffer );
+}
+
+MDAL::Hec2DFaceToCellOperator::Hec2DFaceToCellOperator( size_t cellCount,
+    size_t faceCount,
+    const std::vector<int> &cellFaceInfo,
+    const std::vector<int> &cellFaceOrValues,
+    const std::vector<int> &facePointIndex,
+    const std::vector<double> &facePointCoords )
+  : mFaceCount( faceCount )
+  , mPairOffsets( cellCount + 1, 0 )
+{
+  const std::vector<double> &coords = facePointCoords;
+  mPairFaces.reserve( cellFaceOrValues.size() );
+
+  // unit normal of each face, shared by both cells of the face
+  mFaceNormals.resize( mFaceCount * 2, std::numeric_limits<double>::quiet_NaN() );
+  for ( size_t faceIndex = 0; faceIndex < mFaceCount; ++faceIndex )
+  {
+    size_t indexPoint1 = facePointIndex[faceIndex * 2];
+    size_t indexPoint2 = facePointIndex[faceIndex * 2 + 1];
+    double dx = coords[indexPoint1 * 2] - coords[indexPoint2 * 2];
+    double dy = coords[indexPoint1 * 2 + 1] - coords[indexPoint2 * 2 + 1];
+    double l = sqrt( dx * dx + dy * dy );
+    if ( l == 0 )
+      continue;
+    mFaceNormals[faceIndex * 2] = -dy / l;
+    mFaceNormals[faceIndex * 2 + 1] = dx / l;
+  }
+
+  for ( size_t cell_idx = 0; cell_idx < cellCount; ++cell_idx )
+  {
+    size_t firstPosition = static_cast<size_t>( cellFaceInfo[cell_idx * 2] );
+    size_t faceCount = static_cast<size_t>( cellFaceInfo[cell_idx * 2 + 1] );
+    for ( size_t f = 0; f < faceCount; ++f )
+    {
+      //get face indexes
+      size_t faceIndex1 = static_cast<size_t>( cellFaceOrValues[( firstPosition + f ) * 2] );
+      size_t faceIndex2 = static_cast<size_t>( cellFaceOrValues[( firstPosition + ( f + 1 ) % faceCount ) * 2] );
+      if ( faceIndex1 >= mFaceCount || faceIndex2 >= mFaceCount )
+        continue;
+
+      size_t indexPoint11 = facePointIndex[faceIndex1 * 2];
+      size_t indexPoint12 = facePointIndex[faceIndex1 * 2 + 1];
+      size_t indexPoint21 = facePointIndex[faceIndex2 * 2];
+      size_t indexPoint22 = facePointIndex[faceIndex2 * 2 + 1];
+      bool commonIndex = ( indexPoint11 == indexPoint21 ||
+                           indexPoint11 == indexPoint22 ||
+                           indexPoint12 == indexPoint21 ||
+                           indexPoint12 == indexPoint22 );
+      if ( !commonIndex )
+      {
+        // should not happen, but better to prevent
+        continue;
+      }
+
+      double nx1 = mFaceNormals[faceIndex1 * 2];
+      double ny1 = mFaceNormals[faceIndex1 * 2 + 1];
+      double nx2 = mFaceNormals[faceIndex2 * 2];
+      double ny2 = mFaceNormals[faceIndex2 * 2 + 1];
+      if ( std::isnan( nx1 ) || std::isnan( nx2 ) )
+      {
+        continue;
+      }
+
+      double deter = nx1 * ny2 - nx2 * ny1;
+      if ( deter == 0 ) //colinear face, forbidden by hecras, but better to prevent
+        continue;
+
+      mPairFaces.push_back( static_cast<int>( faceIndex1 ) );
+      mPairFaces.push_back( static_cast<int>( faceIndex2 ) );
+    }
+    mPairOffsets[cell_idx + 1] = mPairFaces.size() / 2;
+  }
+
+  mPairFaces.shrink_to_fit();
+}
+
+void MDAL::Hec2DFaceToCellOperator::faceRange( size_t cellIndex, size_t count, size_t &firstFace, size_t &endFace ) const
+{
+  firstFace = 0;
+  endFace = 0;
+  if ( cellIndex >= cellCount() )
+    return;
+  count = std::min( count, cellCount() - cellIndex );
+
+  size_t minFace = std::numeric_limits<size_t>::max();
+  size_t maxFace = 0;
+  for ( size_t i = mPairOffsets[cellIndex] * 2; i < mPairOffsets[cellIndex + count] * 2; ++i )
+  {
+    const size_t face = static_cast<size_t>( mPairFaces[i] );
+    minFace = std::min( minFace, face );
+    maxFace = std::max( maxFace, face );
+  }
+
+  if ( minFace <= maxFace )
+  {
+    firstFace = minFace;
+    endFace = maxFace + 1;
+  }
+}
+
+void MDAL::Hec2DFaceToCellOperator::apply( const double *faceValues, size_t firstFace, size_t cellIndex, size_t count, double *buffer ) const
+{
+
+  if ( cellIndex >= cellCount() )
+    return;
+  count = std::min( count, cellCount() - cellIndex );
+
+  MDAL::parallelFor( count, 1 << 14, [&]( size_t begin, size_t end )
+  {
+    for ( size_t i = begin; i < end; ++i )
+    {
+      const size_t cell = cellIndex + i;
+      double valx = 0;
+      double valy = 0;
+      size_t consideredValueCount = 0;
+      for ( size_t pair = mPairOffsets[cell]; pair < mPairOffsets[cell + 1]; ++pair )
+      {
+        const size_t face1 = static_cast<size_t>( mPairFaces[pair * 2] );
+        const size_t face2 = static_cast<size_t>( mPairFaces[pair * 2 + 1] );
+        double val1 = faceValues[face1 - firstFace];
+        double val2 = faceValues[face2 - firstFace];
+        if ( std::isnan( val1 ) || std::isnan( val2 ) )
+          continue;
+
+        const double nx1 = mFaceNormals[face1 * 2];
+        const double ny1 = mFaceNormals[face1 * 2 + 1];
+        const double nx2 = mFaceNormals[face2 * 2];
+        const double ny2 = mFaceNormals[face2 * 2 + 1];
+        const double deter = nx1 * ny2 - nx2 * ny1;
+        valx += ( ny2 * val1 - ny1 * val2 ) / deter;
+        valy += ( nx1 * val2 - nx2 * val1 ) / deter;
+        consideredValueCount++;
+      }
+
+      if ( consideredValueCount != 0 )
+      {
+        buffer[2 * i] = valx / consideredValueCount;
+        buffer[2 * i + 1] = valy / consideredValueCount;
+      }
+    }
+  } );
+}
+
+static std::shared_ptr<const MDAL::Hec2DFaceToCellOperator> readFaceToCellOperator( const HdfFile &hdfFile, const std::string &flowAreaName )
+{
+  HdfGroup gGeom = openHdfGroup( hdfFile, "Geometry" );
+  HdfGroup gGeom2DFlowAreas = openHdfGroup( gGeom, "2D Flow Areas" );
+  HdfGroup gArea = openHdfGroup( gGeom2DFlowAreas, flowAreaName );
+  HdfDataset dsCellFaceInfo = openHdfDataset( gArea, "Cells Face and Orientation Info" );
+  size_t cellCount = static_cast<size_t>( dsCellFaceInfo.dims().at( 0 ) );
+  std::vector<int> cellFaceInfo = dsCellFaceInfo.readArrayInt();
+
+  HdfDataset dsCellFaceOrValues = openHdfDataset( gArea, "Cells Face and Orientation Values" );
+  std::vector<int> cellFaceOrValues = dsCellFaceOrValues.readArrayInt();
+
+  HdfDataset dsFacePointIndex = openHdfDataset( gArea, "Faces FacePoint Indexes" );
+  size_t faceCount = static_cast<size_t>( dsFacePointIndex.dims().at( 0 ) );
+  std::vector<int> facePointIndex = dsFacePointIndex.readArrayInt();
+
+  HdfDataset dsCoords = openHdfDataset( gArea, "FacePoints Coordinate" );
+  std::vector<double> coords = dsCoords.readArrayDouble(); //2xnNodes matrix in array
+
+  return std::make_shared<MDAL::Hec2DFaceToCellOperator>( cellCount, faceCount, cellFaceInfo, cellFaceOrValues, facePointIndex, coords );
+}
+
 void MDAL::DriverHec2D::readFaceOutput( const HdfFile &hdfFile,
                                         const HdfGroup &rootGroup,
+                                        std::vector<std::shared_ptr<const Hec2DFaceToCellOperator>> &faceToCellOperators,
                                         const std::vector<size_t> &areaElemStartIndex,
                                         const std::vector<std::string> &flowAreaNames,
                                         const std::string rawDatasetName,
@@ -215,144 +511,51 @@ void MDAL::DriverHec2D::readFaceOutput( const HdfFile &hdfFile,
                                         const std::vector<RelativeTimestamp> &times,
                                         const DateTime &referenceTime )
 {
-  std::shared_ptr<DatasetGroup> group = std::make_shared< DatasetGroup >(
-                                          name(),
-                                          mMesh.get(),
-                                          mFileName,
-                                          datasetName
-                                        );
-  group->setDataLocation( MDAL_DataLocation::DataOnFaces );
-  group->setIsScalar( false );
-  group->setReferenceTime( referenceTime );
-
-  std::vector<std::shared_ptr<MDAL::MemoryDataset2D>> datasets;
-
-  for ( size_t tidx = 0; tidx < times.size(); ++tidx )
-  {
-    std::shared_ptr<MDAL::MemoryDataset2D> dataset = std::make_shared< MemoryDataset2D >( group.get() );
-    dataset->setTime( times[tidx] );
-    datasets.emplace_back( std::move( dataset ) );
-  }
-
-  std::shared_ptr<MDAL::MemoryDataset2D> firstDataset;
+  std::shared_ptr<std::vector<Hec2DAreaOutput>> areas = std::make_shared<std::vector<Hec2DAreaOutput>>( flowAreaNames.size() );
 
   for ( size_t nArea = 0; nArea < flowAreaNames.size(); ++nArea )
   {
     std::string flowAreaName = flowAreaNames[nArea];
 
     HdfGroup gFlowAreaRes = openHdfGroup( rootGroup, flowAreaName );
-    HdfDataset dsVals;
+    Hec2DAreaOutput &area = areas->at( nArea );
     try
     {
-      dsVals = openHdfDataset( gFlowAreaRes, rawDatasetName );
+      area.values = openHdfDataset( gFlowAreaRes, rawDatasetName );
     }
     catch ( MDAL::Error & )
     {
       return;
     }
 
-    std::vector<float> vals = dsVals.readArray();
-
-    HdfGroup gGeom = openHdfGroup( hdfFile, "Geometry" );
-    HdfGroup gGeom2DFlowAreas = openHdfGroup( gGeom, "2D Flow Areas" );
-    HdfGroup gArea = openHdfGroup( gGeom2DFlowAreas, flowAreaName );
-    HdfDataset dsCellFaceInfo = openHdfDataset( gArea, "Cells Face and Orientation Info" );
-    std::vector<hsize_t> celldims = dsCellFaceInfo.dims();
-    std::vector<int> cellFaceInfo = dsCellFaceInfo.readArrayInt();
-
-    HdfDataset dsCellFaceOrValues = openHdfDataset( gArea, "Cells Face and Orientation Values" );
-    std::vector<int> cellFaceOrValues = dsCellFaceOrValues.readArrayInt();
+    // operator is built once and shared by all outputs on faces
+    if ( !faceToCellOperators[nArea] )
+      faceToCellOperators[nArea] = readFaceToCellOperator( hdfFile, flowAreaName );
 
-    HdfDataset dsFacePointIndex = openHdfDataset( gArea, "Faces FacePoint Indexes" );
-    std::vector<hsize_t> fdims = dsFacePointIndex.dims();
-    size_t nFaces = static_cast<size_t>( fdims[0] );
-    std::vector<int> facePointIndex = dsFacePointIndex.readArrayInt();
-
-    HdfDataset dsCoords = openHdfDataset( gArea, "FacePoints Coordinate" );
-    std::vector<hsize_t> cdims = dsCoords.dims();
-    std::vector<double> coords = dsCoords.readArrayDouble(); //2xnNodes matrix in array
-
-    for ( size_t tidx = 0; tidx < times.size(); ++tidx )
-    {
-      std::shared_ptr<MDAL::MemoryDataset2D> dataset = datasets[tidx];
-      double *values = dataset->values();
-
-      for ( size_t cell_idx = 0; cell_idx < celldims.at( 0 ); ++cell_idx )
-      {
-        size_t cell_mdal_idx = cell_idx + areaElemStartIndex[nArea];
-        double valx = 0;
-        double valy = 0;
-        size_t consideredValueCount = 0;
-        size_t firstPosition = static_cast<size_t>( cellFaceInfo[cell_idx * 2] );
-        size_t faceCount = static_cast<size_t>( cellFaceInfo[cell_idx * 2 + 1] );
-        for ( size_t f = 0; f < faceCount; ++f )
-        {
-          //get face indexes
-          size_t faceIndex1 = static_cast<size_t>( cellFaceOrValues[( firstPosition + f ) * 2] );
-          size_t faceIndex2 = static_cast<size_t>( cellFaceOrValues[( firstPosition + ( f + 1 ) % faceCount ) * 2] );
-          double val1 = static_cast<double>( vals[faceIndex1 + tidx * nFaces] );
-          double val2 = static_cast<double>( vals[faceIndex2 + tidx * nFaces] );
-          if ( std::isnan( val1 ) || std::isnan( val2 ) )
-            continue;
-
-          size_t indexPoint11 = facePointIndex[faceIndex1 * 2];
-          size_t indexPoint12 = facePointIndex[faceIndex1 * 2 + 1];
-          size_t indexPoint21 = facePointIndex[faceIndex2 * 2];
-          size_t indexPoint22 = facePointIndex[faceIndex2 * 2 + 1];
-          bool commonIndex = ( indexPoint11 == indexPoint21 ||
-                               indexPoint11 == indexPoint22 ||
-                               indexPoint12 == indexPoint21 ||
-                               indexPoint12 == indexPoint22 );
-          if ( !commonIndex )
-          {
-            // should not happen, but better to prevent
-            continue;
-          }
-
-          double dx1 = coords[indexPoint11 * 2] - coords[indexPoint12 * 2];
-          double dy1 = coords[indexPoint11 * 2 + 1] - coords[indexPoint12 * 2 + 1];
-          double dx2 = coords[indexPoint21 * 2] - coords[indexPoint22 * 2];
-          double dy2 = coords[indexPoint21 * 2 + 1] - coords[indexPoint22 * 2 + 1];
-          double l1 = sqrt( dx1 * dx1 + dy1 * dy1 );
-          double l2 = sqrt( dx2 * dx2 + dy2 * dy2 );
-          if ( l1 == 0 || l2 == 0 )
-          {
-            continue;
-          }
-          double nx1 =   -dy1 / l1;
-          double ny1 =  dx1 / l1;
-          double nx2 =   -dy2 / l2;
-          double ny2 =  dx2 / l2;
-
-          double deter = nx1 * ny2 - nx2 * ny1;
-          if ( deter == 0 ) //colinear face, forbidden by hecras, but better to prevent
-            continue;
-          valx += ( ny2 * val1 - ny1 * val2 ) / deter;
-          valy += ( nx1 * val2 - nx2 * val1 ) / deter;
-          consideredValueCount++;
-        }
-        if ( consideredValueCount != 0 )
-        {
-          valx /= consideredValueCount;
-          valy /= consideredValueCount;
-          values[cell_mdal_idx * 2] = valx;
-          values[cell_mdal_idx * 2 + 1] = valy;
-        }
-        else
-        {
-          values[cell_mdal_idx * 2] = std::numeric_limits<double>::quiet_NaN();
-          values[cell_mdal_idx * 2 + 1] = std::numeric_limits<double>::quiet_NaN();
-        }
-      }
-    }
+    area.cellStart = areaElemStartIndex[nArea];
+    area.cellCount = areaElemStartIndex[nArea + 1] - areaElemStartIndex[nArea];
+    area.faceToCell = faceToCellOperators[nArea];
   }
 
-  for ( auto &dataset : datasets )
+  std::shared_ptr<DatasetGroup> group = std::make_shared< DatasetGroup >(
+                                          name(),
+                                          mMesh.get(),
+                                          mFileName,
+                                          datasetName
+                                        );
+  group->setDataLocation( MDAL_DataLocation::DataOnFaces );
+  group->setIsScalar( false );
+  group->setReferenceTime( referenceTime );
+
+  for ( size_t tidx = 0; tidx < times.size(); ++tidx )
   {
-    dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+    std::shared_ptr<DatasetHec2D> dataset = std::make_shared< DatasetHec2D >( group.get(), areas, tidx );
+    dataset->setTime( times[tidx] );
+    MDAL::updateStatistics( dataset );
     group->datasets.push_back( dataset );
   }
-  group->setStatistics( MDAL::calculateStatistics( group ) );
+
+  MDAL::updateStatistics( group );
   mMesh->datasetGroups.emplace_back( std::move( group ) );
 }
 
@@ -360,31 +563,51 @@ void MDAL::DriverHec2D::readFaceResults( const HdfFile &hdfFile,
     const std::vector<size_t> &areaElemStartIndex,
     const std::vector<std::string> &flowAreaNames )
 {
+  std::vector<std::shared_ptr<const Hec2DFaceToCellOperator>> faceToCellOperators( flowAreaNames.size() );
+
   // UNSTEADY
   HdfGroup flowGroup = get2DFlowAreasGroup( hdfFile, "Unsteady Time Series" );
   MDAL::DateTime referenceDateTime = readReferenceDateTime( hdfFile );
-  readFaceOutput( hdfFile, flowGroup, areaElemStartIndex, flowAreaNames, "Face Shear Stress", "Shear Stress", mTimes, referenceDateTime );
-  readFaceOutput( hdfFile, flowGroup, areaElemStartIndex, flowAreaNames, "Face Velocity", "Velocity", mTimes, referenceDateTime );
+  readFaceOutput( hdfFile, flowGroup, faceToCellOperators, areaElemStartIndex, flowAreaNames, "Face Shear Stress", "Shear Stress", mTimes, referenceDateTime );
+  readFaceOutput( hdfFile, flowGroup, faceToCellOperators, areaElemStartIndex, flowAreaNames, "Face Velocity", "Velocity", mTimes, referenceDateTime );
 
   // SUMMARY
   flowGroup = get2DFlowAreasGroup( hdfFile, "Summary Output" );
   std::vector<MDAL::RelativeTimestamp> dummyTimes( 1, MDAL::RelativeTimestamp() );
 
-  readFaceOutput( hdfFile, flowGroup, areaElemStartIndex, flowAreaNames, "Maximum Face Shear Stress", "Shear Stress/Maximums", dummyTimes, referenceDateTime );
-  readFaceOutput( hdfFile, flowGroup, areaElemStartIndex, flowAreaNames, "Maximum Face Velocity", "Velocity/Maximums", dummyTimes, referenceDateTime );
+  readFaceOutput( hdfFile, flowGroup, faceToCellOperators, areaElemStartIndex, flowAreaNames, "Maximum Face Shear Stress", "Shear Stress/Maximums", dummyTimes, referenceDateTime );
+  readFaceOutput( hdfFile, flowGroup, faceToCellOperators, areaElemStartIndex, flowAreaNames, "Maximum Face Velocity", "Velocity/Maximums", dummyTimes, referenceDateTime );
 }
 
 
-std::shared_ptr<MDAL::MemoryDataset2D> MDAL::DriverHec2D::readElemOutput( const HdfGroup &rootGroup,
-    const std::vector<size_t> &areaElemStartIndex,
-    const std::vector<std::string> &flowAreaNames,
-    const std::string rawDatasetName,
-    const std::string datasetName,
-    const std::vector<RelativeTimestamp> &times,
-    std::shared_ptr<MDAL::MemoryDataset2D> bed_elevation,
-    const DateTime &referenceTime )
+void MDAL::DriverHec2D::readElemOutput( const HdfGroup &rootGroup,
+                                        const std::vector<size_t> &areaElemStartIndex,
+                                        const std::vector<std::string> &flowAreaNames,
+                                        const std::string rawDatasetName,
+                                        const std::string datasetName,
+                                        const std::vector<RelativeTimestamp> &times,
+                                        std::shared_ptr<MDAL::MemoryDataset2D> bed_elevation,
+                                        const DateTime &referenceTime )
 {
-  double eps = static_cast<double>( std::numeric_limits<float>::epsilon() ); //hecras use float so comparison needs to use float epsilon
+  std::shared_ptr<std::vector<Hec2DAreaOutput>> areas = std::make_shared<std::vector<Hec2DAreaOutput>>( flowAreaNames.size() );
+
+  for ( size_t nArea = 0; nArea < flowAreaNames.size(); ++nArea )
+  {
+    HdfGroup gFlowAreaRes = openHdfGroup( rootGroup, flowAreaNames[nArea] );
+    Hec2DAreaOutput &area = areas->at( nArea );
+    try
+    {
+      area.values = openHdfDataset( gFlowAreaRes, rawDatasetName );
+    }
+    catch ( MDAL::Error & )
+    {
+      return;
+    }
+    area.cellStart = areaElemStartIndex[nArea];
+    area.cellCount = areaElemStartIndex[nArea + 1] - areaElemStartIndex[nArea];
+  }
+
+  DatasetHec2D::Filter filter = datasetName == "Depth" ? DatasetHec2D::Depth : DatasetHec2D::WaterSurface;
 
   std::shared_ptr<DatasetGroup> group = std::make_shared< DatasetGroup >(
                                           name(),
@@ -396,106 +619,61 @@ std::shared_ptr<MDAL::MemoryDataset2D> MDAL::DriverHec2D::readElemOutput( const
   group->setIsScalar( true );
   group->setReferenceTime( referenceTime );
 
-  std::vector<std::shared_ptr<MDAL::MemoryDataset2D>> datasets;
-
   for ( size_t tidx = 0; tidx < times.size(); ++tidx )
   {
-    std::shared_ptr<MDAL::MemoryDataset2D> dataset = std::make_shared< MemoryDataset2D >( group.get() );
+    std::shared_ptr<DatasetHec2D> dataset = std::make_shared< DatasetHec2D >( group.get(), areas, tidx, filter, bed_elevation );
     dataset->setTime( times[tidx] );
-    datasets.emplace_back( std::move( dataset ) );
+    MDAL::updateStatistics( dataset );
+    group->datasets.push_back( dataset );
   }
 
+  MDAL::updateStatistics( group );
+  mMesh->datasetGroups.emplace_back( std::move( group ) );
+}
+
+std::shared_ptr<MDAL::MemoryDataset2D> MDAL::DriverHec2D::readBedElevation(
+  const HdfGroup &gGeom2DFlowAreas,
+  const std::vector<size_t> &areaElemStartIndex,
+  const std::vector<std::string> &flowAreaNames )
+{
+  // bed elevation is needed to filter water surface values, so it is kept in memory
+  std::shared_ptr<DatasetGroup> group = std::make_shared< DatasetGroup >(
+                                          name(),
+                                          mMesh.get(),
+                                          mFileName,
+                                          "Bed Elevation"
+                                        );
+  group->setDataLocation( MDAL_DataLocation::DataOnFaces );
+  group->setIsScalar( true );
+
+  std::shared_ptr<MDAL::MemoryDataset2D> bedElevation = std::make_shared< MemoryDataset2D >( group.get() );
+  double *values = bedElevation->values();
+
   for ( size_t nArea = 0; nArea < flowAreaNames.size(); ++nArea )
   {
     size_t nAreaElements = areaElemStartIndex[nArea + 1] - areaElemStartIndex[nArea];
-    std::string flowAreaName = flowAreaNames[nArea];
-    HdfGroup gFlowAreaRes = openHdfGroup( rootGroup, flowAreaName );
+    HdfGroup gArea = openHdfGroup( gGeom2DFlowAreas, flowAreaNames[nArea] );
 
     HdfDataset dsVals;
     try
     {
-      dsVals = openHdfDataset( gFlowAreaRes, rawDatasetName );
+      dsVals = openHdfDataset( gArea, "Cells Minimum Elevation" );
     }
     catch ( MDAL::Error & )
     {
-      return nullptr;
+      throw MDAL::Error( MDAL_Status::Err_InvalidData, "Unable to read bed elevation values" );
     }
 
-    std::vector<float> vals = dsVals.readArray();
-
-    for ( size_t tidx = 0; tidx < times.size(); ++tidx )
-    {
-      std::shared_ptr<MDAL::MemoryDataset2D> dataset = datasets[tidx];
-      double *values = dataset->values();
-
-      for ( size_t i = 0; i < nAreaElements; ++i )
-      {
-        size_t idx = tidx * nAreaElements + i;
-        size_t eInx = areaElemStartIndex[nArea] + i;
-        double val =  static_cast<double>( vals[idx] );
-        if ( !std::isnan( val ) )
-        {
-          if ( !bed_elevation )
-          {
-            // we are populating bed elevation dataset
-            values[eInx] = val;
-          }
-          else
-          {
-            if ( datasetName == "Depth" )
-            {
-              if ( fabs( val ) > eps ) // 0 Depth is no-data
-              {
-                values[eInx] = val;
-              }
-            }
-            else //Water surface
-            {
-              assert( bed_elevation );
-              double bed_elev = bed_elevation->scalarValue( eInx );
-              if ( std::isnan( bed_elev ) || fabs( val - bed_elev ) > ( val + bed_elev )*eps )  // change from bed elevation
-              {
-                values[eInx] = val;
-              }
-            }
-          }
-        }
-      }
-    }
+    nAreaElements = std::min( nAreaElements, static_cast<size_t>( dsVals.elementCount() ) );
+    if ( !dsVals.readArrayDouble( {0}, {nAreaElements}, values + areaElemStartIndex[nArea] ) )
+      throw MDAL::Error( MDAL_Status::Err_InvalidData, "Unable to read bed elevation values" );
   }
 
-  for ( auto &dataset : datasets )
-  {
-    dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
-    group->datasets.push_back( dataset );
-  }
-  group->setStatistics( MDAL::calculateStatistics( group ) );
+  MDAL::updateStatistics( bedElevation );
+  group->datasets.push_back( bedElevation );
+  MDAL::updateStatistics( group );
   mMesh->datasetGroups.emplace_back( std::move( group ) );
 
-  return datasets[0];
-}
-
-std::shared_ptr<MDAL::MemoryDataset2D> MDAL::DriverHec2D::readBedElevation(
-  const HdfGroup &gGeom2DFlowAreas,
-  const std::vector<size_t> &areaElemStartIndex,
-  const std::vector<std::string> &flowAreaNames )
-{
-  std::vector<MDAL::RelativeTimestamp> times( 1 );
-  DateTime referenceTime;
-
-  std::shared_ptr<MDAL::MemoryDataset2D> bedElevation = readElemOutput(
-        gGeom2DFlowAreas,
-        areaElemStartIndex,
-        flowAreaNames,
-        "Cells Minimum Elevation",
-        "Bed Elevation",
-        times,
-        std::shared_ptr<MDAL::MemoryDataset2D>(),
-        referenceTime
-      );
-
-  if ( ! bedElevation ) throw MDAL::Error( MDAL_Status::Err_InvalidData, "Unable to read bed elevation values" );
-
   return bedElevation;
 }
 
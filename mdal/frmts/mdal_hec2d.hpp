@@ -7,6 +7,8 @@
 #define MDAL_HEC2D_HPP
 
 #include <string>
+#include <vector>
+#include <memory>
 
 #include "mdal_data_model.hpp"
 #include "mdal_memory_data_model.hpp"
@@ -16,6 +18,105 @@
 
 namespace MDAL
 {
+  /**
+   * Sparse operator interpolating values on faces (edges) of the cells of a 2D flow area to the cells
+   *
+   * Values on faces are normal components of a vector. For each pair of neighbouring faces of a cell,
+   * the vector is reconstructed from the two normal components, and the cell value is the average
+   * of the vectors of the pairs with valid values. The topology and the normals do not change
+   * between timesteps, so the pairs are built once in compressed sparse row form
+   */
+  class Hec2DFaceToCellOperator
+  {
+    public:
+      /**
+       * Builds the operator from the geometry of the flow area
+       * \param cellFaceInfo first position and count of faces of each cell in cellFaceOrValues
+       * \param cellFaceOrValues face index and orientation
+       * \param facePointIndex two face points of each face
+       * \param facePointCoords x and y of each face point
+       */
+      Hec2DFaceToCellOperator( size_t cellCount,
+                               size_t faceCount,
+                               const std::vector<int> &cellFaceInfo,
+                               const std::vector<int> &cellFaceOrValues,
+                               const std::vector<int> &facePointIndex,
+                               const std::vector<double> &facePointCoords );
+
+      size_t cellCount() const { return mPairOffsets.size() - 1; }
+      size_t faceCount() const { return mFaceCount; }
+
+      //! Returns range [firstFace, endFace) of faces used by \a count cells starting with \a cellIndex, empty if they have no faces
+      void faceRange( size_t cellIndex, size_t count, size_t &firstFace, size_t &endFace ) const;
+
+      /**
+       * Interpolates values of faces to \a count cells starting with \a cellIndex, \a faceValues
+       * starts with the value of \a firstFace and covers faceRange() of the cells.
+       * Two values per cell are written to \a buffer, cells without valid faces are left untouched
+       */
+      void apply( const double *faceValues, size_t firstFace, size_t cellIndex, size_t count, double *buffer ) const;
+
+    private:
+      size_t mFaceCount = 0;
+      std::vector<size_t> mPairOffsets; //!< first pair of each cell, cellCount() + 1 items
+      std::vector<int> mPairFaces; //!< two faces of each pair
+      std::vector<double> mFaceNormals; //!< nx and ny of each face, NaN for faces with zero length
+  };
+
+  //! Output variable of one 2D flow area, array of values for each timestep (row) and each cell or face (column)
+  struct Hec2DAreaOutput
+  {
+    HdfDataset values;
+    size_t cellStart = 0; //!< index of the first cell of the area in the mesh
+    size_t cellCount = 0;
+    std::shared_ptr<const Hec2DFaceToCellOperator> faceToCell; //!< only for values on faces
+  };
+
+  /**
+   * Dataset of one timestep of HEC-RAS 2D results
+   *
+   * Values are read from the file on request, one hyperslab for each flow area.
+   * Vector values defined on faces of the cells are averaged to the cells
+   * only when the dataset is read
+   */
+  class DatasetHec2D: public Dataset2D
+  {
+    public:
+      //! How the raw values of the cells are turned to no-data
+      enum Filter
+      {
+        NoFilter,
+        Depth, //!< zero depth is no-data
+        WaterSurface, //!< water surface equal to bed elevation is no-data
+      };
+
+      DatasetHec2D( DatasetGroup *parent,
+                    std::shared_ptr<const std::vector<Hec2DAreaOutput>> areas,
+                    hsize_t timeIndex,
+                    Filter filter = NoFilter,
+                    std::shared_ptr<MemoryDataset2D> bedElevation = std::shared_ptr<MemoryDataset2D>() );
+      ~DatasetHec2D() override;
+
+      size_t scalarData( size_t indexStart, size_t count, double *buffer ) override;
+      size_t vectorData( size_t indexStart, size_t count, double *buffer ) override;
+
+    private:
+      //! Reads values from the file, see BlockCache
+      size_t readScalarData( size_t indexStart, size_t count, double *buffer );
+      size_t readVectorData( size_t indexStart, size_t count, double *buffer );
+
+      //! Reads \a count values from \a start (relative to the row) of the timestep row to the buffer
+      bool readRow( const HdfDataset &values, size_t start, size_t count, double *buffer ) const;
+
+      //! Averages values on faces to \a count cells of the area starting with \a cellIndex (relative to the area)
+      void averageFaceValues( const Hec2DAreaOutput &area, size_t cellIndex, size_t count, double *buffer ) const;
+
+      std::shared_ptr<const std::vector<Hec2DAreaOutput>> mAreas;
+      hsize_t mTimeIndex;
+      Filter mFilter;
+      std::shared_ptr<MemoryDataset2D> mBedElevation;
+  };
+
   /**
    * HEC-RAS 2D format.
    *
@@ -34,6 +135,8 @@ namespace MDAL
    * All reference times can be found in Time Data Stamp dataset.
    * First value in the dataset is reported by MDAL as reference time
    *
+   * Only the bed elevation is read to memory, values of the results are read
+   * from the file when requested, see DatasetHec2D
    */
   class DriverHec2D: public Driver
   {
@@ -60,6 +163,7 @@ namespace MDAL
       // Common functions
       void readFaceOutput( const HdfFile &hdfFile,
                            const HdfGroup &rootGroup,
+                           std::vector<std::shared_ptr<const Hec2DFaceToCellOperator>> &faceToCellOperators,
                            const std::vector<size_t> &areaElemStartIndex,
                            const std::vector<std::string> &flowAreaNames,
                            const std::string rawDatasetName,
@@ -71,7 +175,7 @@ namespace MDAL
                             const std::vector<size_t> &areaElemStartIndex,
                             const std::vector<std::string> &flowAreaNames );
 
-      std::shared_ptr<MDAL::MemoryDataset2D> readElemOutput(
+      void readElemOutput(
         const HdfGroup &rootGroup,
         const std::vector<size_t> &areaElemStartIndex,
         const std::vector<std::string> &flowAreaNames,
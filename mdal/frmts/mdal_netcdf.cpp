@@ -9,6 +9,8 @@
 #include <assert.h>
 #include <netcdf.h>
 #include <cmath>
+#include <limits>
+#include <algorithm>
 
 #include "mdal_netcdf.hpp"
 #include "mdal.h"
@@ -39,6 +41,128 @@ void NetCDFFile::openFile( const std::string &fileName, bool write )
     throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not open file " + fileName );
   }
   mFileName = fileName;
+
+  if ( !write )
+    tuneChunkCaches();
+}
+
+static MDAL::Setting sChunkCacheBudget( "MDAL_NETCDF_CHUNK_CACHE_MB", 1024 * 1024, 32LL * 1024 * 1024 );
+
+size_t NetCDFFile::chunkCacheBudget()
+{
+  return static_cast<size_t>( sChunkCacheBudget.value() );
+}
+
+void NetCDFFile::setChunkCacheBudget( size_t bytes )
+{
+  sChunkCacheBudget.setValue( static_cast<long long>( bytes ) );
+}
+
+void NetCDFFile::tuneChunkCaches()
+{
+  const size_t budget = chunkCacheBudget();
+  if ( budget == 0 )
+    return;
+
+  int nvars;
+  if ( nc_inq_varids( mNcid, &nvars, nullptr ) != NC_NOERR )
+    return;
+  std::vector<int> varids( static_cast<size_t>( nvars ) );
+  if ( nc_inq_varids( mNcid, &nvars, varids.data() ) != NC_NOERR )
+    return;
+
+  for ( int varid : varids )
+  {
+    int ndims = 0;
+    if ( nc_inq_varndims( mNcid, varid, &ndims ) != NC_NOERR || ndims < 1 )
+      continue;
+
+    // netCDF-3 and contiguous netCDF-4 variables do not have chunks
+    int storage = NC_CONTIGUOUS;
+    std::vector<size_t> chunks( static_cast<size_t>( ndims ) );
+    if ( nc_inq_var_chunking( mNcid, varid, &storage, chunks.data() ) != NC_NOERR || storage != NC_CHUNKED )
+      continue;
+
+    nc_type type;
+    size_t typeSize = 0;
+    std::vector<int> dimIds( static_cast<size_t>( ndims ) );
+    if ( nc_inq_vartype( mNcid, varid, &type ) != NC_NOERR ||
+         nc_inq_type( mNcid, type, nullptr, &typeSize ) != NC_NOERR ||
+         nc_inq_vardimid( mNcid, varid, dimIds.data() ) != NC_NOERR )
+      continue;
+
+    std::vector<size_t> dims( chunks.size() );
+    for ( size_t d = 0; d < chunks.size(); ++d )
+    {
+      if ( nc_inq_dimlen( mNcid, dimIds[d], &dims[d] ) != NC_NOERR )
+        dims[d] = chunks[d];
+    }
+
+    size_t chunkBytes = 0;
+    const size_t cacheSize = MDAL::chunkCacheSize( dims, chunks, typeSize, budget, chunkBytes );
+    if ( cacheSize == 0 )
+      continue;
+
+    size_t currentSize = 0;
+    size_t currentSlots = 0;
+    float preemption = 0.75f;
+    if ( nc_get_var_chunk_cache( mNcid, varid, &currentSize, &currentSlots, &preemption ) != NC_NOERR || currentSize >= cacheSize )
+      continue;
+
+    const size_t slots = std::max( currentSlots, cacheSize / chunkBytes * 2 + 1 );
+    if ( nc_set_var_chunk_cache( mNcid, varid, cacheSize, slots, preemption ) != NC_NOERR )
+      MDAL::Log::debug( "Unable to set chunk cache of variable in " + mFileName );
+  }
+}
+
+// numeric types converted to double directly by netCDF library
+static bool _isConvertibleToDouble( nc_type type )
+{
+  return type == NC_FLOAT ||
+         type == NC_DOUBLE ||
+         type == NC_INT ||
+         type == NC_UINT ||
+         type == NC_INT64 ||
+         type == NC_UINT64;
+}
+
+/**
+ * Reads hyperslab of the variable with \a valuesCount values to the buffer
+ * All hyperslabs are contiguous (unit stride), nc_get_vara_* is used since
+ * nc_get_vars_* can read chunked netCDF-4 variables value by value
+ */
+static void _readDoubleHyperslab( int ncid, int arr_id,
+                                  const size_t *startp, const size_t *countp,
+                                  size_t valuesCount, double *buffer )
+{
+  nc_type typep;
+  if ( nc_inq_vartype( ncid, arr_id, &typep ) != NC_NOERR )
+    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
+
+  if ( _isConvertibleToDouble( typep ) )
+  {
+    if ( nc_get_vara_double( ncid, arr_id, startp, countp, buffer ) != NC_NOERR )
+      throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
+  }
+  else if ( typep == NC_BYTE )
+  {
+    // stored as unsigned with 129 for no data, it cannot be converted by netCDF
+    std::vector<unsigned char> arr_val_b( valuesCount );
+    if ( nc_get_vara_uchar( ncid, arr_id, startp, countp, arr_val_b.data() ) != NC_NOERR )
+      throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
+    for ( size_t i = 0; i < valuesCount; ++i )
+    {
+      const unsigned char val = arr_val_b[i];
+      if ( val == 129 )
+        buffer[i] = std::numeric_limits<double>::quiet_NaN();
+      else
+        buffer[i] = double( int( val ) );
+    }
+  }
+  else
+  {
+    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
+  }
 }
 
 std::vector<int> NetCDFFile::readIntArr( const std::string &name, size_t dim ) const
@@ -52,31 +176,39 @@ std::vector<int> NetCDFFile::readIntArr( const std::string &name, size_t dim ) c
 }
 
 std::vector<int> NetCDFFile::readIntArr( int arr_id, size_t start_dim1, size_t start_dim2, size_t count_dim1, size_t count_dim2 ) const
+{
+  std::vector<int> arr_val( count_dim1 * count_dim2 );
+  readIntArr( arr_id, start_dim1, start_dim2, count_dim1, count_dim2, arr_val.data() );
+  return arr_val;
+}
+
+void NetCDFFile::readIntArr( int arr_id, size_t start_dim1, size_t start_dim2, size_t count_dim1, size_t count_dim2, int *buffer ) const
 {
   assert( mNcid != 0 );
 
-  const std::vector<size_t> startp = {start_dim1, start_dim2};
-  const std::vector<size_t> countp = {count_dim1, count_dim2};
-  const std::vector<ptrdiff_t> stridep = {1, 1};
+  const size_t startp[] = {start_dim1, start_dim2};
+  const size_t countp[] = {count_dim1, count_dim2};
 
-  std::vector<int> arr_val( count_dim1 * count_dim2 );
-  int res = nc_get_vars_int( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val.data() );
+  int res = nc_get_vara_int( mNcid, arr_id, startp, countp, buffer );
   if ( res != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read numeric array" );
-  return arr_val;
 }
 
 std::vector<int> NetCDFFile::readIntArr( int arr_id, size_t start_dim, size_t count_dim ) const
+{
+  std::vector<int> arr_val( count_dim );
+  readIntArr( arr_id, start_dim, count_dim, arr_val.data() );
+  return arr_val;
+}
+
+void NetCDFFile::readIntArr( int arr_id, size_t start_dim, size_t count_dim, int *buffer ) const
 {
   assert( mNcid != 0 );
 
-  const std::vector<size_t> startp = {start_dim};
-  const std::vector<size_t> countp = {count_dim};
-  const std::vector<ptrdiff_t> stridep = {1};
+  const size_t startp[] = {start_dim};
+  const size_t countp[] = {count_dim};
 
-  std::vector<int> arr_val( count_dim );
-  int res = nc_get_vars_int( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val.data() );
+  int res = nc_get_vara_int( mNcid, arr_id, startp, countp, buffer );
   if ( res != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read numeric array" );
-  return arr_val;
 }
 
 std::vector<double> NetCDFFile::readDoubleArr( const std::string &name, size_t dim ) const
@@ -85,69 +217,13 @@ std::vector<double> NetCDFFile::readDoubleArr( const std::string &name, size_t d
 
   int arr_id;
   if ( nc_inq_varid( mNcid, name.c_str(), &arr_id ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-  std::vector<double> arr_val( dim );
 
   nc_type typep;
-  if ( nc_inq_varid( mNcid, name.c_str(), &arr_id ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
   if ( nc_inq_vartype( mNcid, arr_id, &typep ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
+  if ( !_isConvertibleToDouble( typep ) ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
 
-  if ( typep == NC_FLOAT )
-  {
-    std::vector<float> arr_val_f( dim );
-    if ( nc_get_var_float( mNcid, arr_id, arr_val_f.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < dim; ++i )
-    {
-      const float val = arr_val_f[i];
-      if ( std::isnan( val ) )
-        arr_val[i] = std::numeric_limits<double>::quiet_NaN();
-      else
-        arr_val[i] = static_cast<double>( val );
-    }
-  }
-  else if ( typep == NC_DOUBLE )
-  {
-    if ( nc_get_var_double( mNcid, arr_id, arr_val.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-  }
-  else if ( typep == NC_INT )
-  {
-    std::vector<int> arr_val_int( dim );
-    if ( nc_get_var_int( mNcid, arr_id, arr_val_int.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read integer array" );
-    for ( size_t i = 0; i < dim; ++i )
-    {
-      arr_val[i] = arr_val_int[i];
-    }
-  }
-  else if ( typep == NC_UINT )
-  {
-    std::vector<unsigned int> arr_val_uint( dim );
-    if ( nc_get_var_uint( mNcid, arr_id, arr_val_uint.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read integer array" );
-    for ( size_t i = 0; i < dim; ++i )
-    {
-      arr_val[i] = arr_val_uint[i];
-    }
-  }
-  else if ( typep == NC_INT64 )
-  {
-    std::vector<long long> arr_val_int( dim );
-    if ( nc_get_var_longlong( mNcid, arr_id, arr_val_int.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read integer array" );
-    for ( size_t i = 0; i < dim; ++i )
-    {
-      arr_val[i] = static_cast<double>( arr_val_int[i] );
-    }
-  }
-  else if ( typep == NC_UINT64 )
-  {
-    std::vector<unsigned long long> arr_val_int( dim );
-    if ( nc_get_var_ulonglong( mNcid, arr_id, arr_val_int.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read integer array" );
-    for ( size_t i = 0; i < dim; ++i )
-    {
-      arr_val[i] = static_cast<double>( arr_val_int[i] );
-    }
-  }
-  else
-  {
-    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-  }
+  std::vector<double> arr_val( dim );
+  if ( nc_get_var_double( mNcid, arr_id, arr_val.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
   return arr_val;
 }
 
@@ -155,88 +231,22 @@ std::vector<double> NetCDFFile::readDoubleArr( int arr_id,
     size_t start_dim1, size_t start_dim2,
     size_t count_dim1, size_t count_dim2 ) const
 {
-  assert( mNcid != 0 );
-
-  const std::vector<size_t> startp = {start_dim1, start_dim2};
-  const std::vector<size_t> countp = {count_dim1, count_dim2};
-  const std::vector<ptrdiff_t> stridep = {1, 1};
-
   std::vector<double> arr_val( count_dim1 * count_dim2 );
+  readDoubleArr( arr_id, start_dim1, start_dim2, count_dim1, count_dim2, arr_val.data() );
+  return arr_val;
+}
 
-  nc_type typep;
-  if ( nc_inq_vartype( mNcid, arr_id, &typep ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
+void NetCDFFile::readDoubleArr( int arr_id,
+                                size_t start_dim1, size_t start_dim2,
+                                size_t count_dim1, size_t count_dim2,
+                                double *buffer ) const
+{
+  assert( mNcid != 0 );
 
-  if ( typep == NC_FLOAT )
-  {
-    std::vector<float> arr_val_f( count_dim1 * count_dim2 );
-    if ( nc_get_vars_float( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val_f.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < count_dim1 * count_dim2; ++i )
-    {
-      const float val = arr_val_f[i];
-      if ( std::isnan( val ) )
-        arr_val[i] = std::numeric_limits<double>::quiet_NaN();
-      else
-        arr_val[i] = static_cast<double>( val );
-    }
-  }
-  else if ( typep == NC_BYTE )
-  {
-    std::vector<unsigned char> arr_val_b( count_dim1 * count_dim2 );
-    if ( nc_get_vars_uchar( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val_b.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < count_dim1 * count_dim2; ++i )
-    {
-      const unsigned char val = arr_val_b[i];
-      if ( val == 129 )
-        arr_val[i] = std::numeric_limits<double>::quiet_NaN();
-      else
-        arr_val[i] = double( int( val ) );
-    }
-  }
-  else if ( typep == NC_DOUBLE )
-  {
-    if ( nc_get_vars_double( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-  }
-  else if ( typep == NC_INT )
-  {
-    std::vector<int> arr_val_int( count_dim1 * count_dim2 );
-    if ( nc_get_vars_int( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val_int.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < count_dim1 * count_dim2; ++i )
-    {
-      arr_val[i] = arr_val_int[i];
-    }
-  }
-  else if ( typep == NC_UINT )
-  {
-    std::vector<unsigned int> arr_val_uint( count_dim1 * count_dim2 );
-    if ( nc_get_vars_uint( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val_uint.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < count_dim1 * count_dim2; ++i )
-    {
-      arr_val[i] = arr_val_uint[i];
-    }
-  }
-  else if ( typep == NC_INT64 )
-  {
-    std::vector<long long> arr_val_int( count_dim1 * count_dim2 );
-    if ( nc_get_vars_longlong( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val_int.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < count_dim1 * count_dim2; ++i )
-    {
-      arr_val[i] = static_cast<double>( arr_val_int[i] );
-    }
-  }
-  else if ( typep == NC_UINT64 )
-  {
-    std::vector<unsigned long long> arr_val_int( count_dim1 * count_dim2 );
-    if ( nc_get_vars_ulonglong( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val_int.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < count_dim1 * count_dim2; ++i )
-    {
-      arr_val[i] = static_cast<double>( arr_val_int[i] );
-    }
-  }
-  else
-  {
-    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-  }
-  return arr_val;
+  const size_t startp[] = {start_dim1, start_dim2};
+  const size_t countp[] = {count_dim1, count_dim2};
+
+  _readDoubleHyperslab( mNcid, arr_id, startp, countp, count_dim1 * count_dim2, buffer );
 }
 
 std::vector<double> NetCDFFile::readDoubleArr( int arr_id,
@@ -244,79 +254,19 @@ std::vector<double> NetCDFFile::readDoubleArr( int arr_id,
     size_t count_dim
                                              ) const
 {
-  assert( mNcid != 0 );
-
-  const std::vector<size_t> startp = {start_dim};
-  const std::vector<size_t> countp = {count_dim};
-  const std::vector<ptrdiff_t> stridep = {1, 1};
-
   std::vector<double> arr_val( count_dim );
+  readDoubleArr( arr_id, start_dim, count_dim, arr_val.data() );
+  return arr_val;
+}
 
-  nc_type typep;
-  if ( nc_inq_vartype( mNcid, arr_id, &typep ) != NC_NOERR )
-    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
+void NetCDFFile::readDoubleArr( int arr_id, size_t start_dim, size_t count_dim, double *buffer ) const
+{
+  assert( mNcid != 0 );
 
-  if ( typep == NC_FLOAT )
-  {
-    std::vector<float> arr_val_f( count_dim );
-    if ( nc_get_vars_float( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val_f.data() ) != NC_NOERR )
-      throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < count_dim; ++i )
-    {
-      const float val = arr_val_f[i];
-      if ( std::isnan( val ) )
-        arr_val[i] = std::numeric_limits<double>::quiet_NaN();
-      else
-        arr_val[i] = static_cast<double>( val );
-    }
-  }
-  else if ( typep == NC_INT )
-  {
-    std::vector<int> arr_val_int( count_dim );
-    if ( nc_get_vars_int( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val_int.data() ) != NC_NOERR )
-      throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < count_dim; ++i )
-    {
-      arr_val[i] = static_cast<double>( arr_val_int[i] );
-    }
-  }
-  else if ( typep == NC_DOUBLE )
-  {
-    if ( nc_get_vars_double( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val.data() ) != NC_NOERR )
-      throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-  }
-  else if ( typep == NC_UINT )
-  {
-    std::vector<unsigned int> arr_val_uint( count_dim );
-    if ( nc_get_vars_uint( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val_uint.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < count_dim; ++i )
-    {
-      arr_val[i] = arr_val_uint[i];
-    }
-  }
-  else if ( typep == NC_INT64 )
-  {
-    std::vector<long long> arr_val_int( count_dim );
-    if ( nc_get_vars_longlong( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val_int.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < count_dim; ++i )
-    {
-      arr_val[i] = static_cast<double>( arr_val_int[i] );
-    }
-  }
-  else if ( typep == NC_UINT64 )
-  {
-    std::vector<unsigned long long> arr_val_int( count_dim );
-    if ( nc_get_vars_ulonglong( mNcid, arr_id, startp.data(), countp.data(), stridep.data(), arr_val_int.data() ) != NC_NOERR ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-    for ( size_t i = 0; i < count_dim; ++i )
-    {
-      arr_val[i] = static_cast<double>( arr_val_int[i] );
-    }
-  }
-  else
-  {
-    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Could not read double array" );
-  }
-  return arr_val;
+  const size_t startp[] = {start_dim};
+  const size_t countp[] = {count_dim};
+
+  _readDoubleHyperslab( mNcid, arr_id, startp, countp, count_dim, buffer );
 }
 
 bool NetCDFFile::hasArr( const std::string &name ) const
@@ -484,13 +434,68 @@ bool NetCDFFile::hasDimension( const std::string &name ) const
 
 void NetCDFFile::createFile( const std::string &fileName )
 {
-  int res = nc_create( MDAL::systemFileName( fileName ).c_str(), NC_CLOBBER, &mNcid );
+  const std::string systemFileName = MDAL::systemFileName( fileName );
+  int res = NC_NOERR;
+  bool created = false;
+  if ( compressionLevel() > 0 )
+  {
+    res = nc_create( systemFileName.c_str(), NC_CLOBBER | NC_NETCDF4, &mNcid );
+    created = res == NC_NOERR;
+  }
+
+  // compression disabled or library without netCDF-4 support
+  if ( !created )
+    res = nc_create( systemFileName.c_str(), NC_CLOBBER, &mNcid );
+
+  if ( res != NC_NOERR )
+  {
+    throw MDAL::Error( MDAL_Status::Err_FailToWriteToDisk, nc_strerror( res ) );
+  }
+}
+
+bool NetCDFFile::isNetCDF4() const
+{
+  int format = 0;
+  if ( nc_inq_format( mNcid, &format ) != NC_NOERR )
+    return false;
+  return format == NC_FORMAT_NETCDF4;
+}
+
+void NetCDFFile::defineVarCompression( int varId, const std::vector<size_t> &chunkSizes )
+{
+  const int level = compressionLevel();
+  if ( level <= 0 || !isNetCDF4() )
+    return;
+
+  int res = nc_def_var_chunking( mNcid, varId, NC_CHUNKED, chunkSizes.data() );
+  if ( res == NC_NOERR )
+    res = nc_def_var_deflate( mNcid, varId, shuffle() ? 1 : 0, 1, level );
+
   if ( res != NC_NOERR )
   {
     throw MDAL::Error( MDAL_Status::Err_FailToWriteToDisk, nc_strerror( res ) );
   }
 }
 
+static MDAL::Setting sCompressionLevel( "MDAL_NETCDF_DEFLATE_LEVEL", 1, 0 );
+static MDAL::Setting sShuffle( "MDAL_NETCDF_SHUFFLE", 1, 1 );
+
+int NetCDFFile::compressionLevel()
+{
+  return static_cast<int>( std::min( 9LL, sCompressionLevel.value() ) );
+}
+
+bool NetCDFFile::shuffle()
+{
+  return sShuffle.value() != 0;
+}
+
+void NetCDFFile::setCompression( int level, bool shuffle )
+{
+  sCompressionLevel.setValue( std::min( 9, std::max( 0, level ) ) );
+  sShuffle.setValue( shuffle ? 1 : 0 );
+}
+
 int NetCDFFile::defineDimension( const std::string &name, size_t size )
 {
   int dimId = 0;
@@ -577,6 +582,27 @@ void NetCDFFile::putDataArrayInt( int varId, size_t line, size_t faceVerticesMax
   }
 }
 
+void NetCDFFile::putDataArrayInt( int varId, size_t line, size_t lineCount, size_t faceVerticesMax, const int *values )
+{
+  const size_t start[] = { line, 0 };
+  const size_t count[] = { lineCount, faceVerticesMax };
+
+  int res = nc_put_vara_int( mNcid, varId, start, count, values );
+  if ( res != NC_NOERR )
+  {
+    throw MDAL::Error( MDAL_Status::Err_FailToWriteToDisk, nc_strerror( res ) );
+  }
+}
+
+void NetCDFFile::putDataDoubleArr( int varId, size_t start, size_t count, const double *values )
+{
+  int res = nc_put_vara_double( mNcid, varId, &start, &count, values );
+  if ( res != NC_NOERR )
+  {
+    throw MDAL::Error( MDAL_Status::Err_FailToWriteToDisk, nc_strerror( res ) );
+  }
+}
+
 std::string NetCDFFile::getFileName() const
 {
   return mFileName;
@@ -37,6 +37,22 @@ class NetCDFFile
                                  size_t count_dim
                                ) const;
 
+    /** Reads hyperslap from int variable - 2D array, to the \a buffer with count_dim1 * count_dim2 values */
+    void readIntArr( int arr_id,
+                     size_t start_dim1,
+                     size_t start_dim2,
+                     size_t count_dim1,
+                     size_t count_dim2,
+                     int *buffer
+                   ) const;
+
+    /** Reads hyperslap from int variable - 1D array, to the \a buffer with count_dim values */
+    void readIntArr( int arr_id,
+                     size_t start_dim,
+                     size_t count_dim,
+                     int *buffer
+                   ) const;
+
     std::vector<double> readDoubleArr( const std::string &name, size_t dim ) const;
 
     /** Reads hyperslap from double variable - 2D array */
@@ -53,6 +69,25 @@ class NetCDFFile
                                        size_t count_dim
                                      ) const;
 
+    /**
+     * Reads hyperslap from numeric variable - 2D array, to the \a buffer with count_dim1 * count_dim2 values
+     * Values are converted to double by the netCDF library, without temporary arrays
+     */
+    void readDoubleArr( int arr_id,
+                        size_t start_dim1,
+                        size_t start_dim2,
+                        size_t count_dim1,
+                        size_t count_dim2,
+                        double *buffer
+                      ) const;
+
+    /** Reads hyperslap from numeric variable - 1D array, to the \a buffer with count_dim values */
+    void readDoubleArr( int arr_id,
+                        size_t start_dim,
+                        size_t count_dim,
+                        double *buffer
+                      ) const;
+
     bool hasArr( const std::string &name ) const;
     int arrId( const std::string &name ) const;
 
@@ -78,7 +113,21 @@ class NetCDFFile
     void getDimensions( const std::string &variableName, std::vector<size_t> &dimensionsId, std::vector<int> &dimensionIds );
     bool hasDimension( const std::string &name ) const;
 
+    /**
+     * Creates new file, netCDF-4 file when compression is enabled (see compressionLevel()),
+     * otherwise (or when the library does not support netCDF-4) classic netCDF file
+     */
     void createFile( const std::string &fileName );
+
+    //! Returns whether the file has netCDF-4 format, i.e. its variables can be chunked and compressed
+    bool isNetCDF4() const;
+
+    /**
+     * Sets chunking and compression of the variable in netCDF-4 file, see compressionLevel() and shuffle()
+     * Does nothing for classic netCDF files or when the compression is disabled. Must be called in define mode
+     * \param chunkSizes size of the chunk for each dimension of the variable
+     */
+    void defineVarCompression( int varId, const std::vector<size_t> &chunkSizes );
     int defineDimension( const std::string &name, size_t size );
     int defineVar( const std::string &varName, int ncType, int dimensionCount, const int *dimensions );
     void putAttrStr( int varId, const std::string &attrName, const std::string &value );
@@ -87,10 +136,43 @@ class NetCDFFile
     void putDataDouble( int varId, const size_t index, const double value );
     void putDataArrayDouble( int varId, const size_t index, const std::vector<double> &values );
     void putDataArrayInt( int varId, size_t line, size_t faceVerticesMax, int *values );
+    //! Writes \a lineCount lines with \a faceVerticesMax values of 2D int variable
+    void putDataArrayInt( int varId, size_t line, size_t lineCount, size_t faceVerticesMax, const int *values );
+    //! Writes \a count values of 1D double variable starting with \a start
+    void putDataDoubleArr( int varId, size_t start, size_t count, const double *values );
 
     std::string getFileName() const;
 
+    /**
+     * Returns maximum size of the chunk cache of one variable in bytes set when a file is opened for reading,
+     * 0 means the default cache of the netCDF library is used. Default is 32 MB, it can be also set
+     * by environment variable MDAL_NETCDF_CHUNK_CACHE_MB (in megabytes)
+     */
+    static size_t chunkCacheBudget();
+    static void setChunkCacheBudget( size_t bytes );
+
+    /**
+     * Returns deflate level (1-9) of variables written to new files, 0 means files are written
+     * uncompressed in classic netCDF format. Default is 0, it can be also set
+     * by environment variable MDAL_NETCDF_DEFLATE_LEVEL
+     */
+    static int compressionLevel();
+
+    /**
+     * Returns whether shuffle filter is used with the compression. Default is true,
+     * it can be also set by environment variable MDAL_NETCDF_SHUFFLE (0 or 1)
+     */
+    static bool shuffle();
+
+    static void setCompression( int level, bool shuffle );
+
   private:
+    /**
+     * Sizes the chunk cache of chunked (netCDF-4) variables, so reading of a whole timestep slice
+     * or of a time series of one element does not decompress the same chunks repeatedly
+     */
+    void tuneChunkCaches();
+
     int mNcid; // C handle to the file
     std::string mFileName;
 };
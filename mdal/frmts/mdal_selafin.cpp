@@ -16,14 +16,72 @@
 #include <cassert>
 #include <memory>
 #include <algorithm>
+#include <stdint.h>
 
 #include "mdal_selafin.hpp"
 #include "mdal.h"
 #include "mdal_utils.hpp"
 #include <math.h>
 #include "mdal_logger.hpp"
+#include "mdal_block_cache.hpp"
 
-#define BUFFER_SIZE 2000
+//! Number of faces or values read from the mesh or dataset at once when the file is written
+#define BUFFER_SIZE 65536
+//! Size of the output buffer of SelafinWriter in bytes
+#define WRITE_BUFFER_SIZE ( 4 * 1024 * 1024 )
+
+static inline uint32_t _byteSwap( uint32_t v )
+{
+  return ( v >> 24 ) | ( ( v >> 8 ) & 0x0000FF00u ) | ( ( v << 8 ) & 0x00FF0000u ) | ( v << 24 );
+}
+
+static inline uint64_t _byteSwap( uint64_t v )
+{
+  return ( static_cast<uint64_t>( _byteSwap( static_cast<uint32_t>( v ) ) ) << 32 ) | _byteSwap( static_cast<uint32_t>( v >> 32 ) );
+}
+
+//! Unsigned integer of the same size as T, used to swap bytes of values of T
+template<typename T> struct _Bits;
+template<> struct _Bits<float> { typedef uint32_t Type; };
+template<> struct _Bits<double> { typedef uint64_t Type; };
+template<> struct _Bits<int32_t> { typedef uint32_t Type; };
+
+/**
+ * Decodes \a count values of type T stored in \a source and writes value i to buffer[i * stride]
+ * The loops are simple enough to be vectorized by compilers, large arrays are split between threads
+ */
+template<typename T, typename Out>
+static void _decodeValues( const char *source, size_t count, bool changeEndianness, Out *buffer, size_t stride )
+{
+  typedef typename _Bits<T>::Type Bits;
+
+  MDAL::parallelFor( count, 1 << 16, [ = ]( size_t begin, size_t end )
+  {
+    const char *input = source + begin * sizeof( T );
+    Out *output = buffer + begin * stride;
+    if ( changeEndianness )
+    {
+      for ( size_t i = 0; i < end - begin; ++i )
+      {
+        Bits bits;
+        memcpy( &bits, input + i * sizeof( T ), sizeof( T ) );
+        bits = _byteSwap( bits );
+        T value;
+        memcpy( &value, &bits, sizeof( T ) );
+        output[i * stride] = static_cast<Out>( value );
+      }
+    }
+    else
+    {
+      for ( size_t i = 0; i < end - begin; ++i )
+      {
+        T value;
+        memcpy( &value, input + i * sizeof( T ), sizeof( T ) );
+        output[i * stride] = static_cast<Out>( value );
+      }
+    }
+  } );
+}
 
 // //////////////////////////////
 // SelafinFile
@@ -39,21 +97,20 @@ void MDAL::SelafinFile::initialize()
   {
     throw MDAL::Error( MDAL_Status::Err_FileNotFound, "Did not find file " + mFileName );
   }
-  mIn = MDAL::openInputFile( mFileName, std::ios_base::in | std::ios_base::binary );
-  if ( !mIn )
+  mFile.reset( new MemoryMappedFile( mFileName ) );
+  mPosition = 0;
+  if ( !mFile->isValid() )
+  {
+    mFile.reset();
     throw MDAL::Error( MDAL_Status::Err_FileNotFound, "File " + mFileName + " could not be open" ); // Couldn't open the file
-
-  // get length of file:
-  mIn.seekg( 0, mIn.end );
-  mFileSize = mIn.tellg();
-  mIn.seekg( 0, mIn.beg );
+  }
 
   mChangeEndianness = MDAL::isNativeLittleEndian();
 
   //Check if need to change the endianness
   // read first size_t that has to be 80
   size_t firstInt = readSizeT();
-  mIn.seekg( 0, mIn.beg );
+  mPosition = 0;
   if ( firstInt != 80 )
   {
     mChangeEndianness = !mChangeEndianness;
@@ -61,7 +118,7 @@ void MDAL::SelafinFile::initialize()
     firstInt = readSizeT();
     if ( firstInt != 80 )
       throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File " + mFileName + " could not be open" );
-    mIn.seekg( 0, mIn.beg );
+    mPosition = 0;
   }
 
   mParsed = false;
@@ -188,24 +245,80 @@ void MDAL::SelafinFile::parseFile()
   */
 
   size_t realSize = mStreamInFloatPrecision ? 4 : 8;
-  size_t nTimesteps = remainingBytes() / ( 8 + realSize + ( 4 + ( mVerticesCount ) * realSize + 4 ) * mVariableNames.size() );
-  mVariableStreamPosition.resize( mVariableNames.size(), std::vector<std::streampos>( nTimesteps ) );
+  const size_t frameSize = 8 + realSize + ( 4 + ( mVerticesCount ) * realSize + 4 ) * mVariableNames.size();
+  size_t nTimesteps = remainingBytes() / frameSize;
+  mVariableStreamPosition.assign( mVariableNames.size(), std::vector<size_t>( nTimesteps ) );
   mTimeSteps.resize( nTimesteps );
-  for ( size_t nT = 0; nT < nTimesteps; ++nT )
+
+  // records are usually of the same size, otherwise they are passed one by one
+  if ( !indexTimesteps( nTimesteps, frameSize ) )
   {
-    std::vector<double> times = readDoubleArr( 1 );
-    mTimeSteps[nT] = RelativeTimestamp( times[0], RelativeTimestamp::seconds );
-    for ( size_t i = 0; i < mVariableNames.size(); ++i )
+    for ( size_t nT = 0; nT < nTimesteps; ++nT )
     {
-      if ( ! checkDoubleArraySize( mVerticesCount ) )
-        throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading dataset values" );
-      mVariableStreamPosition[i][nT] = passThroughDoubleArray( mVerticesCount );
+      std::vector<double> times = readDoubleArr( 1 );
+      mTimeSteps[nT] = RelativeTimestamp( times[0], RelativeTimestamp::seconds );
+      for ( size_t i = 0; i < mVariableNames.size(); ++i )
+      {
+        if ( ! checkDoubleArraySize( mVerticesCount ) )
+          throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading dataset values" );
+        mVariableStreamPosition[i][nT] = passThroughDoubleArray( mVerticesCount );
+      }
     }
   }
 
   mParsed = true;
 }
 
+bool MDAL::SelafinFile::indexTimesteps( size_t timestepsCount, size_t frameSize )
+{
+  if ( timestepsCount == 0 )
+    return true;
+
+  const size_t realSize = mStreamInFloatPrecision ? 4 : 8;
+  const size_t valuesSize = mVerticesCount * realSize;
+  const size_t firstFrame = mPosition;
+
+  for ( size_t nT : {size_t( 0 ), timestepsCount - 1} )
+  {
+    size_t position = firstFrame + nT * frameSize;
+    if ( !checkRecord( position, realSize ) )
+      return false;
+    position += 8 + realSize;
+
+    for ( size_t i = 0; i < mVariableNames.size(); ++i )
+    {
+      if ( !checkRecord( position, valuesSize ) )
+        return false;
+      position += 8 + valuesSize;
+    }
+  }
+
+  for ( size_t nT = 0; nT < timestepsCount; ++nT )
+  {
+    const size_t frame = firstFrame + nT * frameSize;
+    double time = 0;
+    if ( !readDoubleArr( frame + 4, 0, 1, &time ) )
+      return false;
+    mTimeSteps[nT] = RelativeTimestamp( time, RelativeTimestamp::seconds );
+
+    for ( size_t i = 0; i < mVariableNames.size(); ++i )
+      mVariableStreamPosition[i][nT] = frame + 8 + realSize + i * ( 8 + valuesSize ) + 4;
+  }
+
+  mPosition = firstFrame + timestepsCount * frameSize;
+  return true;
+}
+
+bool MDAL::SelafinFile::checkRecord( size_t position, size_t len ) const
+{
+  int leading = 0;
+  int trailing = 0;
+  return readIntArr( position, 0, 1, &leading ) &&
+         readIntArr( position + 4 + len, 0, 1, &trailing ) &&
+         static_cast<size_t>( leading ) == len &&
+         static_cast<size_t>( trailing ) == len;
+}
+
 std::string MDAL::SelafinFile::readHeader()
 {
   initialize();
@@ -219,27 +332,31 @@ std::string MDAL::SelafinFile::readHeader()
   return header;
 }
 
-std::vector<int> MDAL::SelafinFile::connectivityIndex( size_t offset, size_t count )
+bool MDAL::SelafinFile::connectivityIndex( size_t offset, size_t count, int *buffer )
 {
-  return readIntArr( mConnectivityStreamPosition, offset, count );
+  return readIntArr( mConnectivityStreamPosition, offset, count, buffer );
 }
 
-std::vector<double> MDAL::SelafinFile::vertices( size_t offset, size_t count )
+bool MDAL::SelafinFile::vertices( size_t offset, size_t count, double *coordinates )
 {
-  std::vector<double> xValues = readDoubleArr( mXStreamPosition, offset, count );
-  std::vector<double> yValues = readDoubleArr( mYStreamPosition, offset, count );
-
-  if ( xValues.size() != count || yValues.size() != count )
-    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading vertices" );
+  if ( !readDoubleArr( mXStreamPosition, offset, count, coordinates, 3 ) ||
+       !readDoubleArr( mYStreamPosition, offset, count, coordinates + 1, 3 ) )
+    return false;
 
-  std::vector<double> coordinates( count * 3 );
   for ( size_t i = 0; i < count; ++i )
   {
-    coordinates[i * 3] = xValues.at( i ) + mXOrigin;
-    coordinates[i * 3 + 1] = yValues.at( i ) + mYOrigin;
+    coordinates[i * 3] += mXOrigin;
+    coordinates[i * 3 + 1] += mYOrigin;
     coordinates[i * 3 + 2] = 0;
   }
-  return coordinates;
+  return true;
+}
+
+void MDAL::SelafinFile::close()
+{
+  mFile.reset();
+  mPosition = 0;
+  mParsed = false;
 }
 
 std::unique_ptr<MDAL::Mesh> MDAL::SelafinFile::createMesh( const std::string &fileName )
@@ -287,14 +404,30 @@ size_t MDAL::SelafinFile::verticesPerFace()
   return mVerticesPerFace;
 }
 
-std::vector<double> MDAL::SelafinFile::datasetValues( size_t timeStepIndex, size_t variableIndex, size_t offset, size_t count )
+bool MDAL::SelafinFile::datasetValues( size_t timeStepIndex, size_t variableIndex, size_t offset, size_t count, double *buffer, size_t stride )
 {
   if ( !mParsed )
     parseFile();
   if ( variableIndex < mVariableStreamPosition.size() &&  timeStepIndex < mVariableStreamPosition[variableIndex].size() )
-    return readDoubleArr( mVariableStreamPosition[variableIndex][timeStepIndex], offset, count );
+    return readDoubleArr( mVariableStreamPosition[variableIndex][timeStepIndex], offset, count, buffer, stride );
   else
-    return std::vector<double>();
+    return false;
+}
+
+bool MDAL::SelafinFile::timeSeriesValues( size_t timeStepIndex, size_t count, size_t variableIndex, size_t offset, double *buffer, size_t stride )
+{
+  if ( !mParsed )
+    parseFile();
+  if ( variableIndex >= mVariableStreamPosition.size() || timeStepIndex + count > mVariableStreamPosition[variableIndex].size() )
+    return false;
+
+  // positions of the arrays are known, only one value is read from each time step
+  for ( size_t i = 0; i < count; ++i )
+  {
+    if ( !readDoubleArr( mVariableStreamPosition[variableIndex][timeStepIndex + i], offset, 1, buffer + i * stride ) )
+      return false;
+  }
+  return true;
 }
 
 void MDAL::SelafinFile::populateDataset( MDAL::Mesh *mesh, std::shared_ptr<MDAL::SelafinFile> reader )
@@ -396,13 +529,9 @@ void MDAL::SelafinFile::populateDataset( MDAL::Mesh *mesh, std::shared_ptr<MDAL:
   for ( const std::shared_ptr<DatasetGroup> &group : groupsInOrder )
   {
     for ( const std::shared_ptr<Dataset> &dataset : group->datasets )
-    {
-      MDAL::Statistics stats = MDAL::calculateStatistics( dataset );
-      dataset->setStatistics( stats );
-    }
+      MDAL::updateStatistics( dataset );
 
-    MDAL::Statistics stats = MDAL::calculateStatistics( group );
-    group->setStatistics( stats );
+    MDAL::updateStatistics( group );
   }
 
   // As everything seems to be ok (no exception thrown), push the groups in the mesh
@@ -421,73 +550,62 @@ std::string MDAL::SelafinFile::readString( size_t len )
 
 std::vector<double> MDAL::SelafinFile::readDoubleArr( size_t len )
 {
-  size_t length = readSizeT();
-  if ( mStreamInFloatPrecision )
-  {
-    if ( length != len * 4 )
-      throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading double array" );
-  }
-  else
-  {
-    if ( length != len * 8 )
-      throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading double array" );
-  }
+  if ( !checkDoubleArraySize( len ) )
+    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading double array" );
+
   std::vector<double> ret( len );
-  for ( size_t i = 0; i < len; ++i )
-  {
-    ret[i] = readDouble();
-  }
-  ignoreArrayLength();
+  const size_t position = passThroughDoubleArray( len );
+  readDoubleArr( position, 0, len, ret.data() );
   return ret;
 }
 
-std::vector<double> MDAL::SelafinFile::readDoubleArr( const std::streampos &position, size_t offset, size_t len )
+bool MDAL::SelafinFile::readDoubleArr( size_t position, size_t offset, size_t len, double *buffer, size_t stride ) const
 {
-  std::vector<double> ret( len );
-  std::streamoff off;
+  const size_t realSize = mStreamInFloatPrecision ? 4 : 8;
+  if ( !mFile || position > mFile->size() || ( mFile->size() - position ) / realSize < offset + len )
+    return false;
+
+  const char *source = mFile->data() + position + offset * realSize;
   if ( mStreamInFloatPrecision )
-    off = offset * 4;
+    _decodeValues<float>( source, len, mChangeEndianness, buffer, stride );
   else
-    off = offset * 8;
-
-  mIn.seekg( position + off );
-  for ( size_t i = 0; i < len; ++i )
-    ret[i] = readDouble();
-
-  return ret;
+    _decodeValues<double>( source, len, mChangeEndianness, buffer, stride );
+  return true;
 }
 
 std::vector<int> MDAL::SelafinFile::readIntArr( size_t len )
 {
-  size_t length = readSizeT();
-  if ( length != len * 4 ) throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading int array" );
+  if ( !checkIntArraySize( len ) )
+    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading int array" );
+
   std::vector<int> ret( len );
-  for ( size_t i = 0; i < len; ++i )
-  {
-    ret[i] = readInt();
-  }
-  ignoreArrayLength();
+  const size_t position = passThroughIntArray( len );
+  readIntArr( position, 0, len, ret.data() );
   return ret;
 }
 
-std::vector<int> MDAL::SelafinFile::readIntArr( const std::streampos &position, size_t offset, size_t len )
+bool MDAL::SelafinFile::readIntArr( size_t position, size_t offset, size_t len, int *buffer ) const
 {
-  std::vector<int> ret( len );
-  std::streamoff off = offset * 4;
+  if ( !mFile || position > mFile->size() || ( mFile->size() - position ) / 4 < offset + len )
+    return false;
 
-  mIn.seekg( position + off );
-  for ( size_t i = 0; i < len; ++i )
-    ret[i] = readInt();
+  _decodeValues<int32_t>( mFile->data() + position + offset * 4, len, mChangeEndianness, buffer, 1 );
+  return true;
+}
 
+const char *MDAL::SelafinFile::readBytes( size_t len )
+{
+  if ( !mFile || mFile->size() - mPosition < len )
+    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Unexpected end of file " + mFileName );
+
+  const char *ret = mFile->data() + mPosition;
+  mPosition += len;
   return ret;
 }
 
 std::string MDAL::SelafinFile::readStringWithoutLength( size_t len )
 {
-  std::vector<char> ptr( len );
-  mIn.read( ptr.data(), static_cast<int>( len ) );
-  if ( !mIn )
-    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Unable to open stream for reading string without length" );
+  const char *ptr = readBytes( len );
 
   size_t str_length = 0;
   for ( size_t i = len; i > 0; --i )
@@ -498,45 +616,24 @@ std::string MDAL::SelafinFile::readStringWithoutLength( size_t len )
       break;
     }
   }
-  std::string ret( ptr.data(), str_length );
+  std::string ret( ptr, str_length );
   return ret;
 }
 
 double MDAL::SelafinFile::readDouble( )
 {
   double ret;
-
   if ( mStreamInFloatPrecision )
-  {
-    float ret_f;
-    if ( !readValue( ret_f, mIn, mChangeEndianness ) )
-      throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Reading double failed" );
-    ret = static_cast<double>( ret_f );
-  }
+    _decodeValues<float>( readBytes( 4 ), 1, mChangeEndianness, &ret, 1 );
   else
-  {
-    if ( !readValue( ret, mIn, mChangeEndianness ) )
-      throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Reading double failed" );
-  }
+    _decodeValues<double>( readBytes( 8 ), 1, mChangeEndianness, &ret, 1 );
   return ret;
 }
 
-
 int MDAL::SelafinFile::readInt( )
 {
-  unsigned char data[4];
-
-  if ( mIn.read( reinterpret_cast< char * >( &data ), 4 ) )
-    if ( !mIn )
-      throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Unable to open stream for reading int" );
-  if ( mChangeEndianness )
-  {
-    std::reverse( reinterpret_cast< char * >( &data ), reinterpret_cast< char * >( &data ) + 4 );
-  }
   int var;
-  memcpy( reinterpret_cast< char * >( &var ),
-          reinterpret_cast< char * >( &data ),
-          4 );
+  _decodeValues<int32_t>( readBytes( 4 ), 1, mChangeEndianness, &var, 1 );
   return var;
 }
 
@@ -565,37 +662,35 @@ bool MDAL::SelafinFile::checkDoubleArraySize( size_t len )
 
 size_t MDAL::SelafinFile::remainingBytes()
 {
-  if ( mIn.eof() )
+  if ( !mFile )
     return 0;
-  return static_cast<size_t>( mFileSize - mIn.tellg() );
+  return mFile->size() - mPosition;
 }
 
-std::streampos MDAL::SelafinFile::passThroughIntArray( size_t size )
+size_t MDAL::SelafinFile::passThroughIntArray( size_t size )
 {
-  std::streampos pos = mIn.tellg();
-  mIn.seekg( size * 4, std::ios_base::cur );
+  size_t pos = mPosition;
+  ignore( size * 4 );
   ignoreArrayLength();
   return pos;
 }
 
-std::streampos MDAL::SelafinFile::passThroughDoubleArray( size_t size )
+size_t MDAL::SelafinFile::passThroughDoubleArray( size_t size )
 {
-  std::streampos pos = mIn.tellg();
+  size_t pos = mPosition;
   if ( mStreamInFloatPrecision )
     size *= 4;
   else
     size *= 8;
 
-  mIn.seekg( size, std::ios_base::cur );
+  ignore( size );
   ignoreArrayLength();
   return pos;
 }
 
-void MDAL::SelafinFile::ignore( int len )
+void MDAL::SelafinFile::ignore( size_t len )
 {
-  mIn.ignore( len );
-  if ( !mIn )
-    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "Unable to ignore characters (invalid stream)" );
+  readBytes( len );
 }
 
 void MDAL::SelafinFile::ignoreArrayLength( )
@@ -770,10 +865,7 @@ MDAL::BBox MDAL::MeshSelafin::extent() const
 void MDAL::MeshSelafin::closeSource()
 {
   if ( mReader )
-  {
-    mReader->mIn.close();
-    mReader->mParsed = false;
-  }
+    mReader->close();
 }
 
 void MDAL::MeshSelafin::calculateExtent() const
@@ -815,9 +907,8 @@ size_t MDAL::MeshSelafinVertexIterator::next( size_t vertexCount, double *coordi
   if ( count == 0 )
     return 0;
 
-  std::vector<double> coord = mReader->vertices( mPosition, count );
-
-  memcpy( coordinates, coord.data(), count * 24 );
+  if ( !mReader->vertices( mPosition, count, coordinates ) )
+    throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading vertices" );
 
   mPosition += count;
 
@@ -842,9 +933,8 @@ size_t MDAL::MeshSelafinFaceIterator::next( size_t faceOffsetsBufferLen, int *fa
   if ( count == 0 )
     return 0;
 
-  std::vector<int> indexes = mReader->connectivityIndex( mPosition * verticesPerFace, count * verticesPerFace );
-
-  if ( indexes.size() != count * verticesPerFace )
+  std::vector<int> indexes( count * verticesPerFace );
+  if ( !mReader->connectivityIndex( mPosition * verticesPerFace, count * verticesPerFace, indexes.data() ) )
     throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading faces" );
 
   int vertexLocalIndex = 0;
@@ -876,33 +966,67 @@ MDAL::DatasetSelafin::DatasetSelafin( MDAL::DatasetGroup *parent,
 }
 
 size_t MDAL::DatasetSelafin::scalarData( size_t indexStart, size_t count, double *buffer )
+{
+  return MDAL::BlockCache::read( this, mReader->verticesCount(), 1, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readScalarData( start, n, values ); } );
+}
+
+size_t MDAL::DatasetSelafin::vectorData( size_t indexStart, size_t count, double *buffer )
+{
+  return MDAL::BlockCache::read( this, mReader->verticesCount(), 2, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readVectorData( start, n, values ); } );
+}
+
+size_t MDAL::DatasetSelafin::readScalarData( size_t indexStart, size_t count, double *buffer )
 {
   count = std::min( mReader->verticesCount() - indexStart, count );
-  std::vector<double> values = mReader->datasetValues( mTimeStepIndex, mXVariableIndex, indexStart, count );
-  if ( values.size() != count )
+  if ( !mReader->datasetValues( mTimeStepIndex, mXVariableIndex, indexStart, count, buffer ) )
     throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading dataset value" );
 
-  memcpy( buffer, values.data(), count * 8 );
-
   return count;
 }
 
-size_t MDAL::DatasetSelafin::vectorData( size_t indexStart, size_t count, double *buffer )
+size_t MDAL::DatasetSelafin::readVectorData( size_t indexStart, size_t count, double *buffer )
 {
   count = std::min( mReader->verticesCount() - indexStart, count );
-  std::vector<double> xValues = mReader->datasetValues( mTimeStepIndex, mXVariableIndex, indexStart, count );
-  std::vector<double> yValues = mReader->datasetValues( mTimeStepIndex, mYVariableIndex, indexStart, count );
-
-  if ( xValues.size() != count  || yValues.size() != count )
+  if ( !mReader->datasetValues( mTimeStepIndex, mXVariableIndex, indexStart, count, buffer, 2 ) ||
+       !mReader->datasetValues( mTimeStepIndex, mYVariableIndex, indexStart, count, buffer + 1, 2 ) )
     throw MDAL::Error( MDAL_Status::Err_UnknownFormat, "File format problem while reading dataset value" );
 
-  for ( size_t i = 0; i < count; ++i )
+  return count;
+}
+
+bool MDAL::DatasetSelafin::timeSeriesData( const size_t *elementIndexes, size_t elementCount, size_t datasetCount, double *buffer )
+{
+  const size_t index = indexInGroup();
+  const Datasets &datasets = group()->datasets;
+  if ( index + datasetCount > datasets.size() )
+    return false;
+
+  for ( size_t i = 1; i < datasetCount; ++i )
   {
-    buffer[2 * i] = xValues[i];
-    buffer[2 * i + 1] = yValues[i];
+    const DatasetSelafin *dataset = dynamic_cast<const DatasetSelafin *>( datasets[index + i].get() );
+    if ( !dataset || dataset->mReader != mReader || dataset->mTimeStepIndex != mTimeStepIndex + i ||
+         dataset->mXVariableIndex != mXVariableIndex || dataset->mYVariableIndex != mYVariableIndex )
+      return false;
   }
 
-  return count;
+  const bool isScalar = group()->isScalar();
+  for ( size_t e = 0; e < elementCount; ++e )
+  {
+    if ( isScalar )
+    {
+      if ( !mReader->timeSeriesValues( mTimeStepIndex, datasetCount, mXVariableIndex, elementIndexes[e], buffer + e * datasetCount ) )
+        return false;
+      continue;
+    }
+
+    double *target = buffer + 2 * e * datasetCount;
+    if ( !mReader->timeSeriesValues( mTimeStepIndex, datasetCount, mXVariableIndex, elementIndexes[e], target, 2 ) ||
+         !mReader->timeSeriesValues( mTimeStepIndex, datasetCount, mYVariableIndex, elementIndexes[e], target + 1, 2 ) )
+      return false;
+  }
+  return true;
 }
 
 void MDAL::DatasetSelafin::setXVariableIndex( size_t index )
@@ -915,90 +1039,171 @@ void MDAL::DatasetSelafin::setYVariableIndex( size_t index )
   mYVariableIndex = index;
 }
 
-template<typename T>
-static void writeValue( std::ofstream &file, T value )
+//! Encodes \a count values values[i * stride] as T to \a output, see _decodeValues()
+template<typename T, typename In>
+static void _encodeValues( const In *values, size_t count, size_t stride, bool changeEndianness, char *output )
 {
-  bool isNativeLittleEndian = MDAL::isNativeLittleEndian();
-  MDAL::writeValue( value, file, isNativeLittleEndian );
-}
+  typedef typename _Bits<T>::Type Bits;
 
-static void writeInt( std::ofstream &file, int i )
-{
-  bool isNativeLittleEndian = MDAL::isNativeLittleEndian();
-  MDAL::writeValue( i, file, isNativeLittleEndian );
+  MDAL::parallelFor( count, 1 << 16, [ = ]( size_t begin, size_t end )
+  {
+    const In *input = values + begin * stride;
+    char *out = output + begin * sizeof( T );
+    for ( size_t i = 0; i < end - begin; ++i )
+    {
+      const T value = static_cast<T>( input[i * stride] );
+      Bits bits;
+      memcpy( &bits, &value, sizeof( T ) );
+      if ( changeEndianness )
+        bits = _byteSwap( bits );
+      memcpy( out + i * sizeof( T ), &bits, sizeof( T ) );
+    }
+  } );
 }
 
-static void writeStringRecord( std::ofstream &file, const std::string &str )
+/**
+ * Buffered writer of Selafin records
+ *
+ * Values are converted and written in the byte order of Selafin files (big endian)
+ * to a large buffer, the buffer is written to the file when it is full
+ */
+class SelafinWriter
 {
-  writeInt( file, MDAL::toInt( str.size() ) );
-  file.write( str.data(), str.size() );
-  writeInt( file, MDAL::toInt( str.size() ) );
-}
+  public:
+    explicit SelafinWriter( std::ofstream &file )
+      : mFile( file )
+      , mChangeEndianness( MDAL::isNativeLittleEndian() )
+      , mBuffer( WRITE_BUFFER_SIZE )
+    {}
+
+    ~SelafinWriter()
+    {
+      flush();
+    }
 
-template<typename T>
-static void writeValueArrayRecord( std::ofstream &file, const std::vector<T> &array )
-{
-  writeValue( file, int( array.size()*sizeof( T ) ) );
-  for ( const T value : array )
-    writeValue( file, value );
-  writeValue( file, int( array.size()*sizeof( T ) ) );
-}
+    //! Writes \a count values values[i * stride] as T
+    template<typename T, typename In>
+    void writeValues( const In *values, size_t count, size_t stride = 1 )
+    {
+      while ( count > 0 )
+      {
+        const size_t n = std::min( count, ( mBuffer.size() - mUsed ) / sizeof( T ) );
+        if ( n == 0 )
+        {
+          flush();
+          continue;
+        }
+        _encodeValues<T>( values, n, stride, mChangeEndianness, mBuffer.data() + mUsed );
+        mUsed += n * sizeof( T );
+        values += n * stride;
+        count -= n;
+      }
+    }
 
-template<typename T>
-static void writeValueArray( std::ofstream &file, const std::vector<T> &array )
-{
-  for ( const T value : array )
-    writeValue( file, value );
-}
+    void writeInt( int value )
+    {
+      writeValues<int32_t>( &value, 1 );
+    }
 
+    //! Writes the array as a record, with its size before and after the values
+    template<typename T>
+    void writeRecord( const std::vector<T> &array )
+    {
+      writeInt( MDAL::toInt( array.size() * sizeof( T ) ) );
+      writeValues<T>( array.data(), array.size() );
+      writeInt( MDAL::toInt( array.size() * sizeof( T ) ) );
+    }
+
+    void writeStringRecord( const std::string &str )
+    {
+      writeInt( MDAL::toInt( str.size() ) );
+      writeBytes( str.data(), str.size() );
+      writeInt( MDAL::toInt( str.size() ) );
+    }
+
+    //! Writes raw bytes, e.g. a record copied from another file
+    void writeBytes( const char *data, size_t len )
+    {
+      if ( len > mBuffer.size() - mUsed )
+        flush();
+
+      if ( len >= mBuffer.size() )
+      {
+        mFile.write( data, static_cast<std::streamsize>( len ) );
+        return;
+      }
+      memcpy( mBuffer.data() + mUsed, data, len );
+      mUsed += len;
+    }
+
+    void writeZeros( size_t len )
+    {
+      while ( len > 0 )
+      {
+        if ( mUsed == mBuffer.size() )
+          flush();
+        const size_t n = std::min( len, mBuffer.size() - mUsed );
+        memset( mBuffer.data() + mUsed, 0, n );
+        mUsed += n;
+        len -= n;
+      }
+    }
+
+    void flush()
+    {
+      if ( mUsed > 0 )
+        mFile.write( mBuffer.data(), static_cast<std::streamsize>( mUsed ) );
+      mUsed = 0;
+    }
+
+  private:
+    std::ofstream &mFile;
+    bool mChangeEndianness;
+    std::vector<char> mBuffer;
+    size_t mUsed = 0;
+};
+
+//! Writes the record of one coordinate (0 for x, 1 for y) of the vertices of the mesh
 template<typename T>
-static void writeVertices( std::ofstream &file, MDAL::Mesh *mesh )
+static void writeVertexCoordinates( SelafinWriter &writer, MDAL::Mesh *mesh, size_t coordinate )
 {
   std::unique_ptr<MDAL::MeshVertexIterator> vertexIter = mesh->readVertices();
-  size_t verticesCount = mesh->verticesCount();
-  std::vector<T> xValues( verticesCount );
-  std::vector<T> yValues( verticesCount );
+  const size_t verticesCount = mesh->verticesCount();
+  writer.writeInt( MDAL::toInt( verticesCount * sizeof( T ) ) );
+  std::vector<double> coordinates( BUFFER_SIZE * 3 );
   size_t count = 0;
-  size_t vertexIndex = 0;
-  size_t bufferSize = BUFFER_SIZE;
   do
   {
-    std::vector<double> coordinates( bufferSize * 3 );
-    count = vertexIter->next( bufferSize, coordinates.data() );
-    for ( size_t i = 0; i < count; ++i )
-    {
-      xValues[vertexIndex + i] = coordinates[i * 3];
-      yValues[vertexIndex + i] = coordinates[i * 3 + 1];
-    }
-    vertexIndex += count;
+    count = vertexIter->next( BUFFER_SIZE, coordinates.data() );
+    writer.writeValues<T>( coordinates.data() + coordinate, count, 3 );
   }
   while ( count != 0 );
-  writeValueArrayRecord( file, xValues );
-  writeValueArrayRecord( file, yValues );
+  writer.writeInt( MDAL::toInt( verticesCount * sizeof( T ) ) );
 }
 
 void MDAL::DriverSelafin::save( const std::string &fileName, const std::string &, MDAL::Mesh *mesh )
 {
   std::ofstream file = MDAL::openOutputFile( fileName.c_str(), std::ofstream::binary );
+  SelafinWriter writer( file );
 
   std::string header( "Selafin file created by MDAL library" );
   std::string remainingStr( 72 - header.size(), ' ' );
   header.append( remainingStr );
   header.append( "SERAFIND" );
   assert( header.size() == 80 );
-  writeStringRecord( file, header );
+  writer.writeStringRecord( header );
 
 // NBV(1) NBV(2) size
   std::vector<int> nbvSize( 2 );
   nbvSize[0] = 0;
   nbvSize[1] = 0;
-  writeValueArrayRecord( file, nbvSize );
+  writer.writeRecord( nbvSize );
 
   //don't write variable name
 
   //parameter table, all values are 0
   std::vector<int> param( 10, 0 );
-  writeValueArrayRecord( file, param );
+  writer.writeRecord( param );
 
   //NELEM,NPOIN,NDP,1
   size_t verticesPerFace = mesh->faceVerticesMaximumCount();
@@ -1009,36 +1214,39 @@ void MDAL::DriverSelafin::save( const std::string &fileName, const std::string &
   elem[1] = MDAL::toInt( verticesCount );
   elem[2] = MDAL::toInt( verticesPerFace );
   elem[3] = 1;
-  writeValueArrayRecord( file, elem );
+  writer.writeRecord( elem );
 
   //connectivity table
-  int bufferSize = BUFFER_SIZE;
+  size_t bufferSize = BUFFER_SIZE;
   std::vector<int> faceOffsetBuffer( bufferSize );
+  std::vector<int> inkle( bufferSize * verticesPerFace );
   std::unique_ptr<MeshFaceIterator> faceIter = mesh->readFaces();
   size_t count = 0;
-  writeInt( file, MDAL::toInt( facesCount * verticesPerFace * 4 ) );
+  writer.writeInt( MDAL::toInt( facesCount * verticesPerFace * 4 ) );
   if ( facesCount > 0 )
   {
     do
     {
-      std::vector<int> inkle( bufferSize * verticesPerFace );
       count = faceIter->next( bufferSize, faceOffsetBuffer.data(), bufferSize * verticesPerFace, inkle.data() );
-      inkle.resize( count * verticesPerFace );
-      for ( size_t i = 0; i < inkle.size(); ++i )
+      for ( size_t i = 0; i < count * verticesPerFace; ++i )
         inkle[i]++;
 
-      writeValueArray( file, inkle );
+      writer.writeValues<int32_t>( inkle.data(), count * verticesPerFace );
     }
     while ( count != 0 );
   }
-  writeInt( file, MDAL::toInt( facesCount * verticesPerFace * 4 ) );
+  writer.writeInt( MDAL::toInt( facesCount * verticesPerFace * 4 ) );
 
   // IPOBO filled with 0
-  writeValueArrayRecord( file, std::vector<int>( verticesCount, 0 ) );
+  writer.writeInt( MDAL::toInt( verticesCount * 4 ) );
+  writer.writeZeros( verticesCount * 4 );
+  writer.writeInt( MDAL::toInt( verticesCount * 4 ) );
 
   //Vertices
-  writeVertices<double>( file, mesh );
+  writeVertexCoordinates<double>( writer, mesh, 0 );
+  writeVertexCoordinates<double>( writer, mesh, 1 );
 
+  writer.flush();
   file.close();
 }
 
@@ -1052,92 +1260,51 @@ std::string MDAL::DriverSelafin::saveMeshOnFileSuffix() const
   return "slf";
 }
 
-// return false if fails
-static void streamToStream( std::ostream &destination,
-                            std::ifstream &source,
-                            std::streampos sourceStartPosition,
-                            std::streamoff len,
-                            std::streamoff maxBufferSize )
-{
-  assert( maxBufferSize != 0 );
-  std::streampos position = sourceStartPosition;
-  source.seekg( 0, source.end );
-  std::streampos end = std::min( source.tellg(), sourceStartPosition + len );
-  source.seekg( sourceStartPosition );
-
-  while ( position < end )
-  {
-    size_t bufferSize = std::min( maxBufferSize, end - position );
-    std::vector<char> buffer( bufferSize );
-    source.read( &buffer[0], bufferSize );
-    destination.write( &buffer[0], bufferSize );
-    position += bufferSize;
-  }
-}
-
-static void writeScalarDataset( std::ofstream &file, MDAL::Dataset *dataset, bool isFloat )
+//! Writes the record of values of the scalar dataset, values are read in blocks
+template<typename T>
+static void writeScalarDataset( SelafinWriter &writer, MDAL::Dataset *dataset )
 {
   size_t valuesCount = dataset->valuesCount();
-  size_t bufferSize = BUFFER_SIZE;
   size_t count = 0;
   size_t indexStart = 0;
-  writeInt( file, MDAL::toInt( valuesCount * ( isFloat ? 4 : 8 ) ) );
+  std::vector<double> values( BUFFER_SIZE );
+  writer.writeInt( MDAL::toInt( valuesCount * sizeof( T ) ) );
   do
   {
-    std::vector<double> values( bufferSize );
-    count = dataset->scalarData( indexStart, bufferSize, values.data() );
-    values.resize( count );
-    if ( isFloat )
-    {
-      std::vector<float> floatValues( count );
-      for ( int i = 0; i < MDAL::toInt( count ); ++i )
-        floatValues[i] = static_cast<float>( values[i] );
-      writeValueArray( file, floatValues );
-    }
-    else
-      writeValueArray( file, values );
-
+    count = dataset->scalarData( indexStart, BUFFER_SIZE, values.data() );
+    writer.writeValues<T>( values.data(), count );
     indexStart += count;
   }
   while ( count != 0 );
-  writeInt( file, MDAL::toInt( valuesCount * ( isFloat ? 4 : 8 ) ) );
+  writer.writeInt( MDAL::toInt( valuesCount * sizeof( T ) ) );
 }
 
+//! Writes the records of x and y values of the vector dataset, values are read in blocks
 template<typename T>
-static void writeVectorDataset( std::ofstream &file, MDAL::Dataset *dataset )
+static void writeVectorDataset( SelafinWriter &writer, MDAL::Dataset *dataset )
 {
   size_t valuesCount = dataset->valuesCount();
-
-  std::vector<T> valuesX( valuesCount );
-  std::vector<T> valuesY( valuesCount );
-  size_t bufferSize = BUFFER_SIZE;
-  size_t count = 0;
-  size_t indexStart = 0;
-  do
+  std::vector<double> values( BUFFER_SIZE * 2 );
+  for ( size_t component = 0; component < 2; ++component )
   {
-    std::vector<double> values( bufferSize * 2 );
-    count = dataset->vectorData( indexStart, bufferSize, values.data() );
-    values.resize( count * 2 );
-    for ( int i = 0; i < MDAL::toInt( count ); ++i )
+    size_t count = 0;
+    size_t indexStart = 0;
+    writer.writeInt( MDAL::toInt( valuesCount * sizeof( T ) ) );
+    do
     {
-      valuesX[indexStart + i] = static_cast< T >( values[i * 2] );
-      valuesY[indexStart + i] = static_cast< T >( values[i * 2 + 1] );
+      count = dataset->vectorData( indexStart, BUFFER_SIZE, values.data() );
+      writer.writeValues<T>( values.data() + component, count, 2 );
+      indexStart += count;
     }
-    indexStart += count;
+    while ( count != 0 );
+    writer.writeInt( MDAL::toInt( valuesCount * sizeof( T ) ) );
   }
-  while ( count != 0 );
-  writeValueArrayRecord( file, valuesX );
-  writeValueArrayRecord( file, valuesY );
 }
 
 bool MDAL::SelafinFile::addDatasetGroup( MDAL::DatasetGroup *datasetGroup )
 {
   // Create a new file with same data but with another datasetGroup
   initialize();
-
-  if ( !mIn.is_open() )
-    return false;
-
   parseFile();
 
   size_t realSize;
@@ -1149,13 +1316,14 @@ bool MDAL::SelafinFile::addDatasetGroup( MDAL::DatasetGroup *datasetGroup )
   std::string tempFileName = mFileName;
   tempFileName.append( ".tmp" );
 
-  mIn.seekg( 0, mIn.beg );
+  mPosition = 0;
   std::ofstream out = MDAL::openOutputFile( tempFileName, std::ios_base::binary );
   if ( ! out.is_open() )
     throw MDAL::Error( MDAL_Status::Err_FailToWriteToDisk, "Unable to add dataset in file" );
+  SelafinWriter writer( out );
 
   //write the same header
-  writeStringRecord( out, readHeader() );
+  writer.writeStringRecord( readHeader() );
 
   //Read the NBV1//NBV2 size, and add 1 to NBV1
   std::vector<int> nbv = readIntArr( 2 );
@@ -1165,14 +1333,14 @@ bool MDAL::SelafinFile::addDatasetGroup( MDAL::DatasetGroup *datasetGroup )
     addedVariable = 2;
 
   nbv[0] = nbv[0] + addedVariable;
-  writeValueArrayRecord( out, nbv );
+  writer.writeRecord( nbv );
 
   // write pre-existing dataset name
   for ( size_t i = 0; i < mVariableNames.size(); ++i )
   {
     std::string variableName = mVariableNames.at( i );
     variableName.resize( 32, ' ' );
-    writeStringRecord( out, variableName );
+    writer.writeStringRecord( variableName );
   }
 
   // write new(s) variable name
@@ -1180,7 +1348,7 @@ bool MDAL::SelafinFile::addDatasetGroup( MDAL::DatasetGroup *datasetGroup )
   if ( datasetGroup->isScalar() )
   {
     datasetGroupName.resize( 32, ' ' );
-    writeStringRecord( out, datasetGroupName );
+    writer.writeStringRecord( datasetGroupName );
   }
   else
   {
@@ -1190,8 +1358,8 @@ bool MDAL::SelafinFile::addDatasetGroup( MDAL::DatasetGroup *datasetGroup )
     std::string yName = datasetGroupName + " along y";
     xName.resize( 32 );
     yName.resize( 32 );
-    writeStringRecord( out, xName );
-    writeStringRecord( out, yName );
+    writer.writeStringRecord( xName );
+    writer.writeStringRecord( yName );
   }
 
   //check if valid reference time
@@ -1215,35 +1383,35 @@ bool MDAL::SelafinFile::addDatasetGroup( MDAL::DatasetGroup *datasetGroup )
 
   //parameters table
   mParameters[9] = mReferenceTime.isValid() ?  1 : 0;
-  writeValueArrayRecord( out, mParameters );
+  writer.writeRecord( mParameters );
 
   if ( mReferenceTime.isValid() )
   {
-    writeValueArrayRecord( out, mReferenceTime.expandToCalendarArray() );
+    writer.writeRecord( mReferenceTime.expandToCalendarArray() );
   }
 
   //elems count
-  writeValueArrayRecord( out, std::vector<int> {int( mFacesCount ), int( mVerticesCount ), int( mVerticesPerFace ), 1} );
+  writer.writeRecord( std::vector<int> {int( mFacesCount ), int( mVerticesCount ), int( mVerticesPerFace ), 1} );
 
   //IKLE
-  writeInt( out, MDAL::toInt( mFacesCount * mVerticesPerFace * 4 ) );
-  streamToStream( out, mIn, mConnectivityStreamPosition, mFacesCount * mVerticesPerFace * 4, BUFFER_SIZE );
-  writeInt( out, MDAL::toInt( mFacesCount * mVerticesPerFace * 4 ) );
+  writer.writeInt( MDAL::toInt( mFacesCount * mVerticesPerFace * 4 ) );
+  writer.writeBytes( mFile->data() + mConnectivityStreamPosition, mFacesCount * mVerticesPerFace * 4 );
+  writer.writeInt( MDAL::toInt( mFacesCount * mVerticesPerFace * 4 ) );
   //vertices
 
   //IPOBO
-  writeInt( out, MDAL::toInt( mVerticesCount * 4 ) );
-  streamToStream( out, mIn, mIPOBOStreamPosition, mVerticesCount * 4, BUFFER_SIZE );
-  writeInt( out, MDAL::toInt( mVerticesCount * 4 ) );
+  writer.writeInt( MDAL::toInt( mVerticesCount * 4 ) );
+  writer.writeBytes( mFile->data() + mIPOBOStreamPosition, mVerticesCount * 4 );
+  writer.writeInt( MDAL::toInt( mVerticesCount * 4 ) );
 
   //X Vertices
-  writeInt( out, MDAL::toInt( mVerticesCount * realSize ) );
-  streamToStream( out, mIn, mXStreamPosition, mVerticesCount * realSize, BUFFER_SIZE );
-  writeInt( out, MDAL::toInt( mVerticesCount * realSize ) );
+  writer.writeInt( MDAL::toInt( mVerticesCount * realSize ) );
+  writer.writeBytes( mFile->data() + mXStreamPosition, mVerticesCount * realSize );
+  writer.writeInt( MDAL::toInt( mVerticesCount * realSize ) );
   //Y Vertices
-  writeInt( out, MDAL::toInt( mVerticesCount * realSize ) );
-  streamToStream( out, mIn, mYStreamPosition, mVerticesCount * realSize, BUFFER_SIZE );
-  writeInt( out, MDAL::toInt( mVerticesCount * realSize ) );
+  writer.writeInt( MDAL::toInt( mVerticesCount * realSize ) );
+  writer.writeBytes( mFile->data() + mYStreamPosition, mVerticesCount * realSize );
+  writer.writeInt( MDAL::toInt( mVerticesCount * realSize ) );
 
   // Write datasets
   for ( size_t nT = 0; nT < mTimeSteps.size(); nT++ )
@@ -1252,39 +1420,43 @@ bool MDAL::SelafinFile::addDatasetGroup( MDAL::DatasetGroup *datasetGroup )
     if ( mStreamInFloatPrecision )
     {
       std::vector<float> time( 1, static_cast<float>( mTimeSteps.at( nT ).value( RelativeTimestamp::seconds ) ) );
-      writeValueArrayRecord( out, time );
+      writer.writeRecord( time );
     }
     else
     {
       std::vector<double> time( 1, mTimeSteps.at( nT ).value( RelativeTimestamp::seconds ) );
-      writeValueArrayRecord( out, time );
+      writer.writeRecord( time );
     }
 
     // First, prexisting datasets from the original file
     for ( int i = 0; i < nbv[0] - addedVariable; ++i )
     {
-      writeInt( out, MDAL::toInt( mVerticesCount * realSize ) );
-      streamToStream( out, mIn, mVariableStreamPosition[i][nT], realSize * mVerticesCount, BUFFER_SIZE );
-      writeInt( out, MDAL::toInt( mVerticesCount * realSize ) );
+      writer.writeInt( MDAL::toInt( mVerticesCount * realSize ) );
+      writer.writeBytes( mFile->data() + mVariableStreamPosition[i][nT], realSize * mVerticesCount );
+      writer.writeInt( MDAL::toInt( mVerticesCount * realSize ) );
     }
 
     // Then, new datasets from the new dataset group
     Dataset *dataset = datasetGroup->datasets[nT].get();
     if ( datasetGroup->isScalar() )
     {
-      writeScalarDataset( out, dataset, mStreamInFloatPrecision );
+      if ( mStreamInFloatPrecision )
+        writeScalarDataset<float>( writer, dataset );
+      else
+        writeScalarDataset<double>( writer, dataset );
     }
     else
     {
       if ( mStreamInFloatPrecision )
-        writeVectorDataset<float>( out, dataset );
+        writeVectorDataset<float>( writer, dataset );
       else
-        writeVectorDataset<double>( out, dataset );
+        writeVectorDataset<double>( writer, dataset );
     }
   }
 
+  writer.flush();
   out.close();
-  mIn.close();
+  close();
 
   // if the uri of the dataset group is the same than the file name, be sure to close it before replace it
   if ( datasetGroup->uri() == mFileName )
@@ -16,12 +16,14 @@
 #include "mdal_memory_data_model.hpp"
 #include "mdal.h"
 #include "mdal_driver.hpp"
+#include "mdal_memory_mapped_file.hpp"
 
 namespace MDAL
 {
   /**
    * This class is used to read the selafin file format.
-   * The file is opened with initialize() and stay opened until this object is destroyed
+   * The file is memory mapped with initialize() and stay opened until this object is destroyed or close() is called.
+   * Values of the records are decoded (and their bytes swapped) from the mapped file directly to the buffers of the callers
    *
    * \note SelafinFile object is shared between different datasets, with the mesh and its iterators.
    *       As SelafinFile is not thread safe, it has to be shared in the same thread.
@@ -66,6 +68,16 @@ namespace MDAL
       //! Extracts data from the file
       void parseFile();
 
+      /**
+       * Sets positions of the records of \a timestepsCount time steps of \a frameSize bytes from the current position,
+       * the records of all time steps are supposed to have the same size. Only markers of the records of
+       * the first and the last time step are checked, returns false if they do not match the sizes
+       */
+      bool indexTimesteps( size_t timestepsCount, size_t frameSize );
+
+      //! Returns whether there are markers of a record of \a len bytes at \a position
+      bool checkRecord( size_t position, size_t len ) const;
+
       //! Returns the vertices count in the mesh stored in the file
       size_t verticesCount();
       //! Returns the faces count in the mesh stored in the file
@@ -73,60 +85,73 @@ namespace MDAL
       //! Returns the vertices count per face for the mesh stored in the file
       size_t verticesPerFace();
 
-      //! Returns \a count values at \a timeStepIndex and \a variableIndex, and an \a offset from the start
-      std::vector<double> datasetValues( size_t timeStepIndex, size_t variableIndex, size_t offset, size_t count );
-      //! Returns \a count vertex indexex in face with an \a offset from the start
-      std::vector<int> connectivityIndex( size_t offset, size_t count );
-      //! Returns \a count vertices with an \a offset from the start
-      std::vector<double> vertices( size_t offset, size_t count );
-
-      //! Reads a string record with a size \a len from current position in the stream, throws an exception if the size in not compaitble
+      /**
+       * Reads \a count values at \a timeStepIndex and \a variableIndex, and an \a offset from the start
+       * The value i is written to buffer[i * stride], returns false if the values are not in the file
+       */
+      bool datasetValues( size_t timeStepIndex, size_t variableIndex, size_t offset, size_t count, double *buffer, size_t stride = 1 );
+      //! Reads values of the variable at \a offset in \a count time steps starting with \a timeStepIndex, see datasetValues()
+      bool timeSeriesValues( size_t timeStepIndex, size_t count, size_t variableIndex, size_t offset, double *buffer, size_t stride = 1 );
+      //! Reads \a count vertex indexes in face with an \a offset from the start
+      bool connectivityIndex( size_t offset, size_t count, int *buffer );
+      //! Reads \a count vertices (x, y, z) with an \a offset from the start
+      bool vertices( size_t offset, size_t count, double *coordinates );
+
+      //! Releases the mapping of the file, the file is mapped and parsed again on the next request
+      void close();
+
+      //! Reads a string record with a size \a len from current position in the file, throws an exception if the size in not compaitble
       std::string readString( size_t len );
 
       /**
-       * Reads a double array record with a size \a len from current position in the stream,
+       * Reads a double array record with a size \a len from current position in the file,
        * throws an exception if the size in not compatible
        */
       std::vector<double> readDoubleArr( size_t len );
 
       /**
-       * Reads a int array record with a size \a len from current position in the stream,
+       * Reads a int array record with a size \a len from current position in the file,
        * throws an exception if the size in not compatible
        */
       std::vector<int> readIntArr( size_t len );
 
       /**
        * Reads some values in a double array record. The values count is \a len,
-       * the reading begin at the stream \a position with the \a offset
+       * the reading begin at the file \a position with the \a offset.
+       * The value i is written to buffer[i * stride], returns false if the values are not in the file
        */
-      std::vector<double> readDoubleArr( const std::streampos &position, size_t offset, size_t len );
+      bool readDoubleArr( size_t position, size_t offset, size_t len, double *buffer, size_t stride = 1 ) const;
 
       /**
        * Reads some values in a int array record. The values count is \a len,
-       * the reading begin at the stream \a position with the \a offset
+       * the reading begin at the file \a position with the \a offset.
+       * Returns false if the values are not in the file
        */
-      std::vector<int> readIntArr( const std::streampos &position, size_t offset, size_t len );
+      bool readIntArr( size_t position, size_t offset, size_t len, int *buffer ) const;
 
-      //! Returns whether there is a int array with size \a len at the current position in the stream
+      //! Returns whether there is a int array with size \a len at the current position in the file
       bool checkIntArraySize( size_t len );
 
-      //! Returns whether there is a double array with size \a len at the current position in the stream
+      //! Returns whether there is a double array with size \a len at the current position in the file
       bool checkDoubleArraySize( size_t len );
 
-      //! Returns the remaining bytes in the stream from current position until the end
+      //! Returns the remaining bytes in the file from current position until the end
       size_t remainingBytes();
 
       /**
-       * Set the position in the stream just after the int array with \a size, returns position of the beginning of the array
+       * Set the position in the file just after the int array with \a size, returns position of the beginning of the array
        * The presence of int array can be check with checkIntArraySize()
        */
-      std::streampos passThroughIntArray( size_t size );
+      size_t passThroughIntArray( size_t size );
 
       /**
-       * Set the position in the stream just after the double array with \a size, returns position of the beginning of the array
+       * Set the position in the file just after the double array with \a size, returns position of the beginning of the array
        * The presence of double array can be check with checkDoubleArraySize()
        */
-      std::streampos passThroughDoubleArray( size_t size );
+      size_t passThroughDoubleArray( size_t size );
+
+      //! Returns pointer to \a len bytes at the current position and moves the position behind them, throws an exception at the end of the file
+      const char *readBytes( size_t len );
 
       double readDouble( );
       int readInt( );
@@ -134,7 +159,7 @@ namespace MDAL
 
       void ignoreArrayLength( );
       std::string readStringWithoutLength( size_t len );
-      void ignore( int len );
+      void ignore( size_t len );
 
       static void populateDataset( Mesh *mesh, std::shared_ptr<SelafinFile> reader );
 
@@ -144,26 +169,27 @@ namespace MDAL
       std::vector<int> mParameters;
       // Dataset
       DateTime mReferenceTime;
-      std::vector<std::vector<std::streampos>> mVariableStreamPosition; //! [variableIndex][timeStep]
+      std::vector<std::vector<size_t>> mVariableStreamPosition; //! [variableIndex][timeStep]
       std::vector<RelativeTimestamp> mTimeSteps;
       std::vector<std::string> mVariableNames;
       // Mesh
       size_t mVerticesCount = 0;
       size_t mFacesCount = 0;
       size_t mVerticesPerFace = 0;
-      std::streampos mXStreamPosition;
-      std::streampos mYStreamPosition;
-      std::streampos mConnectivityStreamPosition;
-      std::streampos mIPOBOStreamPosition;
+      size_t mXStreamPosition = 0;
+      size_t mYStreamPosition = 0;
+      size_t mConnectivityStreamPosition = 0;
+      size_t mIPOBOStreamPosition = 0;
       double mXOrigin = 0;
       double mYOrigin = 0;
 
       std::string mFileName;
       bool mStreamInFloatPrecision = true;
       bool mChangeEndianness = true;
-      long long mFileSize = -1;
 
-      std::ifstream mIn;
+      std::unique_ptr<MemoryMappedFile> mFile;
+      //! position of the next record read by parseFile()
+      size_t mPosition = 0;
       bool mParsed = false;
 
 
@@ -192,12 +218,18 @@ namespace MDAL
       size_t scalarData( size_t indexStart, size_t count, double *buffer ) override;
       size_t vectorData( size_t indexStart, size_t count, double *buffer ) override;
 
+      bool timeSeriesData( const size_t *elementIndexes, size_t elementCount, size_t datasetCount, double *buffer ) override;
+
       //! Sets the position of the X array in the stream
       void setXVariableIndex( size_t index );
       //! Sets the position of the Y array in the stream
       void setYVariableIndex( size_t index );
 
     private:
+      //! Reads values from the file, see BlockCache
+      size_t readScalarData( size_t indexStart, size_t count, double *buffer );
+      size_t readVectorData( size_t indexStart, size_t count, double *buffer );
+
       std::shared_ptr<SelafinFile> mReader;
 
       size_t mXVariableIndex = 0;
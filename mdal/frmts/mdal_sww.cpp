@@ -84,12 +84,11 @@ std::vector<double> MDAL::DriverSWW::readZCoords( const NetCDFFile &ncFile ) con
         // fetching "elevation" data for the first timestep,
         // and threat it as z coord
         size_t start[2], count[2];
-        const ptrdiff_t stride[2] = {1, 1};
         start[0] = 0; // t = 0
         start[1] = 0;
         count[0] = 1;
         count[1] = nPoints;
-        nc_get_vars_double( ncFile.handle(), zid, start, count, stride, pz.data() );
+        nc_get_vara_double( ncFile.handle(), zid, start, count, pz.data() );
       }
     }
   }
@@ -313,7 +312,7 @@ std::shared_ptr<MDAL::DatasetGroup> MDAL::DriverSWW::readScalarGroup(
       {
         o->setScalarValue( i, valuesX[i] );
       }
-      o->setStatistics( MDAL::calculateStatistics( o ) );
+      MDAL::updateStatistics( o );
       mds->datasets.push_back( o );
     }
     else
@@ -327,17 +326,16 @@ std::shared_ptr<MDAL::DatasetGroup> MDAL::DriverSWW::readScalarGroup(
 
         // fetching data for one timestep
         size_t start[2], count[2];
-        const ptrdiff_t stride[2] = {1, 1};
         start[0] = t;
         start[1] = 0;
         count[0] = 1;
         count[1] = nPoints;
-        nc_get_vars_double( ncFile.handle(), varxid, start, count, stride, values );
-        mto->setStatistics( MDAL::calculateStatistics( mto ) );
+        nc_get_vara_double( ncFile.handle(), varxid, start, count, values );
+        MDAL::updateStatistics( mto );
         mds->datasets.push_back( mto );
       }
     }
-    mds->setStatistics( MDAL::calculateStatistics( mds ) );
+    MDAL::updateStatistics( mds );
   }
 
   return mds;
@@ -389,7 +387,7 @@ std::shared_ptr<MDAL::DatasetGroup> MDAL::DriverSWW::readVectorGroup(
       {
         o->setVectorValue( i, valuesX[i], valuesY[i] );
       }
-      o->setStatistics( MDAL::calculateStatistics( o ) );
+      MDAL::updateStatistics( o );
       mds->datasets.push_back( o );
     }
     else
@@ -403,24 +401,23 @@ std::shared_ptr<MDAL::DatasetGroup> MDAL::DriverSWW::readVectorGroup(
 
         // fetching data for one timestep
         size_t start[2], count[2];
-        const ptrdiff_t stride[2] = {1, 1};
         start[0] = t;
         start[1] = 0;
         count[0] = 1;
         count[1] = nPoints;
-        nc_get_vars_double( ncFile.handle(), varxid, start, count, stride, valuesX.data() );
-        nc_get_vars_double( ncFile.handle(), varyid, start, count, stride, valuesY.data() );
+        nc_get_vara_double( ncFile.handle(), varxid, start, count, valuesX.data() );
+        nc_get_vara_double( ncFile.handle(), varyid, start, count, valuesY.data() );
 
         for ( size_t i = 0; i < nPoints; ++i )
         {
           mto->setVectorValue( i, static_cast<double>( valuesX[i] ),  static_cast<double>( valuesY[i] ) );
         }
 
-        mto->setStatistics( MDAL::calculateStatistics( mto ) );
+        MDAL::updateStatistics( mto );
         mds->datasets.push_back( mto );
       }
     }
-    mds->setStatistics( MDAL::calculateStatistics( mds ) );
+    MDAL::updateStatistics( mds );
   }
 
   return mds;
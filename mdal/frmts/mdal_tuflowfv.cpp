@@ -30,20 +30,20 @@ size_t MDAL::TuflowFVActiveFlag::activeData(
     return 0;
 
   size_t copyValues = std::min( facesCount - indexStart, count );
-  std::vector<int> values = ncFile->readIntArr(
-                              ncidActive,
-                              timestep,
-                              indexStart,
-                              1,
-                              copyValues
-                            );
+  ncFile->readIntArr(
+    ncidActive,
+    timestep,
+    indexStart,
+    1,
+    copyValues,
+    buffer
+  );
 
   for ( size_t i = 0; i < copyValues; ++i )
   {
     // 0 means inactive in raw data file == false (0)
     // -1 means active in raw data file == true (1)
-    int val = values[i] == 0 ? 0 : 1;
-    buffer[i] = val;
+    buffer[i] = buffer[i] == 0 ? 0 : 1;
   }
   return copyValues;
 }
@@ -140,12 +140,12 @@ size_t MDAL::TuflowFVDataset3D::verticalLevelCountData( size_t indexStart, size_
     return 0;
 
   size_t copyValues = std::min( mFacesCount - indexStart, count );
-  std::vector<int> vals = mNcFile->readIntArr(
-                            mNcidVerticalLevels,
-                            indexStart,
-                            copyValues
-                          );
-  memcpy( buffer, vals.data(), copyValues * sizeof( int ) );
+  mNcFile->readIntArr(
+    mNcidVerticalLevels,
+    indexStart,
+    copyValues,
+    buffer
+  );
   return copyValues;
 }
 
@@ -159,14 +159,14 @@ size_t MDAL::TuflowFVDataset3D::verticalLevelData( size_t indexStart, size_t cou
     return 0;
 
   size_t copyValues = std::min( mLevelFacesCount - indexStart, count );
-  std::vector<double> vals = mNcFile->readDoubleArr(
-                               mNcidVerticalLevelsZ,
-                               mTs,
-                               indexStart,
-                               1,
-                               copyValues
-                             );
-  memcpy( buffer, vals.data(), copyValues * sizeof( double ) );
+  mNcFile->readDoubleArr(
+    mNcidVerticalLevelsZ,
+    mTs,
+    indexStart,
+    1,
+    copyValues,
+    buffer
+  );
   return copyValues;
 }
 
@@ -178,17 +178,16 @@ size_t MDAL::TuflowFVDataset3D::faceToVolumeData( size_t indexStart, size_t coun
     return 0;
 
   size_t copyValues = std::min( mFacesCount - indexStart, count );
-  std::vector<int> vals = mNcFile->readIntArr(
-                            mNcid2DTo3D,
-                            indexStart,
-                            copyValues
-                          );
+  mNcFile->readIntArr(
+    mNcid2DTo3D,
+    indexStart,
+    copyValues,
+    buffer
+  );
 
   // indexed from 1 in FV, from 0 in MDAL
-  for ( auto &element : vals )
-    element -= 1;
-
-  memcpy( buffer, vals.data(), copyValues * sizeof( int ) );
+  for ( size_t i = 0; i < copyValues; ++i )
+    buffer[i] -= 1;
   return copyValues;
 }
 
@@ -200,28 +199,28 @@ size_t MDAL::TuflowFVDataset3D::scalarVolumesData( size_t indexStart, size_t cou
     return 0;
 
   size_t copyValues = std::min( volumesCount() - indexStart, count );
-  std::vector<double> vals;
 
   assert( mTimeLocation != CFDatasetGroupInfo::TimeDimensionLast );
   if ( mTimeLocation == CFDatasetGroupInfo::TimeDimensionFirst )
   {
-    vals = mNcFile->readDoubleArr(
-             mNcidX,
-             mTs,
-             indexStart,
-             1,
-             copyValues
-           );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      mTs,
+      indexStart,
+      1,
+      copyValues,
+      buffer
+    );
   }
   else     //NoTimeDimension
   {
-    vals = mNcFile->readDoubleArr(
-             mNcidX,
-             indexStart,
-             copyValues
-           );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      indexStart,
+      copyValues,
+      buffer
+    );
   }
-  memcpy( buffer, vals.data(), copyValues * sizeof( double ) );
   return copyValues;
 }
 
@@ -233,40 +232,44 @@ size_t MDAL::TuflowFVDataset3D::vectorVolumesData( size_t indexStart, size_t cou
     return 0;
 
   size_t copyValues = std::min( volumesCount() - indexStart, count );
-  std::vector<double> vals_x;
-  std::vector<double> vals_y;
+  std::vector<double> vals_x( copyValues );
+  std::vector<double> vals_y( copyValues );
 
   assert( mTimeLocation != CFDatasetGroupInfo::TimeDimensionLast );
   if ( mTimeLocation == CFDatasetGroupInfo::TimeDimensionFirst )
   {
-    vals_x = mNcFile->readDoubleArr(
-               mNcidX,
-               mTs,
-               indexStart,
-               1,
-               copyValues
-             );
-    vals_y = mNcFile->readDoubleArr(
-               mNcidY,
-               mTs,
-               indexStart,
-               1,
-               copyValues
-             );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      mTs,
+      indexStart,
+      1,
+      copyValues,
+      vals_x.data()
+    );
+    mNcFile->readDoubleArr(
+      mNcidY,
+      mTs,
+      indexStart,
+      1,
+      copyValues,
+      vals_y.data()
+    );
 
   }
   else
   {
-    vals_x = mNcFile->readDoubleArr(
-               mNcidX,
-               indexStart,
-               copyValues
-             );
-    vals_y = mNcFile->readDoubleArr(
-               mNcidY,
-               indexStart,
-               copyValues
-             );
+    mNcFile->readDoubleArr(
+      mNcidX,
+      indexStart,
+      copyValues,
+      vals_x.data()
+    );
+    mNcFile->readDoubleArr(
+      mNcidY,
+      indexStart,
+      copyValues,
+      vals_y.data()
+    );
   }
 
 
@@ -541,7 +544,7 @@ std::shared_ptr<MDAL::Dataset> MDAL::DriverTuflowFV::create2DDataset(
         ts,
         mNcFile
       );
-  dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+  MDAL::updateStatistics( dataset );
   return std::move( dataset );
 }
 
@@ -568,7 +571,7 @@ std::shared_ptr<MDAL::Dataset> MDAL::DriverTuflowFV::create3DDataset( std::share
         mNcFile
       );
 
-  dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+  MDAL::updateStatistics( dataset );
   return std::move( dataset );
 }
 
@@ -14,6 +14,8 @@
 
 #define FILL_COORDINATES_VALUE -999.0
 #define FILL_FACE2D_VALUE -999
+//! Rows of node and face variables per compression chunk, writes are done in blocks of the same size
+#define MESH_CHUNK_ROWS 65536
 
 MDAL::DriverUgrid::DriverUgrid()
   : DriverCF(
@@ -846,6 +848,9 @@ bool MDAL::DriverUgrid::writeDatasetGroup( MDAL::DatasetGroup *group, const std:
     dimTimeId = mDimensions.netCfdId( CFDimensions::Time );
 
   std::vector<int> writeDim( {dimTimeId, dimElemId} );
+  // one chunk per timestep, datasets are written and mostly read by timesteps,
+  // large meshes are split to chunks of rows like the mesh variables
+  const std::vector<size_t> chunkSizes( {1, std::min<size_t>( std::max( elementCount, size_t( 1 ) ), MESH_CHUNK_ROWS )} );
 
   if ( group->isScalar() )
   {
@@ -855,12 +860,13 @@ bool MDAL::DriverUgrid::writeDatasetGroup( MDAL::DatasetGroup *group, const std:
     mNcFile->putAttrStr( groupId, "location", elementType );
     mNcFile->putAttrStr( groupId, "coordinates", mMeshName + "_face_x " + mMeshName + "_face_y" );
     mNcFile->setFillValue( groupId, NC_FILL_DOUBLE );
+    mNcFile->defineVarCompression( groupId, chunkSizes );
 
     nc_enddef( mNcFile->handle() );
 
+    std::vector<double> values( elementCount );
     for ( size_t di = 0; di < group->datasets.size(); ++di )
     {
-      std::vector<double> values( elementCount );
       size_t valueCount = group->datasets.at( di )->scalarData( 0, elementCount, values.data() );
       if ( valueCount != elementCount )
         throw MDAL::Error( MDAL_Status::Err_IncompatibleDataset, "Wrong dataset values count", name() );
@@ -891,14 +897,16 @@ bool MDAL::DriverUgrid::writeDatasetGroup( MDAL::DatasetGroup *group, const std:
     mNcFile->putAttrStr( groupIdY, "location", elementType );
     mNcFile->putAttrStr( groupIdY, "coordinates", mMeshName + "_face_x " + mMeshName + "_face_y" );
     mNcFile->setFillValue( groupIdY, NC_FILL_DOUBLE );
+    mNcFile->defineVarCompression( groupIdX, chunkSizes );
+    mNcFile->defineVarCompression( groupIdY, chunkSizes );
 
     nc_enddef( mNcFile->handle() );
 
+    std::vector<double> values( elementCount * 2 );
+    std::vector<double> valuesX( elementCount );
+    std::vector<double> valuesY( elementCount );
     for ( size_t di = 0; di < group->datasets.size(); ++di )
     {
-      std::vector<double> values( elementCount * 2 );
-      std::vector<double> valuesX( elementCount );
-      std::vector<double> valuesY( elementCount );
       size_t valueCount = group->datasets.at( di )->vectorData( 0, elementCount, values.data() );
       if ( valueCount != elementCount )
         throw MDAL::Error( MDAL_Status::Err_IncompatibleDataset, "Wrong dataset values count", name() );
@@ -1031,6 +1039,16 @@ void MDAL::DriverUgrid::writeVariables( MDAL::Mesh *mesh, const std::string &mes
   mNcFile->putAttrInt( mesh2FaceNodesId, "start_index", 0 );
   mNcFile->putAttrInt( mesh2FaceNodesId, "_FillValue", FILL_FACE2D_VALUE );
 
+  const size_t verticesCount = mesh->verticesCount() == 0 ? 1 : mesh->verticesCount();
+  const size_t facesCount = mesh->facesCount() == 0 ? 1 : mesh->facesCount();
+  const size_t faceVerticesMax = mesh->faceVerticesMaximumCount() == 0 ? 1 : mesh->faceVerticesMaximumCount();
+  const size_t verticesChunk = std::min<size_t>( verticesCount, MESH_CHUNK_ROWS );
+  const size_t facesChunk = std::min<size_t>( facesCount, MESH_CHUNK_ROWS );
+  mNcFile->defineVarCompression( mesh2dNodeXId, {verticesChunk} );
+  mNcFile->defineVarCompression( mesh2dNodeYId, {verticesChunk} );
+  mNcFile->defineVarCompression( mesh2dNodeZId, {verticesChunk} );
+  mNcFile->defineVarCompression( mesh2FaceNodesId, {facesChunk, faceVerticesMax} );
+
   // Projected Coordinate System
   int pcsId = mNcFile->defineVar( "projected_coordinate_system", NC_INT, 0, nullptr );
 
@@ -1059,11 +1077,14 @@ void MDAL::DriverUgrid::writeVariables( MDAL::Mesh *mesh, const std::string &mes
 
   // Write vertices
 
-  const size_t maxBufferSize = 1000;
-  const size_t bufferSize = std::min( mesh->verticesCount(), maxBufferSize );
+  // blocks match the chunks, so each chunk is compressed only once
+  const size_t bufferSize = verticesChunk;
   const size_t verticesCoordCount = bufferSize * 3;
 
   std::vector<double> verticesCoordinates( verticesCoordCount );
+  std::vector<double> coordinatesX( bufferSize );
+  std::vector<double> coordinatesY( bufferSize );
+  std::vector<double> coordinatesZ( bufferSize );
   std::unique_ptr<MDAL::MeshVertexIterator> vertexIterator = mesh->readVertices();
 
   if ( mesh->verticesCount() == 0 )
@@ -1085,31 +1106,33 @@ void MDAL::DriverUgrid::writeVariables( MDAL::Mesh *mesh, const std::string &mes
 
       for ( size_t i = 0; i < verticesRead; i++ )
       {
-        mNcFile->putDataDouble( mesh2dNodeXId, vertexFileIndex, verticesCoordinates[3 * i] );
-        mNcFile->putDataDouble( mesh2dNodeYId, vertexFileIndex, verticesCoordinates[3 * i + 1] );
+        coordinatesX[i] = verticesCoordinates[3 * i];
+        coordinatesY[i] = verticesCoordinates[3 * i + 1];
         if ( std::isnan( verticesCoordinates[3 * i + 2] ) )
-          mNcFile->putDataDouble( mesh2dNodeZId, vertexFileIndex, FILL_COORDINATES_VALUE );
+          coordinatesZ[i] = FILL_COORDINATES_VALUE;
         else
-          mNcFile->putDataDouble( mesh2dNodeZId, vertexFileIndex, verticesCoordinates[3 * i + 2] );
-        vertexFileIndex++;
+          coordinatesZ[i] = verticesCoordinates[3 * i + 2];
       }
+      mNcFile->putDataDoubleArr( mesh2dNodeXId, vertexFileIndex, verticesRead, coordinatesX.data() );
+      mNcFile->putDataDoubleArr( mesh2dNodeYId, vertexFileIndex, verticesRead, coordinatesY.data() );
+      mNcFile->putDataDoubleArr( mesh2dNodeZId, vertexFileIndex, verticesRead, coordinatesZ.data() );
+      vertexFileIndex += verticesRead;
       vertexIndex += verticesRead;
     }
   }
 
   // Write faces
   std::unique_ptr<MDAL::MeshFaceIterator> faceIterator = mesh->readFaces();
-  const size_t faceVerticesMax = mesh->faceVerticesMaximumCount();
-  const size_t facesCount = mesh->facesCount();
-  const size_t faceOffsetsBufferLen = std::min( facesCount, maxBufferSize );
+  const size_t faceOffsetsBufferLen = facesChunk;
   const size_t vertexIndicesBufferLen = faceOffsetsBufferLen * faceVerticesMax;
 
   std::vector<int> faceOffsetsBuffer( faceOffsetsBufferLen );
   std::vector<int> vertexIndicesBuffer( vertexIndicesBufferLen );
+  std::vector<int> verticesFaceData( vertexIndicesBufferLen );
 
   size_t faceIndex = 0;
 
-  if ( facesCount == 0 )
+  if ( mesh->facesCount() == 0 )
   {
     // if there is no vertices fill the first fake vertex, see global dimension
     int fillValue = FILL_FACE2D_VALUE;
@@ -1117,7 +1140,7 @@ void MDAL::DriverUgrid::writeVariables( MDAL::Mesh *mesh, const std::string &mes
   }
   else
   {
-    while ( faceIndex < facesCount )
+    while ( faceIndex < mesh->facesCount() )
     {
       size_t facesRead = faceIterator->next(
                            faceOffsetsBufferLen,
@@ -1127,22 +1150,23 @@ void MDAL::DriverUgrid::writeVariables( MDAL::Mesh *mesh, const std::string &mes
       if ( facesRead == 0 )
         break;
 
+      std::fill( verticesFaceData.begin(), verticesFaceData.end(), FILL_FACE2D_VALUE );
       for ( size_t i = 0; i < facesRead; i++ )
       {
-        std::vector<int> verticesFaceData( faceVerticesMax, FILL_FACE2D_VALUE );
         int startIndex = 0;
         if ( i > 0 )
           startIndex = faceOffsetsBuffer[ i - 1 ];
         int endIndex = faceOffsetsBuffer[ i ];
 
-        size_t k = 0;
+        size_t k = i * faceVerticesMax;
         for ( int j = startIndex; j < endIndex; ++j )
         {
           int vertexIndex = vertexIndicesBuffer[ static_cast<size_t>( j ) ];
           verticesFaceData[k++] = vertexIndex;
         }
-        mNcFile->putDataArrayInt( mesh2FaceNodesId, faceIndex + i, faceVerticesMax, verticesFaceData.data() );
       }
+      // whole block of faces in one call
+      mNcFile->putDataArrayInt( mesh2FaceNodesId, faceIndex, facesRead, faceVerticesMax, verticesFaceData.data() );
       faceIndex += facesRead;
     }
   }
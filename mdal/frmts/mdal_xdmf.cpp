@@ -20,6 +20,7 @@
 #include "mdal_data_model.hpp"
 #include "mdal_xml.hpp"
 #include "mdal_logger.hpp"
+#include "mdal_block_cache.hpp"
 
 MDAL::XdmfDataset::XdmfDataset( MDAL::DatasetGroup *grp,
                                 const MDAL::HyperSlab &slab,
@@ -62,7 +63,20 @@ size_t MDAL::XdmfDataset::scalarData( size_t indexStart, size_t count, double *b
 {
   assert( group()->isScalar() ); //checked in C API interface
   assert( mHyperSlab.isScalar );
+  return MDAL::BlockCache::read( this, mHyperSlab.count, 1, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readScalarData( start, n, values ); } );
+}
+
+size_t MDAL::XdmfDataset::vectorData( size_t indexStart, size_t count, double *buffer )
+{
+  assert( !group()->isScalar() ); //checked in C API interface
+  assert( !mHyperSlab.isScalar );
+  return MDAL::BlockCache::read( this, mHyperSlab.count, 2, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readVectorData( start, n, values ); } );
+}
 
+size_t MDAL::XdmfDataset::readScalarData( size_t indexStart, size_t count, double *buffer )
+{
   size_t nValues = mHyperSlab.count;
   if ( ( count < 1 ) || ( indexStart >= nValues ) )
     return 0;
@@ -70,21 +84,14 @@ size_t MDAL::XdmfDataset::scalarData( size_t indexStart, size_t count, double *b
 
   std::vector<hsize_t> off = offsets( indexStart );
   std::vector<hsize_t> counts = selections( copyValues );
-  std::vector<double> values = mHdf5DatasetValues.readArrayDouble( off, counts );
-  if ( values.empty() )
+  if ( !mHdf5DatasetValues.readArrayDouble( off, counts, buffer ) )
     return 0;
 
-  const double *input = values.data();
-  memcpy( buffer, input, copyValues * sizeof( double ) );
   return copyValues;
 }
 
-
-size_t MDAL::XdmfDataset::vectorData( size_t indexStart, size_t count, double *buffer )
+size_t MDAL::XdmfDataset::readVectorData( size_t indexStart, size_t count, double *buffer )
 {
-  assert( !group()->isScalar() ); //checked in C API interface
-  assert( !mHyperSlab.isScalar );
-
   size_t nValues = mHyperSlab.count;
   if ( ( count < 1 ) || ( indexStart >= nValues ) )
     return 0;
@@ -92,6 +99,16 @@ size_t MDAL::XdmfDataset::vectorData( size_t indexStart, size_t count, double *b
 
   std::vector<hsize_t> off = offsets( indexStart );
   std::vector<hsize_t> counts = selections( copyValues );
+
+  if ( mHyperSlab.countInFirstColumn )
+  {
+    // x and y are the first two of three components, [value][component] array is read directly
+    counts[1] = 2;
+    if ( !mHdf5DatasetValues.readArrayDouble( off, counts, buffer ) )
+      return 0;
+    return copyValues;
+  }
+
   std::vector<double> values = mHdf5DatasetValues.readArrayDouble( off, counts );
   if ( values.empty() )
     return 0;
@@ -110,41 +127,72 @@ size_t MDAL::XdmfDataset::vectorData( size_t indexStart, size_t count, double *b
 // //////////////////////////////////////////////////////////////////////////////
 
 
+static void _subtractKernel( const double *const *operands, size_t count, double *buffer )
+{
+  const double *x0 = operands[0];
+  const double *x1 = operands[1];
+  for ( size_t j = 0; j < count; ++j )
+    buffer[j] = x1[j] - x0[j];
+}
+
+static void _joinKernel( const double *const *operands, size_t count, double *buffer )
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double *x = operands[0];
+  const double *y = operands[1];
+  for ( size_t j = 0; j < count; ++j )
+  {
+    const bool valid = !std::isnan( x[j] ) && !std::isnan( y[j] );
+    buffer[2 * j] = valid ? x[j] : nan;
+    buffer[2 * j + 1] = valid ? y[j] : nan;
+  }
+}
+
+static void _flowKernel( const double *const *operands, size_t count, double *buffer )
+{
+  const double *x0 = operands[0];
+  const double *x1 = operands[1];
+  const double *x2 = operands[2];
+  const double *x3 = operands[3];
+  for ( size_t j = 0; j < count; ++j )
+  {
+    if ( !std::isnan( x0[j] ) &&
+         !std::isnan( x1[j] ) &&
+         !std::isnan( x2[j] ) &&
+         !MDAL::equals( x2[j], x3[j] ) )
+    {
+      const double diff = x2[j] - x3[j];
+      buffer[j] = sqrt( ( x0[j] / diff ) * ( x0[j] / diff ) + ( x1[j] / diff ) * ( x1[j] / diff ) );
+    }
+    else
+    {
+      buffer[j] = std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+}
+
 MDAL::XdmfFunctionDataset::XdmfFunctionDataset(
   MDAL::DatasetGroup *grp,
   MDAL::XdmfFunctionDataset::FunctionType type,
   const RelativeTimestamp &time )
   : MDAL::Dataset2D( grp )
   , mType( type )
-  , mBaseReferenceGroup( "XDMF", grp->mesh(), grp->uri() )
 {
   setTime( time );
-  mBaseReferenceGroup.setIsScalar( true );
-  mBaseReferenceGroup.setDataLocation( grp->dataLocation() );
-  mBaseReferenceGroup.setName( "Base group for reference datasets" );
 }
 
 MDAL::XdmfFunctionDataset::~XdmfFunctionDataset() = default;
 
-void MDAL::XdmfFunctionDataset::addReferenceDataset(
-  const HyperSlab &slab,
-  const HdfDataset &hdfDataset,
-  const MDAL::RelativeTimestamp &time )
+void MDAL::XdmfFunctionDataset::addReferenceDataset( const HyperSlab &slab, const HdfDataset &hdfDataset )
 {
-  std::shared_ptr<MDAL::XdmfDataset> xdmfDataset = std::make_shared<MDAL::XdmfDataset>(
-        &mBaseReferenceGroup,
-        slab,
-        hdfDataset,
-        time
-      );
-  mReferenceDatasets.emplace_back( std::move( xdmfDataset ) );
+  mReferences.emplace_back( slab, hdfDataset );
 }
 
 void MDAL::XdmfFunctionDataset::swap()
 {
-  if ( mReferenceDatasets.size() < 2 )
+  if ( mReferences.size() < 2 )
     return;
-  std::swap( mReferenceDatasets[0], mReferenceDatasets[1] );
+  std::swap( mReferences[0], mReferences[1] );
 }
 
 size_t MDAL::XdmfFunctionDataset::scalarData( size_t indexStart, size_t count, double *buffer )
@@ -152,13 +200,9 @@ size_t MDAL::XdmfFunctionDataset::scalarData( size_t indexStart, size_t count, d
   assert( group()->isScalar() ); //checked in C API interface
   assert( mType != FunctionType::Join );
 
-  if ( mType == FunctionType::Subtract )
-    return subtractFunction( indexStart, count, buffer );
-
-  if ( mType == FunctionType::Flow )
-    return flowFunction( indexStart, count, buffer );
-
-  return 0;
+  std::call_once( mCompileFlag, [this] { compile(); } );
+  return MDAL::BlockCache::read( this, mValuesCount, 1, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return evaluate( start, n, values ); } );
 }
 
 size_t MDAL::XdmfFunctionDataset::vectorData( size_t indexStart, size_t count, double *buffer )
@@ -166,84 +210,149 @@ size_t MDAL::XdmfFunctionDataset::vectorData( size_t indexStart, size_t count, d
   assert( !group()->isScalar() ); //checked in C API interface
   assert( mType == FunctionType::Join );
 
-  return joinFunction( indexStart, count, buffer );
+  std::call_once( mCompileFlag, [this] { compile(); } );
+  return MDAL::BlockCache::read( this, mValuesCount, 2, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return evaluate( start, n, values ); } );
 }
 
-size_t MDAL::XdmfFunctionDataset::subtractFunction( size_t indexStart, size_t count, double *buffer )
+void MDAL::XdmfFunctionDataset::compile()
 {
-  std::vector<double> buf( 2 * count, std::numeric_limits<double>::quiet_NaN() );
-  size_t copyVals = extractRawData( indexStart, count, 2, buf );
-  for ( size_t j = 0; j < copyVals; ++j )
-  {
-    double x0 = buf[j];
-    double x1 = buf[count + j];
-    if ( !std::isnan( x0 ) && !std::isnan( x1 ) )
-      buffer[j] = x1 - x0;
-  }
-  return copyVals;
-}
+  // indexes of the reference datasets used as operands of the kernel
+  std::vector<size_t> operands;
+  switch ( mType )
+  {
+    case FunctionType::Subtract:
+      mKernel = &_subtractKernel;
+      operands = {0, 1};
+      break;
+    case FunctionType::Join:
+      mKernel = &_joinKernel;
+      operands = {0, 1};
+      break;
+    case FunctionType::Flow:
+      // $1 is used for both components, as in the values evaluated by previous versions
+      mKernel = &_flowKernel;
+      operands = {1, 1, 2, 3};
+      break;
+  }
+
+  mValuesCount = std::numeric_limits<size_t>::max();
+  for ( size_t operand = 0; operand < operands.size(); ++operand )
+  {
+    const size_t reference = operands[operand];
+    if ( reference >= mReferences.size() || !mReferences[reference].first.isScalar )
+    {
+      mKernel = nullptr;
+      mValuesCount = 0;
+      mReads.clear();
+      return;
+    }
 
-size_t MDAL::XdmfFunctionDataset::flowFunction( size_t indexStart, size_t count, double *buffer )
-{
-  std::vector<double> buf( 4 * count, std::numeric_limits<double>::quiet_NaN() );
-  size_t copyVals = extractRawData( indexStart, count, 4, buf );
-  for ( size_t j = 0; j < copyVals; ++j )
-  {
-    double x0 = buf[1 * count + j];
-    double x1 = buf[1 * count + j];
-    double x2 = buf[2 * count + j];
-    double x3 = buf[3 * count + j];
-
-    if ( !std::isnan( x0 ) &&
-         !std::isnan( x1 ) &&
-         !std::isnan( x2 ) &&
-         !MDAL::equals( x2, x3 )
-       )
+    const HyperSlab &slab = mReferences[reference].first;
+    const HdfDataset &hdfDataset = mReferences[reference].second;
+    mValuesCount = std::min( mValuesCount, slab.count );
+
+    // columns of the same array are read together
+    SlabRead *read = nullptr;
+    for ( SlabRead &other : mReads )
     {
-      double diff = x2 - x3;
-      buffer[j] = sqrt( ( x0 / diff ) * ( x0 / diff ) + ( x1 / diff ) * ( x1 / diff ) );
+      if ( slab.countInFirstColumn &&
+           other.slab.countInFirstColumn &&
+           other.hdfDataset.id() == hdfDataset.id() &&
+           other.slab.startX == slab.startX &&
+           other.slab.count == slab.count )
+      {
+        read = &other;
+        break;
+      }
+    }
+
+    if ( !read )
+    {
+      mReads.emplace_back();
+      read = &mReads.back();
+      read->hdfDataset = hdfDataset;
+      read->slab = slab;
     }
+    read->operands.emplace_back( operand, slab.startY );
   }
-  return copyVals;
-}
+  mOperandCount = operands.size();
 
-size_t MDAL::XdmfFunctionDataset::joinFunction( size_t indexStart, size_t count, double *buffer )
-{
-  std::vector<double> buf( 2 * count, std::numeric_limits<double>::quiet_NaN() );
-  size_t copyVals = extractRawData( indexStart, count, 2, buf );
-  for ( size_t j = 0; j < copyVals; ++j )
+  for ( SlabRead &read : mReads )
   {
-    double x = buf[j];
-    double y = buf[count + j];
-    if ( !std::isnan( x ) && !std::isnan( y ) )
+    size_t firstColumn = read.slab.startY;
+    size_t lastColumn = read.slab.startY;
+    for ( const std::pair<size_t, size_t> &operand : read.operands )
     {
-      buffer[2 * j] = x;
-      buffer[2 * j + 1] = y;
+      firstColumn = std::min( firstColumn, operand.second );
+      lastColumn = std::max( lastColumn, operand.second );
     }
+
+    read.slab.startY = firstColumn;
+    read.columnCount = lastColumn - firstColumn + 1;
+    for ( std::pair<size_t, size_t> &operand : read.operands )
+      operand.second -= firstColumn;
   }
-  return copyVals;
 }
 
-size_t MDAL::XdmfFunctionDataset::extractRawData( size_t indexStart, size_t count, size_t nDatasets, std::vector< double > &buf )
+size_t MDAL::XdmfFunctionDataset::evaluate( size_t indexStart, size_t count, double *buffer )
 {
-  assert( buf.size() == nDatasets * count );
-
-  if ( mReferenceDatasets.size() < nDatasets )
+  if ( !mKernel || indexStart >= mValuesCount || count == 0 )
     return 0;
+  count = std::min( count, mValuesCount - indexStart );
 
-  if ( !mReferenceDatasets[0]->group()->isScalar() )
+  std::vector<double> values( mOperandCount * count );
+  if ( readOperands( indexStart, count, values.data() ) != count )
     return 0;
 
-  size_t ret = mReferenceDatasets[0]->scalarData( indexStart, count, buf.data() );
-  for ( size_t i = 1; i < nDatasets ; ++i )
+  std::vector<const double *> operands( mOperandCount );
+  for ( size_t i = 0; i < mOperandCount; ++i )
+    operands[i] = values.data() + i * count;
+
+  mKernel( operands.data(), count, buffer );
+  return count;
+}
+
+size_t MDAL::XdmfFunctionDataset::readOperands( size_t indexStart, size_t count, double *buffer ) const
+{
+  std::vector<double> columns;
+  for ( const SlabRead &read : mReads )
   {
-    if ( !mReferenceDatasets[i]->group()->isScalar() )
-      return 0;
-    size_t ret1 = mReferenceDatasets[i]->scalarData( indexStart, count, buf.data() + count * i );
-    if ( ret != ret1 )
-      return 0;
+    const std::vector<hsize_t> offsets = {read.slab.startX + indexStart, read.slab.startY};
+    double *first = buffer + read.operands.front().first * count;
+
+    if ( !read.slab.countInFirstColumn )
+    {
+      if ( !read.hdfDataset.readArrayDouble( offsets, {1, count}, first ) )
+        return 0;
+    }
+    else if ( read.columnCount == 1 )
+    {
+      if ( !read.hdfDataset.readArrayDouble( offsets, {count, 1}, first ) )
+        return 0;
+    }
+    else
+    {
+      // [value][column] array of all columns, split to the operands
+      columns.resize( count * read.columnCount );
+      if ( !read.hdfDataset.readArrayDouble( offsets, {count, read.columnCount}, columns.data() ) )
+        return 0;
+
+      for ( const std::pair<size_t, size_t> &operand : read.operands )
+      {
+        double *output = buffer + operand.first * count;
+        const double *input = columns.data() + operand.second;
+        for ( size_t j = 0; j < count; ++j )
+          output[j] = input[j * read.columnCount];
+      }
+      continue;
+    }
+
+    // the same column used for more operands
+    for ( size_t i = 1; i < read.operands.size(); ++i )
+      std::copy( first, first + count, buffer + read.operands[i].first * count );
   }
-  return ret;
+  return count;
 }
 
 // //////////////////////////////////////////////////////////////////////////////
@@ -341,7 +450,11 @@ HdfDataset MDAL::DriverXdmf::parseHdf5Node( const XMLFile &xmfFile, xmlNodePtr n
   if ( !hdfFile->isValid() )
     throw MDAL::Error( MDAL_Status::Err_InvalidData, "invalid or missing file: " + hdf5Name );
 
-  return hdfFile->dataset( hdf5Path );
+  const std::string key = hdf5Name + ":" + hdf5Path;
+  auto it = mHdfDatasets.find( key );
+  if ( it == mHdfDatasets.end() )
+    it = mHdfDatasets.emplace( key, hdfFile->dataset( hdf5Path ) ).first;
+  return it->second;
 }
 
 void MDAL::DriverXdmf::hdf5NamePath( const std::string &dataItemPath, std::string &filePath, std::string &hdf5Path )
@@ -504,7 +617,7 @@ MDAL::DatasetGroups MDAL::DriverXdmf::parseXdmfXml( )
             xmfFile.checkAttribute( dataNod, "Type", "HyperSlab" ) )
           {
             std::pair<HdfDataset, HyperSlab> data = parseXdmfDataset( xmfFile, dataNod );
-            xdmfFunctionDataset->addReferenceDataset( data.second, data.first, time );
+            xdmfFunctionDataset->addReferenceDataset( data.second, data.first );
           }
           else
           {
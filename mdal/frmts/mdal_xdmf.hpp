@@ -13,6 +13,7 @@
 #include <iostream>
 #include <fstream>
 #include <utility>
+#include <mutex>
 
 #include "mdal_data_model.hpp"
 #include "mdal.h"
@@ -72,6 +73,10 @@ namespace MDAL
       std::vector<hsize_t> offsets( size_t indexStart );
       std::vector<hsize_t> selections( size_t copyValues );
 
+      //! Reads values from the file, see BlockCache
+      size_t readScalarData( size_t indexStart, size_t count, double *buffer );
+      size_t readVectorData( size_t indexStart, size_t count, double *buffer );
+
       HdfDataset mHdf5DatasetValues;
       HyperSlab mHyperSlab;
   };
@@ -89,6 +94,10 @@ namespace MDAL
    *   - join ( [A, B] vector)
    *   - magnitude
    *
+   * On the first read, the function is compiled to a kernel evaluated on whole
+   * arrays of operands. Operands stored as columns of the same HDF5 array are
+   * read with one hyperslab. Evaluated values are kept in the BlockCache.
+   *
    * The definition is stored in XML file in format:
    *
    * <Attribute Name="..." AttributeType="Scalar" Center="Cell">
@@ -114,8 +123,8 @@ namespace MDAL
                          );
       ~XdmfFunctionDataset() override;
 
-      //! Adds reference XMDF dataset
-      void addReferenceDataset( const HyperSlab &slab, const HdfDataset &hdfDataset, const RelativeTimestamp &time );
+      //! Adds reference scalar hyperslab
+      void addReferenceDataset( const HyperSlab &slab, const HdfDataset &hdfDataset );
       //! Swaps first and second reference dataset
       void swap();
 
@@ -123,19 +132,35 @@ namespace MDAL
       size_t vectorData( size_t indexStart, size_t count, double *buffer ) override;
 
     private:
-      size_t subtractFunction( size_t indexStart, size_t count, double *buffer );
-      size_t flowFunction( size_t indexStart, size_t count, double *buffer );
-      size_t joinFunction( size_t indexStart, size_t count, double *buffer );
-      size_t extractRawData( size_t indexStart, size_t count, size_t nDatasets, std::vector<double> &buf );
+      //! Operands read with one hyperslab, columns of the same HDF5 array
+      struct SlabRead
+      {
+        HdfDataset hdfDataset;
+        HyperSlab slab; //!< slab of the first column
+        size_t columnCount = 1;
+        std::vector<std::pair<size_t, size_t>> operands; //!< index of the operand and its column in the slab
+      };
+
+      //! Evaluates the function for count values, operands are arrays of count values
+      typedef void ( *Kernel )( const double *const *operands, size_t count, double *buffer );
+
+      //! Chooses the kernel and plans the reads of its operands
+      void compile();
+
+      //! Evaluates the function from the file, see BlockCache
+      size_t evaluate( size_t indexStart, size_t count, double *buffer );
+
+      //! Reads the operands to consecutive arrays of count values, returns number of values of each operand
+      size_t readOperands( size_t indexStart, size_t count, double *buffer ) const;
 
       const FunctionType mType;
-      std::vector<std::shared_ptr<XdmfDataset>> mReferenceDatasets;
-      /**
-       * "fake" base group for reference datasets.
-       * This group is not exposed to public API and
-       * it is just an implementation detail.
-       */
-      DatasetGroup mBaseReferenceGroup;
+      std::vector<std::pair<HyperSlab, HdfDataset>> mReferences;
+
+      std::once_flag mCompileFlag;
+      Kernel mKernel = nullptr;
+      size_t mOperandCount = 0;
+      size_t mValuesCount = 0;
+      std::vector<SlabRead> mReads;
   };
 
   class DriverXdmf: public Driver
@@ -224,6 +249,8 @@ namespace MDAL
       MDAL::Mesh *mMesh = nullptr;
       std::string mDatFile;
       std::map< std::string, std::shared_ptr<HdfFile> > mHdfFiles;
+      //! opened datasets by file name and path, functions recognize the same array by its handle
+      std::map< std::string, HdfDataset > mHdfDatasets;
 
   };
 
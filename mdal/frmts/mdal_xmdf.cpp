@@ -9,6 +9,7 @@
 #include "mdal_data_model.hpp"
 #include "mdal_hdf5.hpp"
 #include "mdal_logger.hpp"
+#include "mdal_block_cache.hpp"
 
 #include <string>
 #include <vector>
@@ -45,47 +46,134 @@ hsize_t MDAL::XmdfDataset::timeIndex() const
 size_t MDAL::XmdfDataset::scalarData( size_t indexStart, size_t count, double *buffer )
 {
   assert( group()->isScalar() ); //checked in C API interface
+  return MDAL::BlockCache::read( this, valuesCount(), 1, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readScalarData( start, n, values ); } );
+}
+
+size_t MDAL::XmdfDataset::vectorData( size_t indexStart, size_t count, double *buffer )
+{
+  assert( !group()->isScalar() ); //checked in C API interface
+  return MDAL::BlockCache::read( this, valuesCount(), 2, indexStart, count, buffer,
+                                 [this]( size_t start, size_t n, double * values ) { return readVectorData( start, n, values ); } );
+}
+
+size_t MDAL::XmdfDataset::readScalarData( size_t indexStart, size_t count, double *buffer )
+{
   std::vector<hsize_t> offsets = {timeIndex(), indexStart};
   std::vector<hsize_t> counts = {1, count};
-  std::vector<float> values = dsValues().readArray( offsets, counts );
-  const float *input = values.data();
-  for ( size_t j = 0; j < count; ++j )
-  {
-    buffer[j] = double( input[j] );
-  }
+  if ( !dsValues().readArrayDouble( offsets, counts, buffer ) )
+    return 0;
   return count;
 }
 
-size_t MDAL::XmdfDataset::vectorData( size_t indexStart, size_t count, double *buffer )
+size_t MDAL::XmdfDataset::readVectorData( size_t indexStart, size_t count, double *buffer )
 {
-  assert( !group()->isScalar() ); //checked in C API interface
   std::vector<hsize_t> offsets = {timeIndex(), indexStart, 0};
-  std::vector<float> values = dsValues().readArray( offsets, {1, count, 2} );
-  const float *input = values.data();
-  for ( size_t j = 0; j < count; ++j )
+  if ( !dsValues().readArrayDouble( offsets, {1, count, 2}, buffer ) )
+    return 0;
+
+  return count;
+}
+
+bool MDAL::XmdfDataset::timeSeriesData( const size_t *elementIndexes, size_t elementCount, size_t datasetCount, double *buffer )
+{
+  // values of all timesteps are stored in one 2D (or 3D for vectors) array, [time][value]([component])
+  const size_t index = indexInGroup();
+  const Datasets &datasets = group()->datasets;
+  if ( index + datasetCount > datasets.size() )
+    return false;
+
+  for ( size_t i = 1; i < datasetCount; ++i )
   {
-    buffer[2 * j] = double( input[2 * j] );
-    buffer[2 * j + 1] = double( input[2 * j + 1] );
+    const XmdfDataset *dataset = dynamic_cast<const XmdfDataset *>( datasets[index + i].get() );
+    if ( !dataset || dataset->dsValues().id() != dsValues().id() || dataset->timeIndex() != timeIndex() + i )
+      return false;
   }
 
-  return count;
+  const bool isScalar = group()->isScalar();
+  const size_t valuesPerItem = isScalar ? 1 : 2;
+  for ( size_t e = 0; e < elementCount; ++e )
+  {
+    double *target = buffer + e * datasetCount * valuesPerItem;
+    bool ok;
+    if ( isScalar )
+      ok = dsValues().readArrayDouble( {timeIndex(), elementIndexes[e]}, {datasetCount, 1}, target );
+    else
+      ok = dsValues().readArrayDouble( {timeIndex(), elementIndexes[e], 0}, {datasetCount, 1, 2}, target );
+
+    if ( !ok )
+      return false;
+  }
+  return true;
+}
+
+std::shared_ptr<const std::vector<uint64_t>> MDAL::XmdfDataset::activeBits()
+{
+  const size_t facesCount = mesh()->facesCount();
+  if ( !dsActive().isValid() || facesCount == 0 || MDAL::BlockCache::budget() == 0 )
+    return nullptr;
+
+  std::shared_ptr<const std::vector<uint64_t>> bits = MDAL::BlockCache::activeFlags( this, timeIndex() );
+  if ( bits )
+    return bits;
+
+  std::vector<uchar> active = dsActive().readArrayUint8( {timeIndex(), 0}, {1, facesCount} );
+  if ( active.size() != facesCount )
+    return nullptr;
+
+  std::shared_ptr<std::vector<uint64_t>> readBits = std::make_shared<std::vector<uint64_t>>( ( facesCount + 63 ) / 64, 0 );
+  for ( size_t i = 0; i < facesCount; ++i )
+  {
+    if ( active[i] )
+      ( *readBits )[i >> 6] |= uint64_t( 1 ) << ( i & 63 );
+  }
+  MDAL::BlockCache::insertActiveFlags( this, timeIndex(), readBits );
+  return readBits;
 }
 
 size_t MDAL::XmdfDataset::activeData( size_t indexStart, size_t count, int *buffer )
 {
-  if ( !dsActive().isValid() )
+  const size_t facesCount = mesh()->facesCount();
+  if ( indexStart >= facesCount )
     return 0;
-  std::vector<hsize_t> offsets = {timeIndex(), indexStart};
-  std::vector<hsize_t> counts = {1, count};
-  std::vector<uchar> active = dsActive().readArrayUint8( offsets, counts );
-  const uchar *input = active.data();
+  count = std::min( count, facesCount - indexStart );
+
+  std::shared_ptr<const std::vector<uint64_t>> bits = activeBits();
+  if ( !bits )
+  {
+    if ( !dsActive().isValid() )
+      return 0;
+
+    std::vector<uchar> active = dsActive().readArrayUint8( {timeIndex(), indexStart}, {1, count} );
+    if ( active.size() != count )
+      return 0;
+    for ( size_t j = 0; j < count; ++j )
+      buffer[j] = active[j] ? 1 : 0;
+    return count;
+  }
+
   for ( size_t j = 0; j < count; ++j )
   {
-    buffer[j] = bool( input[ j ] );
+    const size_t i = indexStart + j;
+    buffer[j] = static_cast<int>( ( ( *bits )[i >> 6] >> ( i & 63 ) ) & 1 );
   }
   return count;
 }
 
+size_t MDAL::XmdfDataset::dataWithActive( double *buffer, int *active )
+{
+  const size_t count = valuesCount();
+  const size_t valuesRead = group()->isScalar() ? readScalarData( 0, count, buffer ) : readVectorData( 0, count, buffer );
+
+  if ( active )
+  {
+    const size_t facesCount = mesh()->facesCount();
+    if ( activeData( 0, facesCount, active ) != facesCount )
+      std::fill( active, active + facesCount, 1 );
+  }
+  return valuesRead;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 MDAL::DriverXmdf::DriverXmdf()
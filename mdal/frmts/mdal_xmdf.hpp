@@ -12,6 +12,7 @@
 #include <iosfwd>
 #include <iostream>
 #include <fstream>
+#include <stdint.h>
 
 #include "mdal_data_model.hpp"
 #include "mdal.h"
@@ -48,11 +49,27 @@ namespace MDAL
       size_t vectorData( size_t indexStart, size_t count, double *buffer ) override;
       size_t activeData( size_t indexStart, size_t count, int *buffer ) override;
 
+      //! Reads all values with one hyperslab, active flags come from the cache, see activeBits()
+      size_t dataWithActive( double *buffer, int *active ) override;
+
+      bool timeSeriesData( const size_t *elementIndexes, size_t elementCount, size_t datasetCount, double *buffer ) override;
+
       const HdfDataset &dsValues() const;
       const HdfDataset &dsActive() const;
       hsize_t timeIndex() const;
 
     private:
+      //! Reads values from the file, see BlockCache
+      size_t readScalarData( size_t indexStart, size_t count, double *buffer );
+      size_t readVectorData( size_t indexStart, size_t count, double *buffer );
+
+      /**
+       * Returns active flags of all faces packed to bits, the whole row of flags is read
+       * from the file and kept in the block cache, so it is dropped with other blocks
+       * over the budget. Null if there are no flags or the cache is disabled
+       */
+      std::shared_ptr<const std::vector<uint64_t>> activeBits();
+
       HdfDataset mHdf5DatasetValues;
       HdfDataset mHdf5DatasetActive;
       // index or row where the data for this timestep begins
@@ -8,15 +8,36 @@
 #include <limits>
 #include <assert.h>
 #include <memory>
+#include <algorithm>
 
 #include "mdal.h"
+#include "mdal_config.hpp"
 #include "mdal_driver_manager.hpp"
 #include "mdal_data_model.hpp"
 #include "mdal_utils.hpp"
 #include "mdal_logger.hpp"
+#include "mdal_statistics_cache.hpp"
+#include "mdal_block_cache.hpp"
+#include "mdal_prefetcher.hpp"
+#include "frmts/mdal_ascii_dat.hpp"
+
+#ifdef HAVE_HDF5
+#include "frmts/mdal_hdf5.hpp"
+#endif
+#ifdef HAVE_NETCDF
+#include "frmts/mdal_netcdf.hpp"
+#endif
 
 #define NODATA std::numeric_limits<double>::quiet_NaN()
 
+/**
+ * Holds the I/O lock (local variable ioLock) until the end of the scope
+ *
+ * Drivers and libraries they use are not thread-safe, so API functions that can reach
+ * the drivers are serialized with the background reading of datasets, see Prefetcher.
+ */
+#define MDAL_API_LOCK() MDAL::Prefetcher::IoLock ioLock = MDAL::Prefetcher::lockIo()
+
 static const char *EMPTY_STR = "";
 
 const char *MDAL_Version()
@@ -60,6 +81,124 @@ void MDAL_SetLogVerbosity( MDAL_LogLevel verbosity )
   MDAL::Log::setLogVerbosity( verbosity );
 }
 
+void MDAL_SetLazyStatistics( bool lazy )
+{
+  MDAL::setLazyStatistics( lazy );
+}
+
+bool MDAL_LazyStatistics()
+{
+  return MDAL::lazyStatistics();
+}
+
+void MDAL_SetStatisticsCache( bool enabled, const char *cacheDirectory )
+{
+  MDAL::StatisticsCache::setEnabled( enabled, cacheDirectory ? std::string( cacheDirectory ) : std::string() );
+}
+
+void MDAL_SetBlockCacheSize( long long bytes )
+{
+  MDAL::BlockCache::setBudget( static_cast<size_t>( std::max( 0LL, bytes ) ) );
+}
+
+long long MDAL_BlockCacheSize()
+{
+  return static_cast<long long>( MDAL::BlockCache::budget() );
+}
+
+void MDAL_SetNetCDFChunkCacheSize( long long bytes )
+{
+#ifdef HAVE_NETCDF
+  NetCDFFile::setChunkCacheBudget( static_cast<size_t>( std::max( 0LL, bytes ) ) );
+#else
+  MDAL_UNUSED( bytes );
+#endif
+}
+
+long long MDAL_NetCDFChunkCacheSize()
+{
+#ifdef HAVE_NETCDF
+  return static_cast<long long>( NetCDFFile::chunkCacheBudget() );
+#else
+  return 0;
+#endif
+}
+
+void MDAL_SetNetCDFCompression( int deflateLevel, bool shuffle )
+{
+#ifdef HAVE_NETCDF
+  NetCDFFile::setCompression( deflateLevel, shuffle );
+#else
+  MDAL_UNUSED( deflateLevel );
+  MDAL_UNUSED( shuffle );
+#endif
+}
+
+int MDAL_NetCDFCompressionLevel()
+{
+#ifdef HAVE_NETCDF
+  return NetCDFFile::compressionLevel();
+#else
+  return 0;
+#endif
+}
+
+void MDAL_SetHdf5CacheSizes( long long chunkCacheBytes, long long metadataCacheBytes, long long sieveBufferBytes )
+{
+#ifdef HAVE_HDF5
+  HdfFile::setCacheSizes(
+    chunkCacheBytes < 0 ? HdfFile::chunkCacheBudget() : static_cast<size_t>( chunkCacheBytes ),
+    metadataCacheBytes < 0 ? HdfFile::metadataCacheSize() : static_cast<size_t>( metadataCacheBytes ),
+    sieveBufferBytes < 0 ? HdfFile::sieveBufferSize() : static_cast<size_t>( sieveBufferBytes ) );
+#else
+  MDAL_UNUSED( chunkCacheBytes );
+  MDAL_UNUSED( metadataCacheBytes );
+  MDAL_UNUSED( sieveBufferBytes );
+#endif
+}
+
+void MDAL_Hdf5CacheSizes( long long *chunkCacheBytes, long long *metadataCacheBytes, long long *sieveBufferBytes )
+{
+#ifdef HAVE_HDF5
+  if ( chunkCacheBytes )
+    *chunkCacheBytes = static_cast<long long>( HdfFile::chunkCacheBudget() );
+  if ( metadataCacheBytes )
+    *metadataCacheBytes = static_cast<long long>( HdfFile::metadataCacheSize() );
+  if ( sieveBufferBytes )
+    *sieveBufferBytes = static_cast<long long>( HdfFile::sieveBufferSize() );
+#else
+  if ( chunkCacheBytes )
+    *chunkCacheBytes = 0;
+  if ( metadataCacheBytes )
+    *metadataCacheBytes = 0;
+  if ( sieveBufferBytes )
+    *sieveBufferBytes = 0;
+#endif
+}
+
+void MDAL_SetAsciiDatIndexedMode( bool indexed )
+{
+  MDAL::DriverAsciiDat::setIndexedMode( indexed );
+}
+
+bool MDAL_AsciiDatIndexedMode()
+{
+  return MDAL::DriverAsciiDat::isIndexedMode();
+}
+
+void MDAL_BlockCacheCounters( long long *hits, long long *misses )
+{
+  if ( hits )
+    *hits = static_cast<long long>( MDAL::BlockCache::hits() );
+  if ( misses )
+    *misses = static_cast<long long>( MDAL::BlockCache::misses() );
+}
+
+void MDAL_ClearBlockCache()
+{
+  MDAL::BlockCache::clear();
+}
+
 // helper to return string data - without having to deal with memory too much.
 // returned pointer is valid only next call. also not thread-safe.
 const char *_return_str( const std::string &str )
@@ -188,6 +327,8 @@ int MDAL_DR_faceVerticesMaximumCount( MDAL_DriverH driver )
 
 MDAL_MeshH MDAL_LoadMesh( const char *uri )
 {
+  MDAL_API_LOCK();
+
   if ( !uri )
   {
     MDAL::Log::error( MDAL_Status::Err_FileNotFound, "Mesh file is not valid (null)" );
@@ -208,6 +349,8 @@ MDAL_MeshH MDAL_LoadMesh( const char *uri )
 
 const char *MDAL_MeshNames( const char *uri )
 {
+  MDAL_API_LOCK();
+
   if ( !uri )
   {
     MDAL::Log::error( MDAL_Status::Err_FileNotFound, "Mesh file is not valid (null)" );
@@ -226,6 +369,8 @@ const char *MDAL_MeshNames( const char *uri )
 
 void MDAL_SaveMesh( MDAL_MeshH mesh, const char *meshFile, const char *driver )
 {
+  MDAL_API_LOCK();
+
   MDAL::Log::resetLastStatus();
   if ( !meshFile )
   {
@@ -264,6 +409,8 @@ void MDAL_SaveMesh( MDAL_MeshH mesh, const char *meshFile, const char *driver )
 
 void MDAL_SaveMeshWithUri( MDAL_MeshH mesh, const char *uri )
 {
+  MDAL_API_LOCK();
+
   MDAL::Log::resetLastStatus();
 
   std::string meshFile;
@@ -303,9 +450,12 @@ void MDAL_SaveMeshWithUri( MDAL_MeshH mesh, const char *uri )
 
 void MDAL_CloseMesh( MDAL_MeshH mesh )
 {
+  MDAL_API_LOCK();
+
   if ( mesh )
   {
     MDAL::Mesh *m = static_cast< MDAL::Mesh * >( mesh );
+    MDAL::StatisticsCache::store( m );
     delete m;
   }
 }
@@ -324,6 +474,8 @@ const char *MDAL_M_projection( MDAL_MeshH mesh )
 
 void MDAL_M_extent( MDAL_MeshH mesh, double *minX, double *maxX, double *minY, double *maxY )
 {
+  MDAL_API_LOCK();
+
   if ( !mesh )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleMesh, "Mesh is not valid (null)" );
@@ -396,6 +548,8 @@ int MDAL_M_faceVerticesMaximumCount( MDAL_MeshH mesh )
 
 void MDAL_M_LoadDatasets( MDAL_MeshH mesh, const char *datasetFile )
 {
+  MDAL_API_LOCK();
+
   if ( !datasetFile )
   {
     MDAL::Log::error( MDAL_Status::Err_FileNotFound, "Dataset file is not valid (null)" );
@@ -416,6 +570,8 @@ void MDAL_M_LoadDatasets( MDAL_MeshH mesh, const char *datasetFile )
 
 int MDAL_M_metadataCount( MDAL_MeshH mesh )
 {
+  MDAL_API_LOCK();
+
   if ( !mesh )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleMesh, "Mesh is not valid (null)" );
@@ -428,6 +584,8 @@ int MDAL_M_metadataCount( MDAL_MeshH mesh )
 
 const char *MDAL_M_metadataKey( MDAL_MeshH mesh, int index )
 {
+  MDAL_API_LOCK();
+
   if ( !mesh )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleMesh, "Mesh is not valid (null)" );
@@ -446,6 +604,8 @@ const char *MDAL_M_metadataKey( MDAL_MeshH mesh, int index )
 
 const char *MDAL_M_metadataValue( MDAL_MeshH mesh, int index )
 {
+  MDAL_API_LOCK();
+
   if ( !mesh )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleMesh,  "Mesh is not valid (null)" );
@@ -534,6 +694,8 @@ MDAL_DatasetGroupH MDAL_M_addDatasetGroup(
   MDAL_DriverH driver,
   const char *datasetGroupFile )
 {
+  MDAL_API_LOCK();
+
   if ( !mesh )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleMesh, "Mesh is not valid (null)" );
@@ -582,6 +744,8 @@ MDAL_DatasetGroupH MDAL_M_addDatasetGroup(
 
 void MDAL_M_RemoveDatasetGroup( MDAL_MeshH mesh, int index )
 {
+  MDAL_API_LOCK();
+
   MDAL::Log::resetLastStatus();
 
   if ( !mesh )
@@ -626,6 +790,8 @@ const char *MDAL_M_driverName( MDAL_MeshH mesh )
 
 MDAL_MeshVertexIteratorH MDAL_M_vertexIterator( MDAL_MeshH mesh )
 {
+  MDAL_API_LOCK();
+
   if ( !mesh )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleMesh, "Mesh is not valid (null)" );
@@ -638,6 +804,8 @@ MDAL_MeshVertexIteratorH MDAL_M_vertexIterator( MDAL_MeshH mesh )
 
 int MDAL_VI_next( MDAL_MeshVertexIteratorH iterator, int verticesCount, double *coordinates )
 {
+  MDAL_API_LOCK();
+
   if ( verticesCount < 1 )
     return 0;
 
@@ -659,6 +827,8 @@ int MDAL_VI_next( MDAL_MeshVertexIteratorH iterator, int verticesCount, double *
 
 void MDAL_VI_close( MDAL_MeshVertexIteratorH iterator )
 {
+  MDAL_API_LOCK();
+
   if ( iterator )
   {
     MDAL::MeshVertexIterator *it = static_cast< MDAL::MeshVertexIterator * >( iterator );
@@ -672,6 +842,8 @@ void MDAL_VI_close( MDAL_MeshVertexIteratorH iterator )
 
 MDAL_MeshEdgeIteratorH MDAL_M_edgeIterator( MDAL_MeshH mesh )
 {
+  MDAL_API_LOCK();
+
   if ( !mesh )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleMesh, "Mesh is not valid (null)" );
@@ -684,6 +856,8 @@ MDAL_MeshEdgeIteratorH MDAL_M_edgeIterator( MDAL_MeshH mesh )
 
 int MDAL_EI_next( MDAL_MeshEdgeIteratorH iterator, int edgesCount, int *startVertexIndices, int *endVertexIndices )
 {
+  MDAL_API_LOCK();
+
   if ( edgesCount < 1 )
     return 0;
 
@@ -707,6 +881,8 @@ int MDAL_EI_next( MDAL_MeshEdgeIteratorH iterator, int edgesCount, int *startVer
 
 void MDAL_EI_close( MDAL_MeshEdgeIteratorH iterator )
 {
+  MDAL_API_LOCK();
+
   if ( iterator )
   {
     MDAL::MeshVertexIterator *it = static_cast< MDAL::MeshVertexIterator * >( iterator );
@@ -720,6 +896,8 @@ void MDAL_EI_close( MDAL_MeshEdgeIteratorH iterator )
 
 MDAL_MeshFaceIteratorH MDAL_M_faceIterator( MDAL_MeshH mesh )
 {
+  MDAL_API_LOCK();
+
   if ( !mesh )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleMesh, "Mesh is not valid (null)" );
@@ -736,6 +914,8 @@ int MDAL_FI_next( MDAL_MeshFaceIteratorH iterator,
                   int vertexIndicesBufferLen,
                   int *vertexIndicesBuffer )
 {
+  MDAL_API_LOCK();
+
   if ( ( faceOffsetsBufferLen < 1 ) || ( vertexIndicesBufferLen < 1 ) )
     return 0;
 
@@ -755,6 +935,8 @@ int MDAL_FI_next( MDAL_MeshFaceIteratorH iterator,
 
 void MDAL_FI_close( MDAL_MeshFaceIteratorH iterator )
 {
+  MDAL_API_LOCK();
+
   if ( iterator )
   {
     MDAL::MeshFaceIterator *it = static_cast< MDAL::MeshFaceIterator * >( iterator );
@@ -818,6 +1000,8 @@ MDAL_DatasetH MDAL_G_dataset( MDAL_DatasetGroupH group, int index )
 
 int MDAL_G_metadataCount( MDAL_DatasetGroupH group )
 {
+  MDAL_API_LOCK();
+
   if ( !group )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset Group is not valid (null)" );
@@ -830,6 +1014,8 @@ int MDAL_G_metadataCount( MDAL_DatasetGroupH group )
 
 const char *MDAL_G_metadataKey( MDAL_DatasetGroupH group, int index )
 {
+  MDAL_API_LOCK();
+
   if ( !group )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset Group is not valid (null)" );
@@ -848,6 +1034,8 @@ const char *MDAL_G_metadataKey( MDAL_DatasetGroupH group, int index )
 
 const char *MDAL_G_metadataValue( MDAL_DatasetGroupH group, int index )
 {
+  MDAL_API_LOCK();
+
   if ( !group )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset Group is not valid (null)" );
@@ -921,8 +1109,93 @@ int MDAL_G_maximumVerticalLevelCount( MDAL_DatasetGroupH group )
   return len;
 }
 
+void MDAL_G_setPrefetchWindow( MDAL_DatasetGroupH group, int window )
+{
+  if ( !group )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset Group is not valid (null)" );
+    return;
+  }
+  MDAL::DatasetGroup *g = static_cast< MDAL::DatasetGroup * >( group );
+  g->setPrefetchWindow( static_cast<size_t>( std::max( 0, window ) ) );
+}
+
+int MDAL_G_prefetchWindow( MDAL_DatasetGroupH group )
+{
+  if ( !group )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset Group is not valid (null)" );
+    return 0;
+  }
+  MDAL::DatasetGroup *g = static_cast< MDAL::DatasetGroup * >( group );
+  return static_cast<int>( g->prefetchWindow() );
+}
+
+void MDAL_WaitForPrefetching()
+{
+  // without the I/O lock, the background thread needs it to read
+  MDAL::Prefetcher::waitUntilIdle();
+}
+
+int MDAL_G_timeSeries( MDAL_DatasetGroupH group, int elementIndex, int datasetIndexStart, int count, double *buffer )
+{
+  return MDAL_G_timeSeriesBatch( group, &elementIndex, 1, datasetIndexStart, count, buffer );
+}
+
+int MDAL_G_timeSeriesBatch( MDAL_DatasetGroupH group,
+                            const int *elementIndexes,
+                            int elementCount,
+                            int datasetIndexStart,
+                            int count,
+                            double *buffer )
+{
+  if ( !group )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset Group is not valid (null)" );
+    return 0;
+  }
+
+  if ( !elementIndexes || !buffer || elementCount < 1 || datasetIndexStart < 0 || count < 1 )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Invalid arguments" );
+    return 0;
+  }
+
+  MDAL::DatasetGroup *g = static_cast< MDAL::DatasetGroup * >( group );
+  if ( ( g->dataLocation() != MDAL_DataLocation::DataOnVertices ) && ( g->dataLocation() != MDAL_DataLocation::DataOnFaces ) && ( g->dataLocation() != MDAL_DataLocation::DataOnEdges ) )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Time series only supported on datasets with data on vertices, faces or edges" );
+    return 0;
+  }
+
+  const size_t indexStart = static_cast<size_t>( datasetIndexStart );
+  if ( indexStart >= g->datasets.size() )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Requested index: " + std::to_string( datasetIndexStart ) + " is out of scope for datasets" );
+    return 0;
+  }
+
+  const size_t valuesCount = g->datasets[indexStart]->valuesCount();
+  std::vector<size_t> indexes( static_cast<size_t>( elementCount ) );
+  for ( size_t e = 0; e < indexes.size(); ++e )
+  {
+    if ( elementIndexes[e] < 0 || static_cast<size_t>( elementIndexes[e] ) >= valuesCount )
+    {
+      MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Requested element index: " + std::to_string( elementIndexes[e] ) + " is out of scope for dataset values" );
+      return 0;
+    }
+    indexes[e] = static_cast<size_t>( elementIndexes[e] );
+  }
+
+  MDAL_API_LOCK();
+
+  return static_cast<int>( g->timeSeries( indexes.data(), indexes.size(), indexStart, static_cast<size_t>( count ), buffer ) );
+}
+
 void MDAL_G_minimumMaximum( MDAL_DatasetGroupH group, double *min, double *max )
 {
+  MDAL_API_LOCK();
+
   if ( !min || !max )
   {
     MDAL::Log::error( MDAL_Status::Err_InvalidData, "Passed pointers min or max are not valid (null)" );
@@ -943,8 +1216,26 @@ void MDAL_G_minimumMaximum( MDAL_DatasetGroupH group, double *min, double *max )
   *max = stats.maximum;
 }
 
+void MDAL_G_computeStatistics( MDAL_DatasetGroupH group )
+{
+  MDAL_API_LOCK();
+
+  if ( !group )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset Group is not valid (null)" );
+    return;
+  }
+
+  MDAL::DatasetGroup *g = static_cast< MDAL::DatasetGroup * >( group );
+  for ( const std::shared_ptr<MDAL::Dataset> &ds : g->datasets )
+    ds->statistics();
+  g->statistics();
+}
+
 MDAL_DatasetH MDAL_G_addDataset( MDAL_DatasetGroupH group, double time, const double *values, const int *active )
 {
+  MDAL_API_LOCK();
+
   if ( !group )
   {
     MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset Group is not valid (null)" );
@@ -1065,6 +1356,8 @@ bool MDAL_G_isInEditMode( MDAL_DatasetGroupH group )
 
 void MDAL_G_closeEditMode( MDAL_DatasetGroupH group )
 {
+  MDAL_API_LOCK();
+
   MDAL::Log::resetLastStatus();
   if ( !group )
   {
@@ -1078,7 +1371,7 @@ void MDAL_G_closeEditMode( MDAL_DatasetGroupH group )
     return;
   }
 
-  g->setStatistics( MDAL::calculateStatistics( g ) );
+  MDAL::updateStatistics( g );
   g->stopEditing();
 
   const std::string driverName = g->driverName();
@@ -1357,6 +1650,9 @@ int MDAL_D_data( MDAL_DatasetH dataset, int indexStart, int count, MDAL_DataType
 
   // Request data
   size_t writtenValuesCount = 0;
+
+  MDAL_API_LOCK();
+
   switch ( dataType )
   {
     case MDAL_DataType::SCALAR_DOUBLE:
@@ -1385,11 +1681,109 @@ int MDAL_D_data( MDAL_DatasetH dataset, int indexStart, int count, MDAL_DataType
       break;
   }
 
+  if ( ioLock.owns_lock() )
+    ioLock.unlock();
+
+  if ( g->prefetchWindow() > 0 &&
+       ( dataType == MDAL_DataType::SCALAR_DOUBLE || dataType == MDAL_DataType::VECTOR_2D_DOUBLE ) )
+  {
+    for ( size_t i = 0; i < g->datasets.size(); ++i )
+    {
+      if ( g->datasets[i].get() == d )
+      {
+        MDAL::Prefetcher::datasetRead( g, i );
+        break;
+      }
+    }
+  }
+
   return static_cast<int>( writtenValuesCount );
 }
 
+int MDAL_D_dataWithActive( MDAL_DatasetH dataset, MDAL_DataType dataType, void *buffer, int *activeBuffer )
+{
+  if ( !dataset )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset is not valid (null)" );
+    return 0;
+  }
+  MDAL::Dataset *d = static_cast< MDAL::Dataset * >( dataset );
+  MDAL::DatasetGroup *g = d->group();
+  assert( g );
+
+  if ( dataType != MDAL_DataType::SCALAR_DOUBLE && dataType != MDAL_DataType::VECTOR_2D_DOUBLE )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Only scalar or vector values can be read with active flags" );
+    return 0;
+  }
+
+  if ( ( dataType == MDAL_DataType::SCALAR_DOUBLE ) != g->isScalar() )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, g->isScalar() ? "Dataset Group is scalar" : "Dataset Group is not scalar" );
+    return 0;
+  }
+
+  if ( g->dataLocation() == MDAL_DataLocation::DataOnVolumes )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset Group has data on volumes in 3D" );
+    return 0;
+  }
+
+  if ( !buffer )
+  {
+    MDAL::Log::error( MDAL_Status::Err_InvalidData, "Buffer is not valid (null)" );
+    return 0;
+  }
+
+  MDAL_API_LOCK();
+
+  const size_t writtenValuesCount = d->dataWithActive( static_cast<double *>( buffer ), activeBuffer );
+  return static_cast<int>( writtenValuesCount );
+}
+
+bool MDAL_D_hasDataPtrCapability( MDAL_DatasetH dataset, MDAL_DataType dataType )
+{
+  if ( !dataset )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset is not valid (null)" );
+    return false;
+  }
+
+  MDAL_API_LOCK();
+
+  MDAL::Dataset *d = static_cast< MDAL::Dataset * >( dataset );
+  size_t stride = 0;
+  return d->dataPointer( dataType, stride ) != nullptr;
+}
+
+const void *MDAL_D_dataPtr( MDAL_DatasetH dataset, MDAL_DataType dataType, int *stride )
+{
+  MDAL_API_LOCK();
+
+  if ( !dataset )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset is not valid (null)" );
+    return nullptr;
+  }
+
+  MDAL::Dataset *d = static_cast< MDAL::Dataset * >( dataset );
+  size_t strideSizeT = 0;
+  const void *ptr = d->dataPointer( dataType, strideSizeT );
+  if ( !ptr )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset does not support direct access to the data type" );
+    return nullptr;
+  }
+
+  if ( stride )
+    *stride = static_cast<int>( strideSizeT );
+  return ptr;
+}
+
 void MDAL_D_minimumMaximum( MDAL_DatasetH dataset, double *min, double *max )
 {
+  MDAL_API_LOCK();
+
   if ( !min || !max )
   {
     MDAL::Log::error( MDAL_Status::Err_InvalidData, "Passed pointers min or max are not valid (null)" );
@@ -1410,6 +1804,20 @@ void MDAL_D_minimumMaximum( MDAL_DatasetH dataset, double *min, double *max )
   *max = stats.maximum;
 }
 
+void MDAL_D_computeStatistics( MDAL_DatasetH dataset )
+{
+  MDAL_API_LOCK();
+
+  if ( !dataset )
+  {
+    MDAL::Log::error( MDAL_Status::Err_IncompatibleDataset, "Dataset is not valid (null)" );
+    return;
+  }
+
+  MDAL::Dataset *ds = static_cast< MDAL::Dataset * >( dataset );
+  ds->statistics();
+}
+
 bool MDAL_D_hasActiveFlagCapability( MDAL_DatasetH dataset )
 {
   if ( !dataset )
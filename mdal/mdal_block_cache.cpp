@@ -0,0 +1,273 @@
+/*
+ MDAL - Mesh Data Abstraction Library (MIT License)
+ Copyright (C) 2026 Lutra Consulting Ltd.
+*/
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <tuple>
+#include <algorithm>
+#include <string.h>
+
+#include "mdal_block_cache.hpp"
+#include "mdal_utils.hpp"
+
+//! Number of items (scalar or vector values) in one block
+static const size_t BLOCK_SIZE = 1 << 16;
+
+//! Kind of the cached entry, part of its key
+enum class EntryKind
+{
+  Values,
+  ActiveFlags
+};
+
+//! dataset, kind of the entry and index of the block (values) or of the timestep (active flags)
+typedef std::tuple<const MDAL::Dataset *, EntryKind, size_t> BlockKey;
+
+struct CachedBlock
+{
+  BlockKey key;
+  //! std::vector<double> for values, std::vector<uint64_t> for active flags
+  std::shared_ptr<const void> data;
+  size_t bytes;
+};
+
+typedef std::list<CachedBlock> BlockList;
+
+static MDAL::Setting sBudget( "MDAL_BLOCK_CACHE_MB", 1024 * 1024, 64LL * 1024 * 1024 );
+
+static std::mutex sBlockCacheMutex;
+static size_t sUsedBytes = 0;
+static size_t sHits = 0;
+static size_t sMisses = 0;
+//! the most recently used first
+static BlockList sBlocks;
+static std::map<BlockKey, BlockList::iterator> sBlockIndex;
+//! avoids locking when datasets are deleted and nothing is cached
+static std::atomic<size_t> sBlocksCount( 0 );
+//! set by BlockCache::ScanScope
+static thread_local bool sScan = false;
+
+// expects locked mutex
+static void _removeBlock( BlockList::iterator it )
+{
+  sUsedBytes -= it->bytes;
+  sBlockIndex.erase( it->key );
+  sBlocks.erase( it );
+  sBlocksCount = sBlocks.size();
+}
+
+// expects locked mutex
+static void _evict()
+{
+  const size_t budget = static_cast<size_t>( sBudget.value() );
+  while ( !sBlocks.empty() && sUsedBytes > budget )
+    _removeBlock( std::prev( sBlocks.end() ) );
+}
+
+static std::shared_ptr<const void> _findBlock( const BlockKey &key )
+{
+  std::lock_guard<std::mutex> lock( sBlockCacheMutex );
+  auto found = sBlockIndex.find( key );
+  if ( found == sBlockIndex.end() )
+    return nullptr;
+
+  ++sHits;
+  sBlocks.splice( sBlocks.begin(), sBlocks, found->second );
+  return found->second->data;
+}
+
+static void _insertBlock( const BlockKey &key, std::shared_ptr<const void> data, size_t bytes )
+{
+  std::lock_guard<std::mutex> lock( sBlockCacheMutex );
+  ++sMisses;
+  if ( sBlockIndex.find( key ) != sBlockIndex.end() )
+    return; // read by other thread meanwhile
+
+  CachedBlock block;
+  block.key = key;
+  block.data = std::move( data );
+  block.bytes = bytes;
+  sUsedBytes += bytes;
+  sBlocks.push_front( block );
+  sBlockIndex[key] = sBlocks.begin();
+  sBlocksCount = sBlocks.size();
+  _evict();
+}
+
+MDAL::BlockCache::ScanScope::ScanScope()
+  : mPreviousScan( sScan )
+{
+  sScan = true;
+}
+
+MDAL::BlockCache::ScanScope::~ScanScope()
+{
+  sScan = mPreviousScan;
+}
+
+size_t MDAL::BlockCache::budget()
+{
+  return static_cast<size_t>( sBudget.value() );
+}
+
+void MDAL::BlockCache::setBudget( size_t bytes )
+{
+  std::lock_guard<std::mutex> lock( sBlockCacheMutex );
+  sBudget.setValue( static_cast<long long>( bytes ) );
+  _evict();
+}
+
+size_t MDAL::BlockCache::usedBytes()
+{
+  std::lock_guard<std::mutex> lock( sBlockCacheMutex );
+  return sUsedBytes;
+}
+
+std::shared_ptr<const std::vector<uint64_t>> MDAL::BlockCache::activeFlags( const Dataset *dataset, size_t timeIndex )
+{
+  if ( budget() == 0 )
+    return nullptr;
+  return std::static_pointer_cast<const std::vector<uint64_t>>( _findBlock( BlockKey( dataset, EntryKind::ActiveFlags, timeIndex ) ) );
+}
+
+void MDAL::BlockCache::insertActiveFlags( const Dataset *dataset, size_t timeIndex, std::shared_ptr<const std::vector<uint64_t>> bits )
+{
+  const size_t bytes = bits->size() * sizeof( uint64_t );
+  if ( bytes > budget() )
+    return;
+  _insertBlock( BlockKey( dataset, EntryKind::ActiveFlags, timeIndex ), std::move( bits ), bytes );
+}
+
+size_t MDAL::BlockCache::hits()
+{
+  std::lock_guard<std::mutex> lock( sBlockCacheMutex );
+  return sHits;
+}
+
+size_t MDAL::BlockCache::misses()
+{
+  std::lock_guard<std::mutex> lock( sBlockCacheMutex );
+  return sMisses;
+}
+
+void MDAL::BlockCache::clear()
+{
+  std::lock_guard<std::mutex> lock( sBlockCacheMutex );
+  sBlocks.clear();
+  sBlockIndex.clear();
+  sBlocksCount = 0;
+  sUsedBytes = 0;
+  sHits = 0;
+  sMisses = 0;
+}
+
+void MDAL::BlockCache::removeDataset( const Dataset *dataset )
+{
+  if ( sBlocksCount == 0 )
+    return;
+
+  std::lock_guard<std::mutex> lock( sBlockCacheMutex );
+  auto it = sBlockIndex.lower_bound( BlockKey( dataset, EntryKind::Values, 0 ) );
+  while ( it != sBlockIndex.end() && std::get<0>( it->first ) == dataset )
+  {
+    BlockList::iterator block = it->second;
+    ++it;
+    _removeBlock( block );
+  }
+}
+
+size_t MDAL::BlockCache::blockSize()
+{
+  return BLOCK_SIZE;
+}
+
+size_t MDAL::BlockCache::read( const Dataset *dataset,
+                               size_t valuesCount,
+                               size_t valuesPerItem,
+                               size_t indexStart,
+                               size_t count,
+                               double *buffer,
+                               const ReadFunction &read )
+{
+  if ( ( count < 1 ) || ( indexStart >= valuesCount ) )
+    return 0;
+
+  const size_t copyValues = std::min( valuesCount - indexStart, count );
+
+  const size_t cacheBudget = budget();
+  if ( cacheBudget == 0 )
+    return read( indexStart, copyValues, buffer );
+
+  const size_t firstBlock = indexStart / BLOCK_SIZE;
+  const size_t lastBlock = ( indexStart + copyValues - 1 ) / BLOCK_SIZE;
+
+  // one-off scans would only replace the cached blocks and requests larger than the budget would
+  // evict their own blocks, such requests use cached blocks, but read the missing values directly to the buffer
+  const bool insertBlocks = !sScan && copyValues * valuesPerItem * sizeof( double ) <= cacheBudget;
+
+  std::vector<std::shared_ptr<const std::vector<double>>> blocks( lastBlock - firstBlock + 1 );
+  for ( size_t blockIndex = firstBlock; blockIndex <= lastBlock; ++blockIndex )
+    blocks[blockIndex - firstBlock] = std::static_pointer_cast<const std::vector<double>>( _findBlock( BlockKey( dataset, EntryKind::Values, blockIndex ) ) );
+
+  const size_t indexEnd = indexStart + copyValues;
+  size_t blockIndex = firstBlock;
+  while ( blockIndex <= lastBlock )
+  {
+    const size_t blockStart = blockIndex * BLOCK_SIZE;
+    std::shared_ptr<const std::vector<double>> values = blocks[blockIndex - firstBlock];
+    if ( values )
+    {
+      const size_t from = std::max( indexStart, blockStart );
+      const size_t to = std::min( indexEnd, blockStart + BLOCK_SIZE );
+      memcpy( buffer + ( from - indexStart ) * valuesPerItem,
+              values->data() + ( from - blockStart ) * valuesPerItem,
+              ( to - from ) * valuesPerItem * sizeof( double ) );
+      ++blockIndex;
+      continue;
+    }
+
+    // consecutive missing blocks are read at once to limit number of reads
+    size_t missingLast = blockIndex;
+    while ( missingLast < lastBlock && !blocks[missingLast + 1 - firstBlock] )
+      ++missingLast;
+
+    const size_t from = std::max( indexStart, blockStart );
+    const size_t to = std::min( indexEnd, ( missingLast + 1 ) * BLOCK_SIZE );
+    if ( !insertBlocks )
+    {
+      if ( read( from, to - from, buffer + ( from - indexStart ) * valuesPerItem ) != to - from )
+        return read( indexStart, copyValues, buffer );
+      blockIndex = missingLast + 1;
+      continue;
+    }
+
+    const size_t readCount = std::min( valuesCount, ( missingLast + 1 ) * BLOCK_SIZE ) - blockStart;
+    std::vector<double> readValues( readCount * valuesPerItem );
+    if ( read( blockStart, readCount, readValues.data() ) != readCount )
+    {
+      // let the driver handle the original request
+      return read( indexStart, copyValues, buffer );
+    }
+
+    memcpy( buffer + ( from - indexStart ) * valuesPerItem,
+            readValues.data() + ( from - blockStart ) * valuesPerItem,
+            ( to - from ) * valuesPerItem * sizeof( double ) );
+
+    for ( ; blockIndex <= missingLast; ++blockIndex )
+    {
+      const size_t offset = ( blockIndex * BLOCK_SIZE - blockStart ) * valuesPerItem;
+      const size_t blockValues = std::min( BLOCK_SIZE * valuesPerItem, readValues.size() - offset );
+      _insertBlock( BlockKey( dataset, EntryKind::Values, blockIndex ),
+                    std::make_shared<std::vector<double>>( readValues.begin() + offset, readValues.begin() + offset + blockValues ),
+                    blockValues * sizeof( double ) );
+    }
+  }
+
+  return copyValues;
+}
@@ -0,0 +1,104 @@
+/*
+ MDAL - Mesh Data Abstraction Library (MIT License)
+ Copyright (C) 2026 Lutra Consulting Ltd.
+*/
+
+#ifndef MDAL_BLOCK_CACHE_HPP
+#define MDAL_BLOCK_CACHE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace MDAL
+{
+  class Dataset;
+
+  /**
+   * Namespace including functions for the process-wide cache of dataset values
+   *
+   * Drivers that read values of datasets from the file on request (lazy datasets) read
+   * whole blocks of values through the cache, so repeated requests of the same values
+   * do not read and convert the data again. The least recently used blocks are dropped
+   * when the size of the cached blocks exceeds the budget. Reads within a ScanScope
+   * (e.g. whole dataset for statistics) only use the cached blocks, the rest is read
+   * directly to the buffer of the request.
+   *
+   * The budget is set by MDAL_SetBlockCacheSize() or by environment variable
+   * MDAL_BLOCK_CACHE_MB (in megabytes), default is 64 MB. Zero budget disables the cache.
+   * Active flags of datasets (see activeFlags()) are cached as blocks within the same budget.
+   */
+  namespace BlockCache
+  {
+    //! Returns maximum size of cached blocks in bytes
+    size_t budget();
+
+    //! Sets maximum size of cached blocks in bytes, drops blocks above the budget
+    void setBudget( size_t bytes );
+
+    //! Returns size of cached blocks in bytes
+    size_t usedBytes();
+
+    //! Returns number of blocks found in the cache since last clear()
+    size_t hits();
+
+    //! Returns number of blocks read from the file to the cache since last clear()
+    size_t misses();
+
+    //! Returns active flags (bits) of the dataset at \a timeIndex cached by insertActiveFlags(), null when not cached
+    std::shared_ptr<const std::vector<uint64_t>> activeFlags( const Dataset *dataset, size_t timeIndex );
+
+    //! Caches active flags (bits) of the dataset at \a timeIndex, dropped like the blocks of values
+    void insertActiveFlags( const Dataset *dataset, size_t timeIndex, std::shared_ptr<const std::vector<uint64_t>> bits );
+
+    //! Drops all blocks and resets counters
+    void clear();
+
+    //! Drops all blocks of the dataset, called when the dataset is deleted
+    void removeDataset( const Dataset *dataset );
+
+    //! Returns number of items (scalar or vector values) in one block
+    size_t blockSize();
+
+    /**
+     * Marks reads of the current thread as a one-off scan while the object exists
+     *
+     * Blocks missing in the cache are read directly to the buffer of the request and not
+     * inserted, so a single pass over many datasets does not drop the blocks read repeatedly.
+     */
+    class ScanScope
+    {
+      public:
+        ScanScope();
+        ~ScanScope();
+        ScanScope( const ScanScope & ) = delete;
+        ScanScope &operator=( const ScanScope & ) = delete;
+
+      private:
+        bool mPreviousScan;
+    };
+
+    //! Function reading \a count values from \a indexStart to buffer, returns number of read values
+    typedef std::function<size_t( size_t indexStart, size_t count, double *buffer )> ReadFunction;
+
+    /**
+     * Reads values of the dataset through the cache
+     * \param dataset dataset, part of the key of the blocks
+     * \param valuesCount total number of values of the dataset
+     * \param valuesPerItem 1 for scalar values, 2 for vector values
+     * \param read reads the values from the file, called for blocks that are not cached
+     * \returns number of values copied to buffer
+     */
+    size_t read( const Dataset *dataset,
+                 size_t valuesCount,
+                 size_t valuesPerItem,
+                 size_t indexStart,
+                 size_t count,
+                 double *buffer,
+                 const ReadFunction &read );
+  }
+}
+
+#endif // MDAL_BLOCK_CACHE_HPP
@@ -8,8 +8,13 @@
 #include <math.h>
 #include <algorithm>
 #include "mdal_utils.hpp"
+#include "mdal_block_cache.hpp"
+#include "mdal_prefetcher.hpp"
 
-MDAL::Dataset::~Dataset() = default;
+MDAL::Dataset::~Dataset()
+{
+  MDAL::BlockCache::removeDataset( this );
+}
 
 MDAL::Dataset::Dataset( MDAL::DatasetGroup *parent )
   : mParent( parent )
@@ -37,14 +42,74 @@ size_t MDAL::Dataset::activeData( size_t, size_t, int * )
   return 0;
 }
 
+const void *MDAL::Dataset::dataPointer( MDAL_DataType, size_t & ) const
+{
+  return nullptr;
+}
+
+bool MDAL::Dataset::timeSeriesData( const size_t *, size_t, size_t, double * )
+{
+  return false;
+}
+
+size_t MDAL::Dataset::dataWithActive( double *buffer, int *active )
+{
+  if ( group()->dataLocation() == MDAL_DataLocation::DataOnVolumes )
+    return 0;
+
+  const size_t count = valuesCount();
+  const size_t valuesRead = group()->isScalar() ? scalarData( 0, count, buffer ) : vectorData( 0, count, buffer );
+
+  if ( active )
+  {
+    const size_t facesCount = mesh()->facesCount();
+    if ( !supportsActiveFlag() || activeData( 0, facesCount, active ) != facesCount )
+      std::fill( active, active + facesCount, 1 );
+  }
+  return valuesRead;
+}
+
+size_t MDAL::Dataset::indexInGroup() const
+{
+  const Datasets &datasets = group()->datasets;
+  for ( size_t i = 0; i < datasets.size(); ++i )
+  {
+    if ( datasets[i].get() == this )
+      return i;
+  }
+  return datasets.size();
+}
+
 MDAL::Statistics MDAL::Dataset::statistics() const
 {
+  std::lock_guard<std::mutex> lock( mStatisticsMutex );
+  if ( !mHasStatistics )
+  {
+    // reading of the data is not const for most of the drivers
+    mStatistics = MDAL::calculateStatistics( const_cast<MDAL::Dataset *>( this ) );
+    mHasStatistics = true;
+  }
   return mStatistics;
 }
 
 void MDAL::Dataset::setStatistics( const MDAL::Statistics &statistics )
 {
+  std::lock_guard<std::mutex> lock( mStatisticsMutex );
   mStatistics = statistics;
+  mHasStatistics = true;
+}
+
+bool MDAL::Dataset::hasStatistics() const
+{
+  std::lock_guard<std::mutex> lock( mStatisticsMutex );
+  return mHasStatistics;
+}
+
+void MDAL::Dataset::resetStatistics()
+{
+  std::lock_guard<std::mutex> lock( mStatisticsMutex );
+  mStatistics = Statistics();
+  mHasStatistics = false;
 }
 
 MDAL::DatasetGroup *MDAL::Dataset::group() const
@@ -153,7 +218,10 @@ std::string MDAL::DatasetGroup::driverName() const
   return mDriverName;
 }
 
-MDAL::DatasetGroup::~DatasetGroup() = default;
+MDAL::DatasetGroup::~DatasetGroup()
+{
+  setPrefetchWindow( 0 );
+}
 
 MDAL::DatasetGroup::DatasetGroup( const std::string &driverName,
                                   MDAL::Mesh *parent,
@@ -220,12 +288,33 @@ void MDAL::DatasetGroup::replaceUri( std::string uri )
 
 MDAL::Statistics MDAL::DatasetGroup::statistics() const
 {
+  std::lock_guard<std::mutex> lock( mStatisticsMutex );
+  if ( !mHasStatistics )
+  {
+    mStatistics = MDAL::calculateStatistics( const_cast<MDAL::DatasetGroup *>( this ) );
+    mHasStatistics = true;
+  }
   return mStatistics;
 }
 
 void MDAL::DatasetGroup::setStatistics( const Statistics &statistics )
 {
+  std::lock_guard<std::mutex> lock( mStatisticsMutex );
   mStatistics = statistics;
+  mHasStatistics = true;
+}
+
+bool MDAL::DatasetGroup::hasStatistics() const
+{
+  std::lock_guard<std::mutex> lock( mStatisticsMutex );
+  return mHasStatistics;
+}
+
+void MDAL::DatasetGroup::resetStatistics()
+{
+  std::lock_guard<std::mutex> lock( mStatisticsMutex );
+  mStatistics = Statistics();
+  mHasStatistics = false;
 }
 
 MDAL::DateTime MDAL::DatasetGroup::referenceTime() const
@@ -243,6 +332,72 @@ MDAL::Mesh *MDAL::DatasetGroup::mesh() const
   return mParent;
 }
 
+size_t MDAL::DatasetGroup::timeSeries( const size_t *elementIndexes,
+                                       size_t elementCount,
+                                       size_t datasetIndexStart,
+                                       size_t count,
+                                       double *buffer )
+{
+  if ( datasetIndexStart >= datasets.size() || elementCount == 0 )
+    return 0;
+
+  count = std::min( count, datasets.size() - datasetIndexStart );
+  if ( count == 0 )
+    return 0;
+
+  if ( datasets[datasetIndexStart]->timeSeriesData( elementIndexes, elementCount, count, buffer ) )
+    return count;
+
+  const size_t valuesPerItem = isScalar() ? 1 : 2;
+  const MDAL_DataType dataType = isScalar() ? MDAL_DataType::SCALAR_DOUBLE : MDAL_DataType::VECTOR_2D_DOUBLE;
+
+  // elements close to each other are read with one request
+  const size_t minIndex = *std::min_element( elementIndexes, elementIndexes + elementCount );
+  const size_t maxIndex = *std::max_element( elementIndexes, elementIndexes + elementCount );
+  const size_t span = maxIndex - minIndex + 1;
+  const bool readSpan = elementCount > 1 && span <= 64 * elementCount;
+  std::vector<double> values( valuesPerItem * ( readSpan ? span : 1 ) );
+
+  for ( size_t t = 0; t < count; ++t )
+  {
+    Dataset *dataset = datasets[datasetIndexStart + t].get();
+
+    size_t stride = 0;
+    const double *data = static_cast<const double *>( dataset->dataPointer( dataType, stride ) );
+    if ( data )
+    {
+      for ( size_t e = 0; e < elementCount; ++e )
+        for ( size_t k = 0; k < valuesPerItem; ++k )
+          buffer[( e * count + t ) * valuesPerItem + k] = data[elementIndexes[e] * stride + k];
+      continue;
+    }
+
+    if ( readSpan )
+    {
+      const size_t read = isScalar() ? dataset->scalarData( minIndex, span, values.data() )
+                          : dataset->vectorData( minIndex, span, values.data() );
+      if ( read != span )
+        return t;
+
+      for ( size_t e = 0; e < elementCount; ++e )
+        for ( size_t k = 0; k < valuesPerItem; ++k )
+          buffer[( e * count + t ) * valuesPerItem + k] = values[( elementIndexes[e] - minIndex ) * valuesPerItem + k];
+      continue;
+    }
+
+    for ( size_t e = 0; e < elementCount; ++e )
+    {
+      double *target = buffer + ( e * count + t ) * valuesPerItem;
+      const size_t read = isScalar() ? dataset->scalarData( elementIndexes[e], 1, target )
+                          : dataset->vectorData( elementIndexes[e], 1, target );
+      if ( read != 1 )
+        return t;
+    }
+  }
+
+  return count;
+}
+
 size_t MDAL::DatasetGroup::maximumVerticalLevelsCount() const
 {
   size_t maxLevels = 0;
@@ -285,6 +440,25 @@ void MDAL::DatasetGroup::setIsPolar( bool isPolar )
   mIsPolar = isPolar;
 }
 
+size_t MDAL::DatasetGroup::prefetchWindow() const
+{
+  return mPrefetchWindow;
+}
+
+void MDAL::DatasetGroup::setPrefetchWindow( size_t window )
+{
+  if ( window > 0 && mPrefetchWindow == 0 )
+    MDAL::Prefetcher::setGroupEnabled( true );
+
+  if ( window == 0 && mPrefetchWindow > 0 )
+  {
+    MDAL::Prefetcher::cancel( this );
+    MDAL::Prefetcher::setGroupEnabled( false );
+  }
+
+  mPrefetchWindow = window;
+}
+
 std::pair<double, double> MDAL::DatasetGroup::referenceAngles() const
 {
   return mReferenceAngles;
@@ -12,6 +12,7 @@
 #include <map>
 #include <string>
 #include <limits>
+#include <mutex>
 #include "mdal.h"
 #include "mdal_datetime.hpp"
 
@@ -55,6 +56,30 @@ namespace MDAL
       //! For drivers that supports it, see supportsActiveFlag()
       virtual size_t activeData( size_t indexStart, size_t count, int *buffer );
 
+      /**
+       * Returns pointer to the internal storage of the data of the type, for datasets
+       * that keep the whole data in memory, nullptr if the data needs to be read
+       * \param stride number of doubles/ints between two consecutive values
+       */
+      virtual const void *dataPointer( MDAL_DataType dataType, size_t &stride ) const;
+
+      /**
+       * Reads values of the elements in \a datasetCount datasets of the group starting with this dataset,
+       * ordered by element and then by dataset, two values per item for vector data.
+       * Drivers that can read a time series of an element with a single (strided) read reimplement it
+       * \returns false when the values need to be read dataset by dataset, see DatasetGroup::timeSeries()
+       */
+      virtual bool timeSeriesData( const size_t *elementIndexes, size_t elementCount, size_t datasetCount, double *buffer );
+
+      /**
+       * Reads all values (scalar or vector) of the dataset on vertices, faces or edges
+       * and the active flags of all faces in one call.
+       * Drivers that can read the flags together with the values (e.g. with a single access to the file) reimplement it
+       * \param active buffer for faces count flags, may be null. All faces are active for datasets without active flag
+       * \returns number of values read
+       */
+      virtual size_t dataWithActive( double *buffer, int *active );
+
       //! For DataOnVolumes
       virtual size_t verticalLevelCountData( size_t indexStart, size_t count, int *buffer ) = 0;
       //! For DataOnVolumes
@@ -69,9 +94,19 @@ namespace MDAL
       virtual size_t volumesCount() const = 0;
       virtual size_t maximumVerticalLevelsCount() const = 0;
 
+      /**
+       * Returns statistics of the dataset
+       * When statistics are not set, they are calculated on the first call and cached
+       */
       Statistics statistics() const;
       void setStatistics( const Statistics &statistics );
 
+      //! Returns whether statistics are set, i.e. statistics() does not need to read the data
+      bool hasStatistics() const;
+
+      //! Drops the statistics, they are calculated again on next statistics() call
+      void resetStatistics();
+
       bool isValid() const;
 
       DatasetGroup *group() const;
@@ -85,12 +120,19 @@ namespace MDAL
       bool supportsActiveFlag() const;
       void setSupportsActiveFlag( bool value );
 
+    protected:
+      //! Returns index of the dataset in its group, number of datasets in the group if not found
+      size_t indexInGroup() const;
+
     private:
       RelativeTimestamp mTime;
       bool mIsValid = true;
       bool mSupportsActiveFlag = false;
       DatasetGroup *mParent = nullptr;
-      Statistics mStatistics;
+      //! guards lazy calculation of statistics, datasets can be read from more threads (see Prefetcher)
+      mutable std::mutex mStatisticsMutex;
+      mutable Statistics mStatistics;
+      mutable bool mHasStatistics = false;
   };
 
   class Dataset2D: public Dataset
@@ -169,9 +211,19 @@ namespace MDAL
       std::string uri() const;
       void replaceUri( std::string uri );
 
+      /**
+       * Returns statistics of the group
+       * When statistics are not set, they are combined from datasets statistics on the first call and cached
+       */
       Statistics statistics() const;
       void setStatistics( const Statistics &statistics );
 
+      //! Returns whether statistics are set, i.e. statistics() does not need to read the data
+      bool hasStatistics() const;
+
+      //! Drops the statistics, they are calculated again on next statistics() call
+      void resetStatistics();
+
       DateTime referenceTime() const;
       void setReferenceTime( const DateTime &referenceTime );
 
@@ -189,8 +241,29 @@ namespace MDAL
 
       bool isPolar() const;
       void setIsPolar( bool isPolar );
+
+      //! Returns number of datasets read ahead of the requested one, 0 when prefetching is disabled
+      size_t prefetchWindow() const;
+
+      /**
+       * Sets number of datasets read in background after the requested one, see Prefetcher
+       * 0 disables prefetching (default)
+       */
+      void setPrefetchWindow( size_t window );
+
+      /**
+       * Reads values of the elements (vertices, faces or edges) in \a count datasets starting with \a datasetIndexStart
+       * \param buffer elementCount * count values, two values per item for vector data, ordered by element and then by dataset
+       * \returns number of datasets read
+       */
+      size_t timeSeries( const size_t *elementIndexes,
+                         size_t elementCount,
+                         size_t datasetIndexStart,
+                         size_t count,
+                         double *buffer );
     private:
       bool mInEditMode = false;
+      size_t mPrefetchWindow = 0;
 
       const std::string mDriverName;
       Mesh *mParent = nullptr;
@@ -199,7 +272,10 @@ namespace MDAL
       std::pair<double, double> mReferenceAngles = { -360, 0}; //default full rotation is negative to be consistent with usual geographical clockwise
       MDAL_DataLocation mDataLocation = MDAL_DataLocation::DataOnVertices;
       std::string mUri; // file/uri from where it came
-      Statistics mStatistics;
+      //! guards lazy calculation of statistics, datasets can be read from more threads (see Prefetcher)
+      mutable std::mutex mStatisticsMutex;
+      mutable Statistics mStatistics;
+      mutable bool mHasStatistics = false;
       DateTime mReferenceTime;
   };
 
@@ -14,6 +14,7 @@
 #include "frmts/mdal_mike21.hpp"
 #include "frmts/mdal_dynamic_driver.hpp"
 #include "mdal_utils.hpp"
+#include "mdal_statistics_cache.hpp"
 
 #ifdef BUILD_PLY
 #include "frmts/mdal_ply.hpp"
@@ -109,6 +110,8 @@ std::unique_ptr<MDAL::Mesh> MDAL::DriverManager::load( const std::string &meshFi
 
   if ( !mesh )
     MDAL::Log::error( MDAL_Status::Err_UnknownFormat, "Unable to load mesh (null)" );
+  else
+    MDAL::StatisticsCache::restore( mesh.get(), meshFile );
 
   return mesh;
 }
@@ -136,6 +139,8 @@ std::unique_ptr<MDAL::Mesh> MDAL::DriverManager::load(
 
   std::unique_ptr<Driver> drv( requestedDriver->create() );
   mesh = drv->load( meshFile, meshName );
+  if ( mesh )
+    MDAL::StatisticsCache::restore( mesh.get(), meshFile );
 
   return mesh;
 }
@@ -161,6 +166,7 @@ void MDAL::DriverManager::loadDatasets( Mesh *mesh, const std::string &datasetFi
     {
       std::unique_ptr<Driver> drv( driver->create() );
       drv->load( datasetFile, mesh );
+      MDAL::StatisticsCache::restore( mesh, datasetFile );
       return;
     }
   }
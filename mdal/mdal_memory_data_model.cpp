@@ -41,7 +41,24 @@ size_t MDAL::MemoryDataset2D::activeData( size_t indexStart, size_t count, int *
   return copyValues;
 }
 
-void MDAL::MemoryDataset2D::activateFaces( MDAL::MemoryMesh *mesh )
+const void *MDAL::MemoryDataset2D::dataPointer( MDAL_DataType dataType, size_t &stride ) const
+{
+  stride = 1;
+  switch ( dataType )
+  {
+    case MDAL_DataType::SCALAR_DOUBLE:
+      return group()->isScalar() ? mValues.data() : nullptr;
+    case MDAL_DataType::VECTOR_2D_DOUBLE:
+      stride = 2;
+      return group()->isScalar() ? nullptr : mValues.data();
+    case MDAL_DataType::ACTIVE_INTEGER:
+      return supportsActiveFlag() ? mActive.data() : nullptr;
+    default:
+      return nullptr;
+  }
+}
+
+void MDAL::MemoryDataset2D::activateFaces( MDAL::Mesh *mesh )
 {
   assert( mesh );
   assert( supportsActiveFlag() );
@@ -50,35 +67,43 @@ void MDAL::MemoryDataset2D::activateFaces( MDAL::MemoryMesh *mesh )
   bool isScalar = group()->isScalar();
 
   // Activate only Faces that do all Vertex's outputs with some data
-  const size_t nFaces = mesh->facesCount();
+  const size_t faceChunkSize = 1000;
+  const size_t maxVerticesPerFace = mesh->faceVerticesMaximumCount();
+  std::vector<int> faceOffsets( faceChunkSize );
+  std::vector<int> vertexIndices( faceChunkSize * maxVerticesPerFace );
 
-  const Faces &faces = mesh->faces();
-  for ( unsigned int idx = 0; idx < nFaces; ++idx )
+  std::unique_ptr<MDAL::MeshFaceIterator> faceIterator = mesh->readFaces();
+  size_t faceIndex = 0;
+  size_t facesRead;
+  while ( ( facesRead = faceIterator->next( faceChunkSize, faceOffsets.data(), vertexIndices.size(), vertexIndices.data() ) ) > 0 )
   {
-    const Face &elem = faces.at( idx );
-    const std::size_t elemSize = elem.size();
-    for ( size_t i = 0; i < elemSize; ++i )
+    int faceStart = 0;
+    for ( size_t i = 0; i < facesRead; ++i, ++faceIndex )
     {
-      const size_t vertexIndex = elem[i];
-      if ( isScalar )
+      for ( int j = faceStart; j < faceOffsets[i]; ++j )
       {
-        const double val = mValues[vertexIndex];
-        if ( std::isnan( val ) )
+        const size_t vertexIndex = static_cast<size_t>( vertexIndices[j] );
+        if ( isScalar )
         {
-          mActive[idx] = 0; //NOT ACTIVE
-          break;
+          const double val = mValues[vertexIndex];
+          if ( std::isnan( val ) )
+          {
+            mActive[faceIndex] = 0; //NOT ACTIVE
+            break;
+          }
         }
-      }
-      else
-      {
-        const double x = mValues[2 * vertexIndex];
-        const double y = mValues[2 * vertexIndex + 1];
-        if ( std::isnan( x ) || std::isnan( y ) )
+        else
         {
-          mActive[idx] = 0; //NOT ACTIVE
-          break;
+          const double x = mValues[2 * vertexIndex];
+          const double y = mValues[2 * vertexIndex + 1];
+          if ( std::isnan( x ) || std::isnan( y ) )
+          {
+            mActive[faceIndex] = 0; //NOT ACTIVE
+            break;
+          }
         }
       }
+      faceStart = faceOffsets[i];
     }
   }
 }
@@ -189,6 +214,27 @@ size_t MDAL::MemoryDataset3D::faceToVolumeData( size_t indexStart, size_t count,
   return copyValues;
 }
 
+const void *MDAL::MemoryDataset3D::dataPointer( MDAL_DataType dataType, size_t &stride ) const
+{
+  stride = 1;
+  switch ( dataType )
+  {
+    case MDAL_DataType::VERTICAL_LEVEL_COUNT_INTEGER:
+      return mVerticalLevelCounts.data();
+    case MDAL_DataType::VERTICAL_LEVEL_DOUBLE:
+      return mVerticalExtrusions.data();
+    case MDAL_DataType::FACE_INDEX_TO_VOLUME_INDEX_INTEGER:
+      return mFaceToVolume.data();
+    case MDAL_DataType::SCALAR_VOLUMES_DOUBLE:
+      return group()->isScalar() ? mValues.data() : nullptr;
+    case MDAL_DataType::VECTOR_2D_VOLUMES_DOUBLE:
+      stride = 2;
+      return group()->isScalar() ? nullptr : mValues.data();
+    default:
+      return nullptr;
+  }
+}
+
 size_t MDAL::MemoryDataset3D::scalarVolumesData( size_t indexStart, size_t count, double *buffer )
 {
   assert( group()->isScalar() ); //checked in C API interface
@@ -53,11 +53,13 @@ namespace MDAL
       //! Returns 0 for datasets that does not support active flags
       size_t activeData( size_t indexStart, size_t count, int *buffer ) override;
 
+      const void *dataPointer( MDAL_DataType dataType, size_t &stride ) const override;
+
       /**
-       * Loop through all faces and activate those which has all 4 values on vertices valid
+       * Loop through all faces and activate those which has all values on vertices valid
        * Dataset must support active flags and be defined on vertices
        */
-      void activateFaces( MDAL::MemoryMesh *mesh );
+      void activateFaces( MDAL::Mesh *mesh );
 
       /**
        * Sets active flag for index
@@ -254,6 +256,8 @@ namespace MDAL
       size_t scalarVolumesData( size_t indexStart, size_t count, double *buffer ) override;
       size_t vectorVolumesData( size_t indexStart, size_t count, double *buffer ) override;
 
+      const void *dataPointer( MDAL_DataType dataType, size_t &stride ) const override;
+
     private:
       /**
        * Stores vector2d/scalar data for dataset in form
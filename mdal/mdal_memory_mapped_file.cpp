@@ -0,0 +1,160 @@
+/*
+ MDAL - Mesh Data Abstraction Library (MIT License)
+ Copyright (C) 2026 Lutra Consulting Ltd.
+*/
+
+#include "mdal_memory_mapped_file.hpp"
+#include "mdal_utils.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#ifdef _MSC_VER
+#include <locale>
+#include <codecvt>
+#endif
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MDAL::MemoryMappedFile::MemoryMappedFile( const std::string &fileName )
+{
+  mIsValid = map( fileName ) || readToMemory( fileName );
+}
+
+MDAL::MemoryMappedFile::~MemoryMappedFile()
+{
+  unmap();
+}
+
+#ifdef _WIN32
+
+bool MDAL::MemoryMappedFile::map( const std::string &fileName )
+{
+#ifdef _MSC_VER
+  std::wstring_convert< std::codecvt_utf8_utf16< wchar_t > > converter;
+  std::wstring wStr = converter.from_bytes( fileName );
+  HANDLE file = CreateFileW( wStr.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+#else
+  HANDLE file = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+#endif
+  if ( file == INVALID_HANDLE_VALUE )
+    return false;
+
+  LARGE_INTEGER fileSize;
+  if ( !GetFileSizeEx( file, &fileSize ) )
+  {
+    CloseHandle( file );
+    return false;
+  }
+
+  mFileHandle = file;
+  mSize = static_cast<size_t>( fileSize.QuadPart );
+  if ( mSize == 0 )
+    return true; // empty file cannot be mapped
+
+  mMappingHandle = CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+  if ( mMappingHandle )
+    mData = static_cast<const char *>( MapViewOfFile( mMappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+
+  if ( !mData )
+  {
+    unmap();
+    return false;
+  }
+
+  mIsMapped = true;
+  return true;
+}
+
+void MDAL::MemoryMappedFile::unmap()
+{
+  if ( mIsMapped && mData )
+    UnmapViewOfFile( mData );
+  if ( mMappingHandle )
+    CloseHandle( mMappingHandle );
+  if ( mFileHandle )
+    CloseHandle( mFileHandle );
+
+  mMappingHandle = nullptr;
+  mFileHandle = nullptr;
+  mIsMapped = false;
+  mData = nullptr;
+  mSize = 0;
+}
+
+#else
+
+bool MDAL::MemoryMappedFile::map( const std::string &fileName )
+{
+  int fd = open( fileName.c_str(), O_RDONLY );
+  if ( fd < 0 )
+    return false;
+
+  struct stat st;
+  if ( fstat( fd, &st ) != 0 )
+  {
+    close( fd );
+    return false;
+  }
+
+  mSize = static_cast<size_t>( st.st_size );
+  if ( mSize == 0 )
+  {
+    // empty file cannot be mapped
+    close( fd );
+    return true;
+  }
+
+  void *addr = mmap( nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+  // the mapping keeps its own reference to the file
+  close( fd );
+  if ( addr == MAP_FAILED )
+  {
+    mSize = 0;
+    return false;
+  }
+
+#ifdef MADV_SEQUENTIAL
+  madvise( addr, mSize, MADV_SEQUENTIAL );
+#endif
+
+  mData = static_cast<const char *>( addr );
+  mIsMapped = true;
+  return true;
+}
+
+void MDAL::MemoryMappedFile::unmap()
+{
+  if ( mIsMapped && mData )
+    munmap( const_cast<char *>( mData ), mSize );
+
+  mIsMapped = false;
+  mData = nullptr;
+  mSize = 0;
+}
+
+#endif
+
+bool MDAL::MemoryMappedFile::readToMemory( const std::string &fileName )
+{
+  std::ifstream in;
+  if ( !MDAL::openInputFile( in, fileName, std::ifstream::binary ) )
+    return false;
+
+  in.seekg( 0, std::ios::end );
+  const std::streamoff length = in.tellg();
+  if ( length < 0 )
+    return false;
+  in.seekg( 0, std::ios::beg );
+
+  mBuffer.resize( static_cast<size_t>( length ) );
+  if ( length > 0 && !in.read( mBuffer.data(), length ) )
+    return false;
+
+  mData = mBuffer.data();
+  mSize = mBuffer.size();
+  return true;
+}
@@ -0,0 +1,64 @@
+/*
+ MDAL - Mesh Data Abstraction Library (MIT License)
+ Copyright (C) 2026 Lutra Consulting Ltd.
+*/
+
+#ifndef MDAL_MEMORY_MAPPED_FILE_HPP
+#define MDAL_MEMORY_MAPPED_FILE_HPP
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+namespace MDAL
+{
+  /**
+   * Read-only view of the whole content of a file
+   *
+   * The file is memory mapped when the platform supports it, otherwise
+   * (or when mapping fails) the content is read to memory.
+   * The object is not copyable, the view is valid for its lifetime
+   */
+  class MemoryMappedFile
+  {
+    public:
+      //! Opens the file, see isValid()
+      explicit MemoryMappedFile( const std::string &fileName );
+      ~MemoryMappedFile();
+
+      MemoryMappedFile( const MemoryMappedFile & ) = delete;
+      MemoryMappedFile &operator=( const MemoryMappedFile & ) = delete;
+
+      //! Returns whether the file was opened, empty file is valid
+      bool isValid() const { return mIsValid; }
+
+      //! Returns pointer to the first byte of the file, nullptr for empty file
+      const char *data() const { return mData; }
+
+      //! Returns pointer behind the last byte of the file
+      const char *end() const { return mData + mSize; }
+
+      //! Returns size of the file in bytes
+      size_t size() const { return mSize; }
+
+    private:
+      bool map( const std::string &fileName );
+      void unmap();
+      bool readToMemory( const std::string &fileName );
+
+      bool mIsValid = false;
+      const char *mData = nullptr;
+      size_t mSize = 0;
+      bool mIsMapped = false;
+
+#ifdef _WIN32
+      void *mFileHandle = nullptr;
+      void *mMappingHandle = nullptr;
+#endif
+
+      //! used when the file could not be mapped
+      std::vector<char> mBuffer;
+  };
+}
+
+#endif // MDAL_MEMORY_MAPPED_FILE_HPP
@@ -0,0 +1,231 @@
+/*
+ MDAL - Mesh Data Abstraction Library (MIT License)
+ Copyright (C) 2026 Lutra Consulting Ltd.
+*/
+
+#include <map>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <cstdlib>
+
+#include "mdal_prefetcher.hpp"
+#include "mdal_block_cache.hpp"
+#include "mdal_data_model.hpp"
+#include "mdal_utils.hpp"
+
+struct PrefetchTask
+{
+  const MDAL::DatasetGroup *group;
+  //! taken when the task is scheduled, datasets of the group can be appended by other threads
+  std::shared_ptr<MDAL::Dataset> dataset;
+  bool isScalar;
+};
+
+//! Range of datasets of the group already scheduled for prefetching [first, end)
+struct PrefetchRange
+{
+  size_t first;
+  size_t end;
+};
+
+static std::recursive_timed_mutex sIoMutex;
+static std::atomic<int> sEnabledGroups( 0 );
+
+static std::mutex sQueueMutex;
+static std::condition_variable sQueueCondition;
+static std::condition_variable sIdleCondition;
+static std::deque<PrefetchTask> sQueue;
+static std::map<const MDAL::DatasetGroup *, PrefetchRange> sScheduled;
+static const MDAL::DatasetGroup *sCurrentGroup = nullptr;
+static bool sStop = false;
+//! not a static object, so its lifetime does not depend on order of destruction of statics, see Prefetcher::shutdown()
+static std::thread *sWorker = nullptr;
+
+static bool _isCancelled( const MDAL::DatasetGroup *group )
+{
+  std::lock_guard<std::mutex> lock( sQueueMutex );
+  return sStop || !sScheduled.count( group );
+}
+
+static void _prefetchDataset( const PrefetchTask &task )
+{
+  MDAL::Dataset *dataset = task.dataset.get();
+  const size_t valuesCount = dataset->valuesCount();
+  const size_t blockSize = MDAL::BlockCache::blockSize();
+  std::vector<double> buffer( task.isScalar ? blockSize : 2 * blockSize );
+
+  // read by blocks, so the values are cached and requests of other threads are not blocked for long
+  try
+  {
+    for ( size_t start = 0; start < valuesCount; start += blockSize )
+    {
+      // API thread can hold the lock while it cancels this group, so waiting is interrupted by cancelling
+      MDAL::Prefetcher::IoLock ioLock( sIoMutex, std::defer_lock );
+      while ( !ioLock.try_lock_for( std::chrono::milliseconds( 10 ) ) )
+      {
+        if ( _isCancelled( task.group ) )
+          return;
+      }
+
+      if ( _isCancelled( task.group ) )
+        return;
+
+      const size_t count = std::min( blockSize, valuesCount - start );
+      if ( task.isScalar )
+        dataset->scalarData( start, count, buffer.data() );
+      else
+        dataset->vectorData( start, count, buffer.data() );
+    }
+  }
+  catch ( MDAL::Error & )
+  {
+    // error is reported when the dataset is requested
+  }
+}
+
+static void _workerLoop()
+{
+  std::unique_lock<std::mutex> lock( sQueueMutex );
+  while ( true )
+  {
+    sQueueCondition.wait( lock, [] { return sStop || !sQueue.empty(); } );
+    if ( sStop )
+      return;
+
+    PrefetchTask task = sQueue.front();
+    sQueue.pop_front();
+    sCurrentGroup = task.group;
+    lock.unlock();
+
+    _prefetchDataset( task );
+    task.dataset.reset();
+
+    lock.lock();
+    sCurrentGroup = nullptr;
+    sIdleCondition.notify_all();
+  }
+}
+
+// expects locked queue mutex
+static void _removeTasks( const MDAL::DatasetGroup *group )
+{
+  sQueue.erase( std::remove_if( sQueue.begin(), sQueue.end(), [group]( const PrefetchTask & task )
+  {
+    return task.group == group;
+  } ), sQueue.end() );
+  sIdleCondition.notify_all();
+}
+
+bool MDAL::Prefetcher::isActive()
+{
+  return sEnabledGroups > 0;
+}
+
+MDAL::Prefetcher::IoLock MDAL::Prefetcher::lockIo()
+{
+  IoLock lock( sIoMutex, std::defer_lock );
+  if ( isActive() )
+    lock.lock();
+  return lock;
+}
+
+void MDAL::Prefetcher::setGroupEnabled( bool enabled )
+{
+  if ( enabled )
+    ++sEnabledGroups;
+  else if ( --sEnabledGroups == 0 )
+    shutdown();
+}
+
+void MDAL::Prefetcher::datasetRead( DatasetGroup *group, size_t datasetIndex )
+{
+  const size_t window = group->prefetchWindow();
+  const size_t budget = MDAL::BlockCache::budget();
+  if ( window == 0 || budget == 0 )
+    return;
+
+  // prefetched datasets need to fit to the cache together with the requested one
+  const size_t datasetBytes = std::max<size_t>( 1, group->datasets[datasetIndex]->valuesCount() * ( group->isScalar() ? 1 : 2 ) * sizeof( double ) );
+  const size_t effectiveWindow = std::min( window, budget / datasetBytes > 0 ? budget / datasetBytes - 1 : 0 );
+  const size_t end = std::min( group->datasets.size(), datasetIndex + 1 + effectiveWindow );
+
+  std::lock_guard<std::mutex> lock( sQueueMutex );
+  if ( sStop )
+    return;
+
+  size_t first = datasetIndex + 1;
+  auto scheduled = sScheduled.find( group );
+  if ( scheduled != sScheduled.end() &&
+       datasetIndex + 1 >= scheduled->second.first && datasetIndex < scheduled->second.end )
+  {
+    // continuation of sequential reading, the rest of the window is already scheduled
+    first = std::max( first, scheduled->second.end );
+  }
+  else
+  {
+    // access pattern changed, drop what is not needed anymore
+    _removeTasks( group );
+  }
+
+  sScheduled[group] = PrefetchRange{ datasetIndex + 1, std::max( first, end ) };
+  for ( size_t i = first; i < end; ++i )
+    sQueue.push_back( PrefetchTask{ group, group->datasets[i], group->isScalar() } );
+
+  if ( first < end )
+  {
+    if ( !sWorker )
+    {
+      static bool sExitHandlerRegistered = false;
+      if ( !sExitHandlerRegistered )
+      {
+        // the thread must not outlive the drivers and the statics it uses
+        std::atexit( MDAL::Prefetcher::shutdown );
+        sExitHandlerRegistered = true;
+      }
+      sWorker = new std::thread( _workerLoop );
+    }
+    sQueueCondition.notify_one();
+  }
+}
+
+void MDAL::Prefetcher::cancel( const DatasetGroup *group )
+{
+  std::unique_lock<std::mutex> lock( sQueueMutex );
+  _removeTasks( group );
+  sScheduled.erase( group );
+  sIdleCondition.wait( lock, [group] { return sCurrentGroup != group; } );
+}
+
+void MDAL::Prefetcher::waitUntilIdle()
+{
+  std::unique_lock<std::mutex> lock( sQueueMutex );
+  sIdleCondition.wait( lock, [] { return !sWorker || ( sQueue.empty() && !sCurrentGroup ); } );
+}
+
+void MDAL::Prefetcher::shutdown()
+{
+  std::thread *worker = nullptr;
+  {
+    std::lock_guard<std::mutex> lock( sQueueMutex );
+    std::swap( worker, sWorker );
+    sQueue.clear();
+    sScheduled.clear();
+    sIdleCondition.notify_all();
+    if ( !worker )
+      return;
+    sStop = true;
+  }
+
+  sQueueCondition.notify_all();
+  worker->join();
+  delete worker;
+
+  std::lock_guard<std::mutex> lock( sQueueMutex );
+  sStop = false;
+}
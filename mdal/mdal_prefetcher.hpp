@@ -0,0 +1,57 @@
+/*
+ MDAL - Mesh Data Abstraction Library (MIT License)
+ Copyright (C) 2026 Lutra Consulting Ltd.
+*/
+
+#ifndef MDAL_PREFETCHER_HPP
+#define MDAL_PREFETCHER_HPP
+
+#include <stddef.h>
+#include <mutex>
+
+namespace MDAL
+{
+  class DatasetGroup;
+
+  /**
+   * Namespace including functions for reading of datasets ahead of requests
+   *
+   * When prefetching is enabled for the group (see DatasetGroup::setPrefetchWindow()),
+   * reading of timestep t schedules reading of the following timesteps t+1 ... t+window
+   * in a background thread. The values are read to the block cache (see BlockCache),
+   * so the prefetching is limited by its budget. When the requested timestep is not
+   * a continuation of the previous requests, scheduled timesteps are cancelled.
+   *
+   * Drivers and libraries they use (NetCDF, HDF5) are not thread-safe, so while prefetching
+   * is enabled for any group, API functions that can reach the drivers hold the I/O lock (see lockIo())
+   * and the background thread takes it for each block it reads. Therefore one background thread is used.
+   * The thread is stopped when prefetching is disabled for the last group or when the process exits.
+   */
+  namespace Prefetcher
+  {
+    typedef std::unique_lock<std::recursive_timed_mutex> IoLock;
+
+    //! Returns whether any group has prefetching enabled
+    bool isActive();
+
+    //! Returns lock of the mutex serializing access to the drivers, the mutex is locked only when prefetching is active
+    IoLock lockIo();
+
+    //! Registers change of the prefetch window of a group, see DatasetGroup::setPrefetchWindow()
+    void setGroupEnabled( bool enabled );
+
+    //! Schedules reading of timesteps after the dataset with \a datasetIndex of the group
+    void datasetRead( DatasetGroup *group, size_t datasetIndex );
+
+    //! Cancels scheduled reading of datasets of the group and waits if the group is being read
+    void cancel( const DatasetGroup *group );
+
+    //! Waits until all scheduled datasets are read or cancelled, must not be called with the I/O lock held
+    void waitUntilIdle();
+
+    //! Drops all scheduled reading and stops the background thread, it is started again when needed
+    void shutdown();
+  }
+}
+
+#endif // MDAL_PREFETCHER_HPP
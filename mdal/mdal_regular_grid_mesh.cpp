@@ -0,0 +1,221 @@
+/*
+ MDAL - Mesh Data Abstraction Library (MIT License)
+ Copyright (C) 2026 Lutra Consulting Ltd.
+*/
+
+#include "mdal_regular_grid_mesh.hpp"
+#include <assert.h>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+MDAL::RegularGridMesh::RegularGridMesh( const std::string &driverName,
+                                        const std::string &uri,
+                                        size_t xSize,
+                                        size_t ySize,
+                                        const double *geoTransform )
+  : Mesh( driverName, 4, uri )
+  , mXSize( xSize )
+  , mYSize( ySize )
+{
+  std::copy( geoTransform, geoTransform + 6, mGT );
+
+  if ( mXSize == 0 || mYSize == 0 )
+    return;
+
+  // coordinates are affine, so the extremes are in the corners
+  const size_t lastColumn = mXSize - 1;
+  const size_t lastRow = mYSize - 1;
+  const Vertex corners[4] = {vertex( 0, 0 ), vertex( lastColumn, 0 ), vertex( 0, lastRow ), vertex( lastColumn, lastRow )};
+  for ( const Vertex &corner : corners )
+  {
+    mExtent.minX = std::min( mExtent.minX, corner.x );
+    mExtent.maxX = std::max( mExtent.maxX, corner.x );
+    mExtent.minY = std::min( mExtent.minY, corner.y );
+    mExtent.maxY = std::max( mExtent.maxY, corner.y );
+  }
+
+  // we want to detect situation when there is whole earth represented in dataset
+  mIsLongitudeShifted = ( mExtent.minX >= 0.0 ) &&
+                        ( fabs( mExtent.minX + mExtent.maxX - 360.0 ) < 1.0 ) &&
+                        ( mExtent.minY >= -90.0 ) &&
+                        ( mExtent.maxX <= 360.0 ) &&
+                        ( mExtent.maxX > 180.0 ) &&
+                        ( mExtent.maxY <= 90.0 );
+
+  if ( mIsLongitudeShifted )
+    initLongitudeShift();
+}
+
+MDAL::RegularGridMesh::~RegularGridMesh() = default;
+
+void MDAL::RegularGridMesh::initLongitudeShift()
+{
+  // shifted coordinates are not affine anymore, extent and borders need one pass over the vertices
+  mExtent.minX = std::numeric_limits<double>::max();
+  mExtent.maxX = -std::numeric_limits<double>::max();
+
+  std::vector<size_t> borderColumns;
+  for ( size_t row = 0; row < mYSize; ++row )
+  {
+    size_t borderColumn = mXSize;
+    double x = vertexX( 0, row );
+    for ( size_t column = 0; column < mXSize; ++column )
+    {
+      mExtent.minX = std::min( mExtent.minX, x );
+      mExtent.maxX = std::max( mExtent.maxX, x );
+
+      if ( column + 1 == mXSize )
+        break;
+
+      const double nextX = vertexX( column + 1, row );
+      if ( borderColumn == mXSize && x > 0.0 && nextX < 0.0 )
+        borderColumn = column;
+      x = nextX;
+    }
+
+    if ( row + 1 < mYSize )
+      borderColumns.push_back( borderColumn );
+  }
+
+  // faces are reconnected only when each row crosses the antimeridian, so the count of faces is kept
+  if ( std::find( borderColumns.begin(), borderColumns.end(), mXSize ) == borderColumns.end() )
+    mBorderColumns = std::move( borderColumns );
+}
+
+double MDAL::RegularGridMesh::vertexX( size_t column, size_t row ) const
+{
+  double x = mGT[0] + ( column + 0.5 ) * mGT[1] + ( row + 0.5 ) * mGT[2];
+  if ( mIsLongitudeShifted && x > 180.0 )
+    x -= 360.0;
+  return x;
+}
+
+MDAL::Vertex MDAL::RegularGridMesh::vertex( size_t column, size_t row ) const
+{
+  Vertex v;
+  v.x = vertexX( column, row );
+  v.y = mGT[3] + ( column + 0.5 ) * mGT[4] + ( row + 0.5 ) * mGT[5];
+  v.z = 0.0;
+  return v;
+}
+
+size_t MDAL::RegularGridMesh::facesCount() const
+{
+  if ( mXSize < 2 || mYSize < 2 )
+    return 0;
+  return ( mXSize - 1 ) * ( mYSize - 1 );
+}
+
+void MDAL::RegularGridMesh::faceVertices( size_t faceIndex, size_t *vertexIndices ) const
+{
+  assert( faceIndex < facesCount() );
+
+  const size_t row = faceIndex / ( mXSize - 1 );
+  size_t column = faceIndex % ( mXSize - 1 );
+
+  if ( !mBorderColumns.empty() )
+  {
+    if ( column == 0 )
+    {
+      // extra face around prime meridian, first in the row
+      vertexIndices[0] = mXSize * ( row + 1 );
+      vertexIndices[1] = mXSize - 1 + mXSize * ( row + 1 );
+      vertexIndices[2] = mXSize - 1 + mXSize * row;
+      vertexIndices[3] = mXSize * row;
+      return;
+    }
+
+    // the face over antimeridian is omitted
+    --column;
+    if ( column >= mBorderColumns[row] )
+      ++column;
+  }
+
+  vertexIndices[0] = column + 1 + mXSize * ( row + 1 );
+  vertexIndices[1] = column + mXSize * ( row + 1 );
+  vertexIndices[2] = column + mXSize * row;
+  vertexIndices[3] = column + 1 + mXSize * row;
+}
+
+std::unique_ptr<MDAL::MeshVertexIterator> MDAL::RegularGridMesh::readVertices()
+{
+  return std::unique_ptr<MeshVertexIterator>( new RegularGridMeshVertexIterator( this ) );
+}
+
+std::unique_ptr<MDAL::MeshEdgeIterator> MDAL::RegularGridMesh::readEdges()
+{
+  return std::unique_ptr<MeshEdgeIterator>();
+}
+
+std::unique_ptr<MDAL::MeshFaceIterator> MDAL::RegularGridMesh::readFaces()
+{
+  return std::unique_ptr<MeshFaceIterator>( new RegularGridMeshFaceIterator( this ) );
+}
+
+MDAL::RegularGridMeshVertexIterator::RegularGridMeshVertexIterator( const MDAL::RegularGridMesh *mesh )
+  : mMesh( mesh )
+{
+}
+
+size_t MDAL::RegularGridMeshVertexIterator::next( size_t vertexCount, double *coordinates )
+{
+  assert( mMesh );
+  assert( coordinates );
+
+  const size_t count = std::min( vertexCount, mMesh->verticesCount() - mPosition );
+  if ( count == 0 )
+    return 0;
+
+  const size_t xSize = mMesh->xSize();
+  size_t column = mPosition % xSize;
+  size_t row = mPosition / xSize;
+  for ( size_t i = 0; i < count; ++i )
+  {
+    const Vertex v = mMesh->vertex( column, row );
+    coordinates[3 * i] = v.x;
+    coordinates[3 * i + 1] = v.y;
+    coordinates[3 * i + 2] = v.z;
+
+    if ( ++column == xSize )
+    {
+      column = 0;
+      ++row;
+    }
+  }
+
+  mPosition += count;
+  return count;
+}
+
+MDAL::RegularGridMeshFaceIterator::RegularGridMeshFaceIterator( const MDAL::RegularGridMesh *mesh )
+  : mMesh( mesh )
+{
+}
+
+size_t MDAL::RegularGridMeshFaceIterator::next( size_t faceOffsetsBufferLen,
+    int *faceOffsetsBuffer,
+    size_t vertexIndicesBufferLen,
+    int *vertexIndicesBuffer )
+{
+  assert( mMesh );
+  assert( faceOffsetsBuffer );
+  assert( vertexIndicesBuffer );
+
+  size_t count = std::min( faceOffsetsBufferLen, mMesh->facesCount() - mPosition );
+  count = std::min( count, vertexIndicesBufferLen / 4 );
+  if ( count == 0 )
+    return 0;
+
+  size_t indices[4];
+  for ( size_t i = 0; i < count; ++i )
+  {
+    mMesh->faceVertices( mPosition + i, indices );
+    for ( size_t j = 0; j < 4; ++j )
+      vertexIndicesBuffer[4 * i + j] = static_cast<int>( indices[j] );
+    faceOffsetsBuffer[i] = static_cast<int>( 4 * ( i + 1 ) );
+  }
+
+  mPosition += count;
+  return count;
+}
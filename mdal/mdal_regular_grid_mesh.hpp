@@ -0,0 +1,107 @@
+/*
+ MDAL - Mesh Data Abstraction Library (MIT License)
+ Copyright (C) 2026 Lutra Consulting Ltd.
+*/
+
+#ifndef MDAL_REGULAR_GRID_MESH_HPP
+#define MDAL_REGULAR_GRID_MESH_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stddef.h>
+
+#include "mdal_data_model.hpp"
+#include "mdal_memory_data_model.hpp"
+
+namespace MDAL
+{
+  /**
+   * Mesh of a raster, vertices are in the centers of the pixels and faces are quads between them
+   *
+   * Only the size and the affine geotransform (in GDAL convention) are stored,
+   * coordinates of vertices and connectivity of faces are computed on request.
+   *
+   * When the raster covers the whole earth with longitudes in <0, 360>, the vertices
+   * with longitude greater than 180 are shifted by -360, faces over the antimeridian
+   * are omitted and the same count of faces is added over the prime meridian
+   */
+  class RegularGridMesh: public Mesh
+  {
+    public:
+      RegularGridMesh( const std::string &driverName,
+                       const std::string &uri,
+                       size_t xSize,
+                       size_t ySize,
+                       const double *geoTransform );
+
+      ~RegularGridMesh() override;
+
+      std::unique_ptr<MeshVertexIterator> readVertices() override;
+
+      //! Regular grid doesn't have edges, returns a void unique_ptr
+      std::unique_ptr<MeshEdgeIterator> readEdges() override;
+
+      std::unique_ptr<MeshFaceIterator> readFaces() override;
+
+      size_t verticesCount() const override {return mXSize * mYSize;}
+      size_t edgesCount() const override {return 0;}
+      size_t facesCount() const override;
+      BBox extent() const override {return mExtent;}
+
+      //! Returns number of vertices in a row
+      size_t xSize() const {return mXSize;}
+      //! Returns number of rows of vertices
+      size_t ySize() const {return mYSize;}
+
+      //! Returns whether the longitudes over 180 were shifted by -360
+      bool isLongitudeShifted() const {return mIsLongitudeShifted;}
+
+      //! Returns vertex with index \a column + xSize() * \a row
+      Vertex vertex( size_t column, size_t row ) const;
+
+      //! Writes indexes of the 4 vertices of the face to \a vertexIndices
+      void faceVertices( size_t faceIndex, size_t *vertexIndices ) const;
+
+    private:
+      double vertexX( size_t column, size_t row ) const;
+      void initLongitudeShift();
+
+      size_t mXSize = 0;
+      size_t mYSize = 0;
+      double mGT[6] = {0, 0, 0, 0, 0, 0};
+      bool mIsLongitudeShifted = false;
+      BBox mExtent;
+
+      //! Column of the omitted face over the antimeridian for each row of faces, empty when faces are not reconnected
+      std::vector<size_t> mBorderColumns;
+  };
+
+  class RegularGridMeshVertexIterator: public MeshVertexIterator
+  {
+    public:
+      RegularGridMeshVertexIterator( const RegularGridMesh *mesh );
+
+      size_t next( size_t vertexCount, double *coordinates ) override;
+
+    private:
+      const RegularGridMesh *mMesh;
+      size_t mPosition = 0;
+  };
+
+  class RegularGridMeshFaceIterator: public MeshFaceIterator
+  {
+    public:
+      RegularGridMeshFaceIterator( const RegularGridMesh *mesh );
+
+      size_t next( size_t faceOffsetsBufferLen,
+                   int *faceOffsetsBuffer,
+                   size_t vertexIndicesBufferLen,
+                   int *vertexIndicesBuffer ) override;
+
+    private:
+      const RegularGridMesh *mMesh;
+      size_t mPosition = 0;
+  };
+} // namespace MDAL
+#endif //MDAL_REGULAR_GRID_MESH_HPP
@@ -0,0 +1,282 @@
+/*
+ MDAL - Mesh Data Abstraction Library (MIT License)
+ Copyright (C) 2026 Lutra Consulting Ltd.
+*/
+
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+#include <stdint.h>
+
+#include <nlohmann/json.hpp>
+
+#include "mdal_statistics_cache.hpp"
+#include "mdal_utils.hpp"
+#include "mdal_logger.hpp"
+
+using Json = nlohmann::json;
+
+static const int CACHE_FORMAT_VERSION = 1;
+static const char *CACHE_SUFFIX = ".mdalstats";
+
+static std::mutex sCacheMutex;
+static bool sCacheEnabled = false;
+static std::string sCacheDirectory;
+
+// NaN is not valid JSON, it is stored as null
+static Json _statisticsToJson( const MDAL::Statistics &stats )
+{
+  Json ret = Json::array();
+  ret.push_back( std::isnan( stats.minimum ) ? Json() : Json( stats.minimum ) );
+  ret.push_back( std::isnan( stats.maximum ) ? Json() : Json( stats.maximum ) );
+  return ret;
+}
+
+static MDAL::Statistics _statisticsFromJson( const Json &json )
+{
+  MDAL::Statistics ret;
+  if ( !json.is_array() || json.size() != 2 )
+    return ret;
+
+  if ( json[0].is_number() )
+    ret.minimum = json[0].get<double>();
+  if ( json[1].is_number() )
+    ret.maximum = json[1].get<double>();
+  return ret;
+}
+
+//! FNV-1a hash, unlike std::hash the cache file names do not depend on the standard library implementation
+static uint64_t _fnv1a64( const std::string &str )
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for ( const char c : str )
+  {
+    hash ^= static_cast<unsigned char>( c );
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static Json _metadataToJson( const MDAL::DatasetGroup *group )
+{
+  Json metadata = Json::object();
+  for ( const std::pair<std::string, std::string> &meta : group->metadata )
+    metadata[meta.first] = meta.second;
+  return metadata;
+}
+
+static std::string _groupSourceFile( const MDAL::DatasetGroup *group )
+{
+  std::string file;
+  MDAL::parseMeshFileFromUri( group->uri(), file );
+  return file;
+}
+
+//! Returns the cache content for the source file, null if there is no valid cache file
+static Json _readCache( const std::string &sourceFile, int64_t size, int64_t modificationTime )
+{
+  const std::string path = MDAL::StatisticsCache::cacheFile( sourceFile );
+  if ( !MDAL::fileExists( path ) )
+    return Json();
+
+  try
+  {
+    Json cache = Json::parse( MDAL::readFileToString( path ) );
+    if ( cache.value( "version", 0 ) != CACHE_FORMAT_VERSION ||
+         cache.value( "file", std::string() ) != sourceFile ||
+         cache.value( "size", int64_t( -1 ) ) != size ||
+         cache.value( "mtime", int64_t( -1 ) ) != modificationTime ||
+         !cache.contains( "meshes" ) )
+      return Json(); // source file has changed
+
+    return cache;
+  }
+  catch ( Json::exception & )
+  {
+    MDAL::Log::debug( "Invalid statistics cache file " + path );
+    return Json();
+  }
+}
+
+static bool _groupMatches( MDAL::DatasetGroup *group, const Json &cachedGroup )
+{
+  if ( cachedGroup.value( "name", std::string() ) != group->name() ||
+       cachedGroup.value( "location", -1 ) != static_cast<int>( group->dataLocation() ) ||
+       cachedGroup.value( "scalar", !group->isScalar() ) != group->isScalar() ||
+       cachedGroup.value( "metadata", Json() ) != _metadataToJson( group ) ||
+       !cachedGroup.contains( "datasets" ) )
+    return false;
+
+  const Json &datasets = cachedGroup["datasets"];
+  if ( !datasets.is_array() || datasets.size() != group->datasets.size() )
+    return false;
+
+  for ( size_t i = 0; i < group->datasets.size(); ++i )
+  {
+    const double time = group->datasets[i]->time( MDAL::RelativeTimestamp::hours );
+    if ( !MDAL::equals( datasets[i].value( "time", MDAL_NAN ), time, 1e-9 ) )
+      return false;
+  }
+  return true;
+}
+
+bool MDAL::StatisticsCache::isEnabled()
+{
+  std::lock_guard<std::mutex> lock( sCacheMutex );
+  return sCacheEnabled;
+}
+
+void MDAL::StatisticsCache::setEnabled( bool enabled, const std::string &cacheDirectory )
+{
+  std::lock_guard<std::mutex> lock( sCacheMutex );
+  sCacheEnabled = enabled;
+  sCacheDirectory = cacheDirectory;
+}
+
+std::string MDAL::StatisticsCache::cacheFile( const std::string &sourceFile )
+{
+  std::string directory;
+  {
+    std::lock_guard<std::mutex> lock( sCacheMutex );
+    directory = sCacheDirectory;
+  }
+
+  if ( directory.empty() )
+    return sourceFile + CACHE_SUFFIX;
+
+  // flatten the full path of the source file to unique file name in cache directory
+  std::stringstream name;
+  name << MDAL::baseName( sourceFile, true ) << "_"
+       << std::hex << std::setw( 16 ) << std::setfill( '0' ) << _fnv1a64( sourceFile )
+       << CACHE_SUFFIX;
+  return MDAL::pathJoin( directory, name.str() );
+}
+
+void MDAL::StatisticsCache::restore( Mesh *mesh, const std::string &sourceFile )
+{
+  if ( !mesh || !isEnabled() )
+    return;
+
+  int64_t size = 0;
+  int64_t modificationTime = 0;
+  if ( !MDAL::fileStatus( sourceFile, size, modificationTime ) )
+    return;
+
+  const Json cache = _readCache( sourceFile, size, modificationTime );
+  if ( cache.is_null() || !cache["meshes"].contains( mesh->uri() ) )
+    return;
+
+  const Json &cachedGroups = cache["meshes"][mesh->uri()];
+  for ( const std::shared_ptr<DatasetGroup> &group : mesh->datasetGroups )
+  {
+    if ( group->isInEditMode() || _groupSourceFile( group.get() ) != sourceFile )
+      continue;
+
+    for ( const Json &cachedGroup : cachedGroups )
+    {
+      if ( !_groupMatches( group.get(), cachedGroup ) )
+        continue;
+
+      const Json &cachedDatasets = cachedGroup["datasets"];
+      for ( size_t i = 0; i < group->datasets.size(); ++i )
+      {
+        if ( !group->datasets[i]->hasStatistics() && cachedDatasets[i].contains( "statistics" ) )
+          group->datasets[i]->setStatistics( _statisticsFromJson( cachedDatasets[i]["statistics"] ) );
+      }
+
+      if ( !group->hasStatistics() && cachedGroup.contains( "statistics" ) )
+        group->setStatistics( _statisticsFromJson( cachedGroup["statistics"] ) );
+
+      break;
+    }
+  }
+}
+
+void MDAL::StatisticsCache::store( Mesh *mesh )
+{
+  if ( !mesh || !isEnabled() )
+    return;
+
+  std::map<std::string, std::vector<DatasetGroup *>> groupsBySource;
+  for ( const std::shared_ptr<DatasetGroup> &group : mesh->datasetGroups )
+  {
+    if ( !group->isInEditMode() )
+      groupsBySource[_groupSourceFile( group.get() )].push_back( group.get() );
+  }
+
+  for ( const auto &source : groupsBySource )
+  {
+    const std::string &sourceFile = source.first;
+    int64_t size = 0;
+    int64_t modificationTime = 0;
+    if ( !MDAL::fileStatus( sourceFile, size, modificationTime ) )
+      continue;
+
+    Json cachedGroups = Json::array();
+    for ( DatasetGroup *group : source.second )
+    {
+      Json cachedGroup;
+      cachedGroup["name"] = group->name();
+      cachedGroup["location"] = static_cast<int>( group->dataLocation() );
+      cachedGroup["scalar"] = group->isScalar();
+      if ( group->hasStatistics() )
+        cachedGroup["statistics"] = _statisticsToJson( group->statistics() );
+      cachedGroup["metadata"] = _metadataToJson( group );
+
+      Json cachedDatasets = Json::array();
+      for ( const std::shared_ptr<Dataset> &dataset : group->datasets )
+      {
+        Json cachedDataset;
+        cachedDataset["time"] = dataset->time( RelativeTimestamp::hours );
+        if ( dataset->hasStatistics() )
+          cachedDataset["statistics"] = _statisticsToJson( dataset->statistics() );
+        cachedDatasets.push_back( cachedDataset );
+      }
+      cachedGroup["datasets"] = cachedDatasets;
+      cachedGroups.push_back( cachedGroup );
+    }
+
+    // keep entries of other meshes stored in the same source file
+    Json cache = _readCache( sourceFile, size, modificationTime );
+    if ( cache.is_null() )
+    {
+      cache["version"] = CACHE_FORMAT_VERSION;
+      cache["file"] = sourceFile;
+      cache["size"] = size;
+      cache["mtime"] = modificationTime;
+      cache["meshes"] = Json::object();
+    }
+
+    if ( cache["meshes"].contains( mesh->uri() ) && cache["meshes"][mesh->uri()] == cachedGroups )
+      continue; // nothing new
+
+    cache["meshes"][mesh->uri()] = cachedGroups;
+
+    // written to a temporary file first, so readers never see a partially written cache file
+    const std::string path = cacheFile( sourceFile );
+    const std::string tmpPath = path + ".tmp";
+    std::ofstream out = MDAL::openOutputFile( tmpPath, std::ofstream::out | std::ofstream::trunc );
+    if ( !out.is_open() )
+    {
+      MDAL::Log::debug( "Unable to write statistics cache file " + tmpPath );
+      continue;
+    }
+    out << cache.dump();
+    out.close();
+    if ( !out )
+    {
+      MDAL::Log::debug( "Unable to write statistics cache file " + tmpPath );
+      MDAL::deleteFile( tmpPath );
+      continue;
+    }
+
+    // rename does not replace existing files on Windows
+    if ( !MDAL::renameFile( tmpPath, path ) &&
+         !( MDAL::deleteFile( path ) && MDAL::renameFile( tmpPath, path ) ) )
+    {
+      MDAL::Log::debug( "Unable to replace statistics cache file " + path );
+      MDAL::deleteFile( tmpPath );
+    }
+  }
+}
@@ -0,0 +1,46 @@
+/*
+ MDAL - Mesh Data Abstraction Library (MIT License)
+ Copyright (C) 2026 Lutra Consulting Ltd.
+*/
+
+#ifndef MDAL_STATISTICS_CACHE_HPP
+#define MDAL_STATISTICS_CACHE_HPP
+
+#include <string>
+
+#include "mdal_data_model.hpp"
+
+namespace MDAL
+{
+  /**
+   * Namespace including functions for the persistent cache of dataset statistics
+   *
+   * When enabled, statistics of dataset groups are stored in a JSON file (*.mdalstats)
+   * next to the source file or in the cache directory. The cache entry is valid only
+   * for the same file size and modification time of the source file.
+   *
+   * Statistics are restored only for datasets that do not have statistics after loading,
+   * so the cache is effective with lazy statistics, see MDAL_SetLazyStatistics()
+   */
+  namespace StatisticsCache
+  {
+    bool isEnabled();
+
+    /**
+     * Enables or disables the cache
+     * \param cacheDirectory directory to store cache files, if empty, cache files are stored next to the source files
+     */
+    void setEnabled( bool enabled, const std::string &cacheDirectory );
+
+    //! Returns path of the cache file for the source file
+    std::string cacheFile( const std::string &sourceFile );
+
+    //! Sets statistics stored in the cache to the groups of the mesh that come from \a sourceFile
+    void restore( Mesh *mesh, const std::string &sourceFile );
+
+    //! Stores known statistics of all groups of the mesh in the cache files of their source files
+    void store( Mesh *mesh );
+  }
+}
+
+#endif // MDAL_STATISTICS_CACHE_HPP
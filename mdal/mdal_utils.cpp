@@ -4,6 +4,7 @@
 */
 
 #include "mdal_utils.hpp"
+#include "mdal_block_cache.hpp"
 #include <string>
 #include <fstream>
 #include <iostream>
@@ -15,6 +16,15 @@
 #include <stdio.h>
 #include <ctime>
 #include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <exception>
 
 #ifdef _MSC_VER
 #ifndef UNICODE
@@ -91,6 +101,31 @@ bool MDAL::fileExists( const std::string &filename )
   return in.good();
 }
 
+bool MDAL::fileStatus( const std::string &filename, int64_t &size, int64_t &modificationTime )
+{
+#ifdef _MSC_VER
+  std::wstring_convert< std::codecvt_utf8_utf16< wchar_t > > converter;
+  std::wstring wStr = converter.from_bytes( filename );
+  struct _stat64 st;
+  if ( _wstat64( wStr.c_str(), &st ) != 0 )
+    return false;
+  modificationTime = static_cast<int64_t>( st.st_mtime );
+#else
+  struct stat st;
+  if ( stat( filename.c_str(), &st ) != 0 )
+    return false;
+#if defined(__APPLE__)
+  modificationTime = static_cast<int64_t>( st.st_mtimespec.tv_sec ) * 1000000000 + st.st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+  modificationTime = static_cast<int64_t>( st.st_mtim.tv_sec ) * 1000000000 + st.st_mtim.tv_nsec;
+#else
+  modificationTime = static_cast<int64_t>( st.st_mtime );
+#endif
+#endif
+  size = static_cast<int64_t>( st.st_size );
+  return true;
+}
+
 std::string MDAL::readFileToString( const std::string &filename )
 {
   if ( MDAL::fileExists( filename ) )
@@ -180,6 +215,19 @@ std::vector<std::string> MDAL::split( const std::string &str,
 }
 
 
+void MDAL::split( const char *begin, const char *end, const char delimiter, std::vector<StringView> &tokens )
+{
+  tokens.clear();
+  const char *start = begin;
+  while ( start < end )
+  {
+    const char *next = std::find( start, end, delimiter );
+    if ( next != start )
+      tokens.emplace_back( start, next );
+    start = next + 1;
+  }
+}
+
 std::vector<std::string> MDAL::split( const std::string &str,
                                       const std::string &delimiter )
 {
@@ -250,6 +298,131 @@ int MDAL::toInt( const std::string &str )
   return atoi( str.c_str() );
 }
 
+// copies the characters to null terminated string for C conversion functions
+template<typename T>
+static T _convertCopy( const char *begin, const char *end, T( *convert )( const char * ) )
+{
+  const size_t length = static_cast<size_t>( end - begin );
+  char buffer[64];
+  if ( length < sizeof( buffer ) )
+  {
+    memcpy( buffer, begin, length );
+    buffer[length] = '\0';
+    return convert( buffer );
+  }
+  return convert( std::string( begin, end ).c_str() );
+}
+
+static bool _isNumberSeparator( char c )
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+double MDAL::toDouble( const char *begin, const char *end )
+{
+  // exactly representable powers of ten, see Clinger's fast path
+  static const double powersOfTen[] =
+  {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  const uint64_t maxExactMantissa = uint64_t( 1 ) << 53;
+
+  const char *p = begin;
+  bool negative = false;
+  if ( p < end && ( *p == '-' || *p == '+' ) )
+  {
+    negative = *p == '-';
+    ++p;
+  }
+
+  uint64_t mantissa = 0;
+  int significantDigits = 0;
+  int exponent = 0;
+  bool hasDigits = false;
+
+  for ( ; p < end && *p >= '0' && *p <= '9'; ++p )
+  {
+    hasDigits = true;
+    if ( mantissa == 0 && *p == '0' )
+      continue;
+    if ( ++significantDigits > 19 )
+      return _convertCopy<double>( begin, end, atof );
+    mantissa = mantissa * 10 + static_cast<uint64_t>( *p - '0' );
+  }
+
+  if ( p < end && *p == '.' )
+  {
+    for ( ++p; p < end && *p >= '0' && *p <= '9'; ++p )
+    {
+      hasDigits = true;
+      --exponent;
+      if ( mantissa == 0 && *p == '0' )
+        continue;
+      if ( ++significantDigits > 19 )
+        return _convertCopy<double>( begin, end, atof );
+      mantissa = mantissa * 10 + static_cast<uint64_t>( *p - '0' );
+    }
+  }
+
+  if ( !hasDigits )
+    return _convertCopy<double>( begin, end, atof );
+
+  if ( p < end && ( *p == 'e' || *p == 'E' ) )
+  {
+    ++p;
+    bool negativeExponent = false;
+    if ( p < end && ( *p == '-' || *p == '+' ) )
+    {
+      negativeExponent = *p == '-';
+      ++p;
+    }
+    if ( p == end || *p < '0' || *p > '9' )
+      return _convertCopy<double>( begin, end, atof );
+
+    int exponentPart = 0;
+    for ( ; p < end && *p >= '0' && *p <= '9'; ++p )
+    {
+      if ( exponentPart > 1000 )
+        return _convertCopy<double>( begin, end, atof );
+      exponentPart = exponentPart * 10 + ( *p - '0' );
+    }
+    exponent += negativeExponent ? -exponentPart : exponentPart;
+  }
+
+  if ( p < end && !_isNumberSeparator( *p ) )
+    return _convertCopy<double>( begin, end, atof );
+
+  double value;
+  if ( mantissa == 0 )
+    value = 0.0;
+  else if ( mantissa <= maxExactMantissa && exponent >= -22 && exponent <= 22 )
+    value = exponent < 0 ? static_cast<double>( mantissa ) / powersOfTen[-exponent] :
+            static_cast<double>( mantissa ) * powersOfTen[exponent];
+  else
+    return _convertCopy<double>( begin, end, atof );
+
+  return negative ? -value : value;
+}
+
+size_t MDAL::toSizeT( const char *begin, const char *end )
+{
+  size_t value = 0;
+  const char *p = begin;
+  // up to 9 digits always fits to int used by toSizeT( std::string )
+  for ( ; p < end && p - begin < 9 && *p >= '0' && *p <= '9'; ++p )
+    value = value * 10 + static_cast<size_t>( *p - '0' );
+
+  if ( p == begin || ( p < end && !_isNumberSeparator( *p ) ) )
+  {
+    int i = _convertCopy<int>( begin, end, atoi );
+    if ( i < 0 ) // consistent with atoi return
+      i = 0;
+    return static_cast< size_t >( i );
+  }
+  return value;
+}
+
 std::string MDAL::baseName( const std::string &filename, bool keepExtension )
 {
   // https://stackoverflow.com/a/8520815/2838364
@@ -339,6 +512,11 @@ bool MDAL::toBool( const std::string &str )
   return i != 0;
 }
 
+bool MDAL::toBool( const char *begin, const char *end )
+{
+  return _convertCopy<int>( begin, end, atoi ) != 0;
+}
+
 bool MDAL::contains( const std::vector<std::string> &list, const std::string &str )
 {
   return std::find( list.begin(), list.end(), str ) != list.end();
@@ -587,57 +765,99 @@ std::string MDAL::getCurrentTimeStamp()
   return s;
 }
 
-MDAL::Statistics _calculateStatistics( const std::vector<double> &values, size_t count, bool isVector, const std::vector<int> &active )
-{
-  MDAL::Statistics ret;
+// Values are processed in independent lanes so the compiler can keep the
+// running minimum/maximum in SIMD registers. Invalid values (NaN or inactive)
+// are replaced by +inf/-inf instead of being skipped, so the loops are branch free
+static const size_t STATISTICS_LANES = 4;
 
-  double min = std::numeric_limits<double>::quiet_NaN();
-  double max = std::numeric_limits<double>::quiet_NaN();
-  bool firstIteration = true;
+template<bool IsVector>
+static void _minMaxKernel( const double *values, const int *active, size_t count, double &min, double &max )
+{
+  const double inf = std::numeric_limits<double>::infinity();
+  double lo[STATISTICS_LANES];
+  double hi[STATISTICS_LANES];
+  std::fill( lo, lo + STATISTICS_LANES, inf );
+  std::fill( hi, hi + STATISTICS_LANES, -inf );
 
-  for ( size_t i = 0; i < count; ++i )
+  const size_t stride = IsVector ? 2 : 1;
+  const size_t alignedCount = count - count % STATISTICS_LANES;
+  for ( size_t i = 0; i < alignedCount; i += STATISTICS_LANES )
   {
-    if ( !active.empty() && active.at( i ) == 0 )
-      continue;
-
-    double magnitude;
-    if ( isVector )
+    for ( size_t l = 0; l < STATISTICS_LANES; ++l )
     {
-      double x = values[2 * i];
-      double y = values[2 * i + 1];
-      if ( std::isnan( x ) || std::isnan( y ) )
-        continue;
-      magnitude = sqrt( x * x + y * y );
-    }
-    else
-    {
-      double x = values[i];
-      if ( std::isnan( x ) )
-        continue;
-      magnitude = x;
+      const double x = values[stride * ( i + l )];
+      // squared magnitude for vectors, sqrt is applied only to the final result
+      const double y = IsVector ? values[stride * ( i + l ) + 1] : 0.0;
+      const double v = IsVector ? x * x + y * y : x;
+      const bool valid = ( v == v ) && ( !active || active[i + l] != 0 );
+      const double vLo = valid ? v : inf;
+      const double vHi = valid ? v : -inf;
+      lo[l] = vLo < lo[l] ? vLo : lo[l];
+      hi[l] = vHi > hi[l] ? vHi : hi[l];
     }
+  }
 
-    if ( firstIteration )
-    {
-      firstIteration = false;
-      min = magnitude;
-      max = magnitude;
-    }
-    else
+  for ( size_t i = alignedCount; i < count; ++i )
+  {
+    const double x = values[stride * i];
+    const double y = IsVector ? values[stride * i + 1] : 0.0;
+    const double v = IsVector ? x * x + y * y : x;
+    const bool valid = ( v == v ) && ( !active || active[i] != 0 );
+    lo[0] = valid && v < lo[0] ? v : lo[0];
+    hi[0] = valid && v > hi[0] ? v : hi[0];
+  }
+
+  min = *std::min_element( lo, lo + STATISTICS_LANES );
+  max = *std::max_element( hi, hi + STATISTICS_LANES );
+}
+
+static MDAL::Statistics _calculateStatistics( const double *values, size_t count, bool isVector, const int *active )
+{
+  MDAL::Statistics ret;
+
+  double min;
+  double max;
+  if ( isVector )
+    _minMaxKernel<true>( values, active, count, min, max );
+  else
+    _minMaxKernel<false>( values, active, count, min, max );
+
+  // no valid value found
+  if ( min > max )
+    return ret;
+
+  ret.minimum = isVector ? sqrt( min ) : min;
+  ret.maximum = isVector ? sqrt( max ) : max;
+  return ret;
+}
+
+MDAL::Statistics MDAL::calculateStatistics( const double *values, size_t count, bool isVector, const int *active )
+{
+  // below this size the thread start-up costs more than the work itself
+  const size_t minBlockSize = 1 << 16;
+  const size_t blocksCount = std::max<size_t>( 1, std::min( threadCount(), count / minBlockSize ) );
+  std::vector<Statistics> blockStats( blocksCount );
+  const size_t blockSize = ( count + blocksCount - 1 ) / blocksCount;
+
+  parallelFor( blocksCount, 1, [&]( size_t begin, size_t end )
+  {
+    for ( size_t b = begin; b < end; ++b )
     {
-      if ( magnitude < min )
-      {
-        min = magnitude;
-      }
-      if ( magnitude > max )
-      {
-        max = magnitude;
-      }
+      const size_t first = b * blockSize;
+      const size_t last = std::min( count, first + blockSize );
+      if ( first >= last )
+        continue;
+      const size_t stride = isVector ? 2 : 1;
+      blockStats[b] = _calculateStatistics( values + stride * first,
+                                            last - first,
+                                            isVector,
+                                            active ? active + first : nullptr );
     }
-  }
+  } );
 
-  ret.minimum = min;
-  ret.maximum = max;
+  Statistics ret;
+  for ( const Statistics &stats : blockStats )
+    combineStatistics( ret, stats );
   return ret;
 }
 
@@ -661,6 +881,11 @@ MDAL::Statistics MDAL::calculateStatistics( DatasetGroup *grp )
 }
 
 MDAL::Statistics MDAL::calculateStatistics( std::shared_ptr<Dataset> dataset )
+{
+  return calculateStatistics( dataset.get() );
+}
+
+MDAL::Statistics MDAL::calculateStatistics( Dataset *dataset )
 {
   Statistics ret;
   if ( !dataset )
@@ -668,7 +893,12 @@ MDAL::Statistics MDAL::calculateStatistics( std::shared_ptr<Dataset> dataset )
 
   bool isVector = !dataset->group()->isScalar();
   bool is3D = dataset->group()->dataLocation() == MDAL_DataLocation::DataOnVolumes;
-  size_t bufLen = 2000;
+  const size_t valuesCount = dataset->valuesCount();
+  // large chunks amortize the virtual read calls and give each thread enough work
+  size_t bufLen = std::min<size_t>( valuesCount, 1 << 20 );
+  if ( bufLen == 0 )
+    return ret;
+
   std::vector<double> buffer( isVector ? bufLen * 2 : bufLen );
   std::vector<int> activeBuffer;
   bool activeFaceFlag = dataset->group()->dataLocation() == MDAL_DataLocation::DataOnFaces && dataset->supportsActiveFlag();
@@ -676,8 +906,20 @@ MDAL::Statistics MDAL::calculateStatistics( std::shared_ptr<Dataset> dataset )
   if ( activeFaceFlag )
     activeBuffer.resize( bufLen );
 
+  // one pass over the whole dataset, its blocks would only replace blocks of datasets read repeatedly
+  MDAL::BlockCache::ScanScope scan;
+
+  if ( !is3D && valuesCount <= bufLen )
+  {
+    // whole dataset in one pass, with active flags for values on faces
+    const size_t valsRead = dataset->dataWithActive( buffer.data(), activeFaceFlag ? activeBuffer.data() : nullptr );
+    if ( valsRead == 0 )
+      return ret;
+    return calculateStatistics( buffer.data(), valsRead, isVector, activeFaceFlag ? activeBuffer.data() : nullptr );
+  }
+
   size_t i = 0;
-  while ( i < dataset->valuesCount() )
+  while ( i < valuesCount )
   {
     size_t valsRead;
     if ( is3D )
@@ -708,7 +950,10 @@ MDAL::Statistics MDAL::calculateStatistics( std::shared_ptr<Dataset> dataset )
     if ( valsRead == 0 )
       return ret;
 
-    MDAL::Statistics dsStats = _calculateStatistics( buffer, valsRead, isVector, activeBuffer );
+    MDAL::Statistics dsStats = calculateStatistics( buffer.data(),
+                               valsRead,
+                               isVector,
+                               activeFaceFlag ? activeBuffer.data() : nullptr );
     combineStatistics( ret, dsStats );
     i += valsRead;
   }
@@ -731,6 +976,256 @@ void MDAL::combineStatistics( MDAL::Statistics &main, const MDAL::Statistics &ot
   }
 }
 
+static std::atomic<bool> sLazyStatistics( false );
+
+bool MDAL::lazyStatistics()
+{
+  return sLazyStatistics;
+}
+
+void MDAL::setLazyStatistics( bool lazy )
+{
+  sLazyStatistics = lazy;
+}
+
+void MDAL::updateStatistics( std::shared_ptr<Dataset> dataset )
+{
+  if ( !dataset )
+    return;
+
+  if ( lazyStatistics() )
+    dataset->resetStatistics();
+  else
+    dataset->setStatistics( calculateStatistics( dataset ) );
+}
+
+void MDAL::updateStatistics( std::shared_ptr<DatasetGroup> grp )
+{
+  updateStatistics( grp.get() );
+}
+
+void MDAL::updateStatistics( DatasetGroup *grp )
+{
+  if ( !grp )
+    return;
+
+  if ( lazyStatistics() )
+    grp->resetStatistics();
+  else
+    grp->setStatistics( calculateStatistics( grp ) );
+}
+
+//! 0 uses hardware concurrency
+static MDAL::Setting sThreadCount( "MDAL_NUM_THREADS", 1, 0 );
+
+size_t MDAL::threadCount()
+{
+  const long long requested = sThreadCount.value();
+  if ( requested > 0 )
+    return static_cast<size_t>( requested );
+
+  const unsigned int hardware = std::thread::hardware_concurrency();
+  return hardware > 0 ? hardware : 1;
+}
+
+//! Whether the thread processes a block of parallelFor(), nested calls are not split again
+static thread_local bool sInParallelBlock = false;
+
+//! Blocks of one parallelFor() call, claimed by the calling thread and the pool threads
+struct ParallelJob
+{
+  ParallelJob( const std::function<void( size_t, size_t )> &f, size_t c, size_t bs, size_t bc )
+    : func( f ), count( c ), blockSize( bs ), blocksCount( bc ), nextBlock( 0 ), finishedBlocks( 0 ) {}
+
+  const std::function<void( size_t, size_t )> &func;
+  const size_t count;
+  const size_t blockSize;
+  const size_t blocksCount;
+  std::atomic<size_t> nextBlock;
+  std::mutex mutex;
+  std::condition_variable finished;
+  size_t finishedBlocks;
+  //! the first exception thrown by func, rethrown on the calling thread
+  std::exception_ptr error;
+};
+
+//! Processes blocks of the job until all are claimed, exceptions are stored in the job
+static void _runParallelBlocks( ParallelJob &job )
+{
+  const bool wasInParallelBlock = sInParallelBlock;
+  sInParallelBlock = true;
+  size_t block;
+  while ( ( block = job.nextBlock++ ) < job.blocksCount )
+  {
+    std::exception_ptr error;
+    try
+    {
+      const size_t begin = block * job.blockSize;
+      job.func( begin, std::min( job.count, begin + job.blockSize ) );
+    }
+    catch ( ... )
+    {
+      error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock( job.mutex );
+    if ( error && !job.error )
+      job.error = error;
+    if ( ++job.finishedBlocks == job.blocksCount )
+      job.finished.notify_all();
+  }
+  sInParallelBlock = wasInParallelBlock;
+}
+
+//! Threads kept for parallelFor() calls, created on first use and stopped at exit
+struct ThreadPool
+{
+  std::vector<std::thread> threads;
+  std::deque<std::shared_ptr<ParallelJob>> jobs;
+  std::condition_variable jobAdded;
+  bool stop = false;
+};
+
+static std::mutex sPoolMutex;
+//! not a static object, so its threads are stopped before statics they use are destroyed, see _stopThreadPool()
+static ThreadPool *sPool = nullptr;
+static bool sPoolStopped = false;
+
+static void _poolLoop( ThreadPool *pool )
+{
+  std::unique_lock<std::mutex> lock( sPoolMutex );
+  while ( true )
+  {
+    pool->jobAdded.wait( lock, [pool] { return pool->stop || !pool->jobs.empty(); } );
+    if ( pool->stop )
+      return;
+
+    std::shared_ptr<ParallelJob> job = pool->jobs.front();
+    pool->jobs.pop_front();
+    lock.unlock();
+    _runParallelBlocks( *job );
+    job.reset();
+    lock.lock();
+  }
+}
+
+static void _stopThreadPool()
+{
+  ThreadPool *pool = nullptr;
+  {
+    std::lock_guard<std::mutex> lock( sPoolMutex );
+    std::swap( pool, sPool );
+    sPoolStopped = true;
+    if ( !pool )
+      return;
+    pool->stop = true;
+  }
+
+  pool->jobAdded.notify_all();
+  for ( std::thread &thread : pool->threads )
+    thread.join();
+  delete pool;
+}
+
+//! Offers the job to \a threadsCount pool threads, the calling thread processes all blocks after the pool is stopped at exit
+static void _submitToThreadPool( const std::shared_ptr<ParallelJob> &job, size_t threadsCount )
+{
+  std::lock_guard<std::mutex> lock( sPoolMutex );
+  if ( sPoolStopped )
+    return;
+
+  if ( !sPool )
+  {
+    sPool = new ThreadPool;
+    std::atexit( _stopThreadPool );
+  }
+
+  while ( sPool->threads.size() < threadsCount )
+    sPool->threads.emplace_back( _poolLoop, sPool );
+
+  for ( size_t i = 0; i < threadsCount; ++i )
+    sPool->jobs.push_back( job );
+  sPool->jobAdded.notify_all();
+}
+
+void MDAL::parallelFor( size_t count, size_t minBlockSize, const std::function<void( size_t, size_t )> &func )
+{
+  if ( count == 0 )
+    return;
+
+  minBlockSize = std::max<size_t>( minBlockSize, 1 );
+  const size_t blocksCount = sInParallelBlock ? 1 : std::max<size_t>( 1, std::min( threadCount(), count / minBlockSize ) );
+  if ( blocksCount == 1 )
+  {
+    func( 0, count );
+    return;
+  }
+
+  const size_t blockSize = ( count + blocksCount - 1 ) / blocksCount;
+  std::shared_ptr<ParallelJob> job = std::make_shared<ParallelJob>( func, count, blockSize, ( count + blockSize - 1 ) / blockSize );
+  _submitToThreadPool( job, job->blocksCount - 1 );
+
+  // the calling thread takes the blocks not yet claimed by busy pool threads, so it only waits for blocks in progress
+  _runParallelBlocks( *job );
+
+  std::unique_lock<std::mutex> lock( job->mutex );
+  job->finished.wait( lock, [&job] { return job->finishedBlocks == job->blocksCount; } );
+  if ( job->error )
+    std::rethrow_exception( job->error );
+}
+
+MDAL::Setting::Setting( const char *envName, long long envUnit, long long defaultValue )
+  : mEnvName( envName )
+  , mEnvUnit( envUnit )
+  , mDefaultValue( defaultValue )
+  , mValue( -1 )
+{
+}
+
+long long MDAL::Setting::value() const
+{
+  long long ret = mValue.load();
+  if ( ret < 0 )
+  {
+    ret = mDefaultValue;
+    const std::string env = getEnvVar( mEnvName );
+    if ( !env.empty() )
+      ret = std::max( 0LL, static_cast<long long>( toDouble( env ) * mEnvUnit ) );
+
+    // the setter can be called meanwhile by other thread
+    long long unset = -1;
+    mValue.compare_exchange_strong( unset, ret );
+    ret = mValue.load();
+  }
+  return ret;
+}
+
+void MDAL::Setting::setValue( long long value )
+{
+  mValue = std::max( 0LL, value );
+}
+
+size_t MDAL::chunkCacheSize( const std::vector<size_t> &dims, const std::vector<size_t> &chunks, size_t valueBytes, size_t budget, size_t &chunkBytes )
+{
+  chunkBytes = valueBytes;
+  if ( dims.empty() || dims.size() != chunks.size() || valueBytes == 0 )
+    return 0;
+
+  std::vector<size_t> chunksAlongDim( dims.size() );
+  for ( size_t i = 0; i < dims.size(); ++i )
+  {
+    chunkBytes *= std::max<size_t>( 1, chunks[i] );
+    chunksAlongDim[i] = chunks[i] > 0 ? ( dims[i] + chunks[i] - 1 ) / chunks[i] : 1;
+  }
+
+  size_t sliceChunks = 1;
+  for ( size_t i = 1; i < chunksAlongDim.size(); ++i )
+    sliceChunks *= chunksAlongDim[i];
+  const size_t seriesChunks = std::max( chunksAlongDim.front(), chunksAlongDim.back() );
+  const size_t neededChunks = std::max( sliceChunks, seriesChunks );
+  return std::min( neededChunks * chunkBytes, std::max( budget, chunkBytes ) );
+}
+
 void MDAL::addBedElevationDatasetGroup( MDAL::Mesh *mesh, const Vertices &vertices )
 {
   std::vector<double> values( mesh->verticesCount() );
@@ -780,9 +1275,9 @@ static void _addScalarDatasetGroup( MDAL::Mesh *mesh,
   std::shared_ptr<MDAL::MemoryDataset2D> dataset = std::make_shared< MDAL::MemoryDataset2D >( group.get() );
   dataset->setTime( 0.0 );
   memcpy( dataset->values(), values.data(), sizeof( double )*values.size() );
-  dataset->setStatistics( MDAL::calculateStatistics( dataset ) );
+  MDAL::updateStatistics( dataset );
   group->datasets.emplace_back( std::move( dataset ) );
-  group->setStatistics( MDAL::calculateStatistics( group ) );
+  MDAL::updateStatistics( group );
   mesh->datasetGroups.emplace_back( std::move( group ) );
 }
 
@@ -9,11 +9,13 @@
 #include <string>
 #include <vector>
 #include <stddef.h>
+#include <stdint.h>
 #include <limits>
 #include <sstream>
 #include <fstream>
 #include <cmath>
 #include <functional>
+#include <atomic>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -65,6 +67,12 @@ namespace MDAL
 
   /** Return whether file exists */
   bool fileExists( const std::string &filename );
+  /**
+   * Returns size in bytes and last modification time of the file
+   * Modification time is in nanoseconds when the platform provides it, in seconds otherwise
+   * Returns false if the file cannot be accessed
+   */
+  bool fileStatus( const std::string &filename, int64_t &size, int64_t &modificationTime );
   std::string baseName( const std::string &filename, bool keepExtension = false );
   std::string fileExtension( const std::string &path );
   std::string dirName( const std::string &filename );
@@ -107,9 +115,21 @@ namespace MDAL
   int toInt( const std::string &str );
   int toInt( const size_t value );
   double toDouble( const std::string &str );
+
+  /**
+   * Same as toDouble( std::string ) for the characters [begin, end), without allocation.
+   * Plain decimal numbers are converted directly, other input is passed to atof()
+   */
+  double toDouble( const char *begin, const char *end );
+
+  //! Same as toSizeT( std::string ) for the characters [begin, end), without allocation
+  size_t toSizeT( const char *begin, const char *end );
   double toDouble( const size_t value );
   bool toBool( const std::string &str );
 
+  //! Same as toBool( std::string ) for the characters [begin, end), without allocation
+  bool toBool( const char *begin, const char *end );
+
   //! Returns the string with a adapted format to coordinate
   //! precision is the number of digits after the digital point if fabs(value)>180 (seems to not be a geographic coordinate)
   //! precision+6 is the number of digits after the digital point if fabs(value)<=180 (could be a geographic coordinate)
@@ -129,6 +149,15 @@ namespace MDAL
   //! Splits by deliminer and skips empty parts
   std::vector<std::string> split( const std::string &str, const std::string &delimiter );
 
+  //! Part of a character buffer [first, second)
+  typedef std::pair<const char *, const char *> StringView;
+
+  /**
+   * Splits [begin, end) by deliminer and skips empty parts, same as split( std::string, char ).
+   * Tokens point to the input buffer, \a tokens is cleared and reused to avoid allocations
+   */
+  void split( const char *begin, const char *end, const char delimiter, std::vector<StringView> &tokens );
+
   std::string join( const std::vector<std::string> &parts, const std::string &delimiter );
 
   //! Right trim
@@ -167,6 +196,82 @@ namespace MDAL
 
   //! Calculates statistics for dataset
   Statistics calculateStatistics( std::shared_ptr<Dataset> dataset );
+  Statistics calculateStatistics( Dataset *dataset );
+
+  //! Returns whether statistics are calculated on first request instead of on load, see MDAL_SetLazyStatistics()
+  bool lazyStatistics();
+  void setLazyStatistics( bool lazy );
+
+  /**
+   * Calculates and sets statistics of the dataset (group)
+   * When lazyStatistics() is enabled, statistics are only reset and calculated on first request
+   */
+  void updateStatistics( std::shared_ptr<Dataset> dataset );
+  void updateStatistics( std::shared_ptr<DatasetGroup> grp );
+  void updateStatistics( DatasetGroup *grp );
+
+  /**
+   * Calculates statistics for \a count values in \a values
+   *
+   * For vector data, values are in form x1, y1, ..., xN, yN and statistics are computed on magnitudes
+   * \a active can be null, otherwise values with active flag 0 are ignored. NaN values are ignored
+   * Large buffers are split between threads, see parallelFor()
+   */
+  Statistics calculateStatistics( const double *values, size_t count, bool isVector, const int *active );
+
+  // threads
+  //! Returns maximum number of threads used for parallel work, MDAL_NUM_THREADS environment variable overrides hardware concurrency
+  size_t threadCount();
+
+  /**
+   * Splits range [0, count) into contiguous blocks of at least minBlockSize items
+   * and calls func( begin, end ) for each block, in parallel if threadCount() allows it.
+   * Blocks are processed by the calling thread and by threads kept for following calls.
+   * The first exception thrown by func is rethrown on the calling thread after all blocks finish
+   * Nested calls from func are not parallelized again and process the whole range on the calling thread
+   */
+  void parallelFor( size_t count, size_t minBlockSize, const std::function<void( size_t, size_t )> &func );
+
+  // settings
+  /**
+   * Process-wide numeric setting of MDAL, e.g. size of a cache
+   *
+   * Until the value is set (by MDAL_Set*() API functions), it is taken from the environment
+   * variable \a envName multiplied by \a envUnit, or the default value when the variable is not set.
+   * Negative values are stored as 0.
+   */
+  class Setting
+  {
+    public:
+      Setting( const char *envName, long long envUnit, long long defaultValue );
+
+      long long value() const;
+      void setValue( long long value );
+
+    private:
+      const char *mEnvName;
+      long long mEnvUnit;
+      long long mDefaultValue;
+      //! -1 until the value is set or read from the environment
+      mutable std::atomic<long long> mValue;
+  };
+
+  /**
+   * Returns size of the chunk cache of a chunked variable, so one timestep or time series of one element
+   * can be read without reading the same chunks repeatedly. The size is limited by \a budget, but it is at least one chunk.
+   *
+   * Time is expected to be the first (or the last) dimension, so slice of one timestep covers all chunks
+   * along the other dimensions and time series of one element covers all chunks along the time dimension.
+   * The budget applies to one variable, see MDAL_SetNetCDFChunkCacheSize() and MDAL_SetHdf5CacheSizes()
+   *
+   * \param dims sizes of the dimensions of the variable
+   * \param chunks sizes of the chunk along the dimensions
+   * \param valueBytes size of one value in bytes
+   * \param budget maximum size of the cache in bytes
+   * \param chunkBytes returns size of one chunk in bytes
+   * \returns size of the cache in bytes, 0 for variable without chunks
+   */
+  size_t chunkCacheSize( const std::vector<size_t> &dims, const std::vector<size_t> &chunks, size_t valueBytes, size_t budget, size_t &chunkBytes );
 
   // mesh & datasets
   //! Adds bed elevatiom dataset group to mesh
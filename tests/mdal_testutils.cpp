@@ -205,6 +205,34 @@ bool compareVectors( const std::vector<int> &a, const std::vector<int> &b )
   return true;
 }
 
+bool compareTimeSeries( MDAL_DatasetGroupH group, const std::vector<int> &elementIndexes )
+{
+  const int datasetCount = MDAL_G_datasetCount( group );
+  const bool scalar = MDAL_G_hasScalarData( group );
+  const size_t valuesPerItem = scalar ? 1 : 2;
+  const MDAL_DataType dataType = scalar ? MDAL_DataType::SCALAR_DOUBLE : MDAL_DataType::VECTOR_2D_DOUBLE;
+
+  std::vector<double> expected( elementIndexes.size() * datasetCount * valuesPerItem );
+  for ( int t = 0; t < datasetCount; ++t )
+  {
+    MDAL_DatasetH ds = MDAL_G_dataset( group, t );
+    for ( size_t e = 0; e < elementIndexes.size(); ++e )
+    {
+      double *value = expected.data() + ( e * datasetCount + t ) * valuesPerItem;
+      if ( MDAL_D_data( ds, elementIndexes[e], 1, dataType, value ) != 1 )
+        return false;
+    }
+  }
+
+  std::vector<double> timeSeries( expected.size() );
+  const int read = MDAL_G_timeSeriesBatch( group, elementIndexes.data(), static_cast<int>( elementIndexes.size() ),
+                   0, datasetCount, timeSeries.data() );
+  if ( read != datasetCount )
+    return false;
+
+  return compareVectors( expected, timeSeries );
+}
+
 bool compareVectors( const std::vector<double> &a, const std::vector<double> &b )
 {
   double eps = 1e-4;
@@ -47,6 +47,9 @@ double getValueX( MDAL_DatasetH dataset, int index );
 double getValueY( MDAL_DatasetH dataset, int index );
 int get3DFrom2D( MDAL_DatasetH dataset, int index );
 
+//! Compares time series of the elements read by MDAL_G_timeSeriesBatch() with values read dataset by dataset
+bool compareTimeSeries( MDAL_DatasetGroupH group, const std::vector<int> &elementIndexes );
+
 // Datasets 3D
 int getLevelsCount3D( MDAL_DatasetH dataset, int index );
 double getLevelZ3D( MDAL_DatasetH dataset, int index );
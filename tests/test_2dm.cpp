@@ -3,6 +3,8 @@
  Copyright (C) 2018 Peter Petrik (zilolv at gmail dot com)
 */
 #include "gtest/gtest.h"
+#include <fstream>
+#include <sstream>
 
 //mdal
 #include "mdal.h"
@@ -798,6 +800,136 @@ TEST( Mesh2DMTest, QuadAndTriangleScientificNotationFileLargeValues )
   );
 }
 
+static void write2dm( const std::string &path, const std::string &content )
+{
+  std::ofstream out( path, std::ofstream::binary | std::ofstream::trunc );
+  out << content;
+}
+
+TEST( Mesh2DMTest, MappedFileEdgeLines )
+{
+  std::string path = tmp_file( "/edge_lines.2dm" );
+
+  // CRLF endings, repeated spaces, blank and unknown lines, no new line at the end of file
+  write2dm( path,
+            "MESH2D\r\n"
+            "MESHNAME \"edge lines\"\r\n"
+            "\r\n"
+            "E4Q  1 1 2 4 5   1\r\n"
+            "E3T 2 2 3 4 1 7.5\r\n"
+            "ND 1  1000.0 2000.0 20.0\r\n"
+            "ND 2 2000.0  2000.0 30.0\r\n"
+            "\r\n"
+            "ND 3 3000.0 2000.0 40.0\r\n"
+            "ND 4 2000.0 3000.0 50.0\r\n"
+            "ND 5 1000.0 3000.0 1e1" );
+
+  MDAL_MeshH m = MDAL_LoadMesh( path.c_str() );
+  ASSERT_NE( m, nullptr );
+  EXPECT_EQ( MDAL_Status::None, MDAL_LastStatus() );
+  EXPECT_EQ( 5, MDAL_M_vertexCount( m ) );
+  EXPECT_EQ( 2, MDAL_M_faceCount( m ) );
+
+  EXPECT_DOUBLE_EQ( 2000.0, getVertexXCoordinatesAt( m, 1 ) );
+  EXPECT_DOUBLE_EQ( 3000.0, getVertexYCoordinatesAt( m, 4 ) );
+  EXPECT_DOUBLE_EQ( 20.0, getVertexZCoordinatesAt( m, 0 ) );
+  EXPECT_DOUBLE_EQ( 10.0, getVertexZCoordinatesAt( m, 4 ) );
+
+  EXPECT_EQ( 4, getFaceVerticesCountAt( m, 0 ) );
+  EXPECT_EQ( 3, getFaceVerticesIndexAt( m, 0, 2 ) );
+  EXPECT_EQ( 3, getFaceVerticesCountAt( m, 1 ) );
+  EXPECT_EQ( 2, getFaceVerticesIndexAt( m, 1, 1 ) );
+
+  // legacy material column
+  ASSERT_EQ( 2, MDAL_M_datasetGroupCount( m ) );
+  MDAL_DatasetH ds = MDAL_G_dataset( MDAL_M_datasetGroup( m, 1 ), 0 );
+  EXPECT_TRUE( std::isnan( getValue( ds, 0 ) ) );
+  EXPECT_DOUBLE_EQ( 7.5, getValue( ds, 1 ) );
+  MDAL_CloseMesh( m );
+
+  // truncated node
+  write2dm( path,
+            "MESH2D\n"
+            "E3T 1 1 2 3 1\n"
+            "ND 1 1000.0 2000.0 20.0\n"
+            "ND 2 2000.0 2000.0\n"
+            "ND 3 3000.0 2000.0 40.0\n" );
+  m = MDAL_LoadMesh( path.c_str() );
+  EXPECT_EQ( m, nullptr );
+  EXPECT_EQ( MDAL_Status::Err_UnknownFormat, MDAL_LastStatus() );
+
+  // truncated element
+  write2dm( path,
+            "MESH2D\n"
+            "E4Q 1 1 2 3\n"
+            "ND 1 1000.0 2000.0 20.0\n"
+            "ND 2 2000.0 2000.0 30.0\n"
+            "ND 3 3000.0 2000.0 40.0\n" );
+  m = MDAL_LoadMesh( path.c_str() );
+  EXPECT_EQ( m, nullptr );
+  EXPECT_EQ( MDAL_Status::Err_UnknownFormat, MDAL_LastStatus() );
+
+  // truncated edge
+  write2dm( path,
+            "MESH2D\n"
+            "E2L 1 1\n"
+            "ND 1 1000.0 2000.0 20.0\n"
+            "ND 2 2000.0 2000.0 30.0\n" );
+  m = MDAL_LoadMesh( path.c_str() );
+  EXPECT_EQ( m, nullptr );
+  EXPECT_EQ( MDAL_Status::Err_UnknownFormat, MDAL_LastStatus() );
+
+  deleteFile( path );
+}
+
+TEST( Mesh2DMTest, MappedFileLarge )
+{
+  // large enough to be split to more chunks parsed in parallel
+  const int size = 300;
+  std::stringstream content;
+  content << "MESH2D\n";
+  for ( int row = 0; row < size - 1; ++row )
+  {
+    for ( int column = 0; column < size - 1; ++column )
+    {
+      const int first = row * size + column + 1;
+      content << "E4Q " << row * ( size - 1 ) + column + 1 << " "
+              << first << " " << first + 1 << " " << first + size + 1 << " " << first + size << " 1\n";
+    }
+  }
+  for ( int i = 0; i < size * size; ++i )
+    content << "ND " << i + 1 << " " << i % size << ".5 " << i / size << ".25 " << i << "\n";
+
+  std::string path = tmp_file( "/large_grid.2dm" );
+  write2dm( path, content.str() );
+
+  MDAL_MeshH m = MDAL_LoadMesh( path.c_str() );
+  ASSERT_NE( m, nullptr );
+  EXPECT_EQ( MDAL_Status::None, MDAL_LastStatus() );
+  ASSERT_EQ( size * size, MDAL_M_vertexCount( m ) );
+  ASSERT_EQ( ( size - 1 ) * ( size - 1 ), MDAL_M_faceCount( m ) );
+
+  std::vector<double> coordinates = getCoordinates( m, size * size );
+  bool coordinatesMatch = true;
+  for ( int i = 0; i < size * size; ++i )
+  {
+    coordinatesMatch &= MDAL::equals( coordinates[3 * i], i % size + 0.5 ) &&
+                        MDAL::equals( coordinates[3 * i + 1], i / size + 0.25 ) &&
+                        MDAL::equals( coordinates[3 * i + 2], i );
+  }
+  EXPECT_TRUE( coordinatesMatch );
+
+  const int lastFace = ( size - 1 ) * ( size - 1 ) - 1;
+  EXPECT_EQ( size * size - size - 2, getFaceVerticesIndexAt( m, lastFace, 0 ) );
+  EXPECT_EQ( size * size - 1, getFaceVerticesIndexAt( m, lastFace, 2 ) );
+  const int middleFace = lastFace / 2;
+  const int middleFirst = ( middleFace / ( size - 1 ) ) * size + middleFace % ( size - 1 );
+  EXPECT_EQ( middleFirst + size, getFaceVerticesIndexAt( m, middleFace, 3 ) );
+
+  MDAL_CloseMesh( m );
+  deleteFile( path );
+}
+
 int main( int argc, char **argv )
 {
   testing::InitGoogleTest( &argc, argv );
@@ -503,6 +503,66 @@ TEST( ApiTest, MeshNamesApi )
   EXPECT_EQ( MDAL_MeshNames( nullptr ), nullptr );
 }
 
+TEST( ApiTest, NetCDFChunkCacheApi )
+{
+#ifdef HAVE_NETCDF
+  const long long defaultSize = MDAL_NetCDFChunkCacheSize();
+  EXPECT_GE( defaultSize, 0 );
+  MDAL_SetNetCDFChunkCacheSize( 1024 * 1024 );
+  EXPECT_EQ( 1024 * 1024, MDAL_NetCDFChunkCacheSize() );
+  MDAL_SetNetCDFChunkCacheSize( -1 );
+  EXPECT_EQ( 0, MDAL_NetCDFChunkCacheSize() );
+  MDAL_SetNetCDFChunkCacheSize( defaultSize );
+#else
+  MDAL_SetNetCDFChunkCacheSize( 1024 * 1024 );
+  EXPECT_EQ( 0, MDAL_NetCDFChunkCacheSize() );
+#endif
+}
+
+TEST( ApiTest, NetCDFCompressionApi )
+{
+#ifdef HAVE_NETCDF
+  const int defaultLevel = MDAL_NetCDFCompressionLevel();
+  EXPECT_GE( defaultLevel, 0 );
+  MDAL_SetNetCDFCompression( 12, true );
+  EXPECT_EQ( 9, MDAL_NetCDFCompressionLevel() );
+  MDAL_SetNetCDFCompression( 0, false );
+  EXPECT_EQ( 0, MDAL_NetCDFCompressionLevel() );
+  MDAL_SetNetCDFCompression( defaultLevel, true );
+#else
+  MDAL_SetNetCDFCompression( 4, true );
+  EXPECT_EQ( 0, MDAL_NetCDFCompressionLevel() );
+#endif
+}
+
+TEST( ApiTest, Hdf5CacheApi )
+{
+  long long chunkCache = -1;
+  long long metadataCache = -1;
+  long long sieveBuffer = -1;
+  MDAL_Hdf5CacheSizes( &chunkCache, &metadataCache, &sieveBuffer );
+#ifdef HAVE_HDF5
+  EXPECT_GE( chunkCache, 0 );
+  EXPECT_GE( metadataCache, 0 );
+  EXPECT_GE( sieveBuffer, 0 );
+
+  MDAL_SetHdf5CacheSizes( 1024 * 1024, -1, 0 );
+  long long newChunkCache = -1;
+  long long newMetadataCache = -1;
+  long long newSieveBuffer = -1;
+  MDAL_Hdf5CacheSizes( &newChunkCache, &newMetadataCache, &newSieveBuffer );
+  EXPECT_EQ( 1024 * 1024, newChunkCache );
+  EXPECT_EQ( metadataCache, newMetadataCache );
+  EXPECT_EQ( 0, newSieveBuffer );
+
+  MDAL_SetHdf5CacheSizes( chunkCache, metadataCache, sieveBuffer );
+#else
+  EXPECT_EQ( 0, chunkCache );
+  EXPECT_EQ( 0, metadataCache );
+  EXPECT_EQ( 0, sieveBuffer );
+#endif
+}
+
 TEST( ApiTest, MeshCreationApi )
 {
   std::vector<double> coordinates( {0.0, 0.0, 0.0,
@@ -4,6 +4,11 @@
 */
 #include "gtest/gtest.h"
 #include <string>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <stdlib.h>
 
 //mdal
 #include "mdal.h"
@@ -1422,6 +1427,250 @@ TEST( MeshAsciiDatTest, WriteVectorVertexTestNoActive )
   }
 }
 
+TEST( MeshAsciiDatTest, LazyStatistics )
+{
+  ASSERT_FALSE( MDAL_LazyStatistics() );
+  MDAL_SetLazyStatistics( true );
+  ASSERT_TRUE( MDAL_LazyStatistics() );
+
+  MDAL_MeshH m = lines_mesh();
+  std::string path = test_file( "/ascii_dat/lines_els_scalar.dat" );
+  MDAL_M_LoadDatasets( m, path.c_str() );
+  EXPECT_EQ( MDAL_Status::None, MDAL_LastStatus() );
+  ASSERT_EQ( 2, MDAL_M_datasetGroupCount( m ) );
+
+  MDAL_DatasetGroupH g = MDAL_M_datasetGroup( m, 1 );
+  ASSERT_NE( g, nullptr );
+  MDAL_DatasetH ds = MDAL_G_dataset( g, 0 );
+  ASSERT_NE( ds, nullptr );
+
+  MDAL_D_computeStatistics( ds );
+  double min, max;
+  MDAL_D_minimumMaximum( ds, &min, &max );
+  EXPECT_DOUBLE_EQ( 1, min );
+  EXPECT_DOUBLE_EQ( 3, max );
+
+  MDAL_G_computeStatistics( g );
+  MDAL_G_minimumMaximum( g, &min, &max );
+  EXPECT_DOUBLE_EQ( 1, min );
+  EXPECT_DOUBLE_EQ( 3, max );
+
+  // without explicit computation
+  g = MDAL_M_datasetGroup( m, 0 );
+  ASSERT_NE( g, nullptr );
+  MDAL_G_minimumMaximum( g, &min, &max );
+  EXPECT_FALSE( std::isnan( min ) );
+  EXPECT_FALSE( std::isnan( max ) );
+
+  MDAL_CloseMesh( m );
+  MDAL_SetLazyStatistics( false );
+}
+
+TEST( MeshAsciiDatTest, StatisticsCache )
+{
+  std::string datFile = tmp_file( "/lines_els_scalar_cached.dat" );
+  std::string cacheFile = datFile + ".mdalstats";
+  copy( test_file( "/ascii_dat/lines_els_scalar.dat" ), datFile );
+  deleteFile( cacheFile );
+
+  MDAL_SetLazyStatistics( true );
+  MDAL_SetStatisticsCache( true, nullptr );
+
+  double min, max;
+  MDAL_MeshH m = lines_mesh();
+  MDAL_M_LoadDatasets( m, datFile.c_str() );
+  ASSERT_EQ( 2, MDAL_M_datasetGroupCount( m ) );
+  MDAL_G_computeStatistics( MDAL_M_datasetGroup( m, 1 ) );
+  MDAL_CloseMesh( m );
+  ASSERT_TRUE( fileExists( cacheFile ) );
+  // written through a temporary file replacing the cache file
+  EXPECT_FALSE( fileExists( cacheFile + ".tmp" ) );
+
+  // modify cached values to check that they are used instead of the data
+  std::ifstream in( cacheFile );
+  std::string cache( ( std::istreambuf_iterator<char>( in ) ), std::istreambuf_iterator<char>() );
+  in.close();
+  size_t pos = cache.find( "[1.0,3.0]" );
+  ASSERT_NE( pos, std::string::npos );
+  cache.replace( pos, 9, "[5.0,7.0]" );
+  std::ofstream out( cacheFile, std::ofstream::trunc );
+  out << cache;
+  out.close();
+
+  m = lines_mesh();
+  MDAL_M_LoadDatasets( m, datFile.c_str() );
+  MDAL_DatasetH ds = MDAL_G_dataset( MDAL_M_datasetGroup( m, 1 ), 0 );
+  MDAL_D_minimumMaximum( ds, &min, &max );
+  EXPECT_DOUBLE_EQ( 5, min );
+  EXPECT_DOUBLE_EQ( 7, max );
+  MDAL_CloseMesh( m );
+
+  // group with different metadata does not match the cached group
+  in.open( cacheFile );
+  cache.assign( ( std::istreambuf_iterator<char>( in ) ), std::istreambuf_iterator<char>() );
+  in.close();
+  pos = cache.find( "\"metadata\":{" );
+  ASSERT_NE( pos, std::string::npos );
+  pos += 12;
+  cache.insert( pos, cache[pos] == '}' ? "\"units\":\"m\"" : "\"units\":\"m\"," );
+  out.open( cacheFile, std::ofstream::trunc );
+  out << cache;
+  out.close();
+
+  m = lines_mesh();
+  MDAL_M_LoadDatasets( m, datFile.c_str() );
+  ds = MDAL_G_dataset( MDAL_M_datasetGroup( m, 1 ), 0 );
+  MDAL_D_minimumMaximum( ds, &min, &max );
+  EXPECT_DOUBLE_EQ( 1, min );
+  EXPECT_DOUBLE_EQ( 3, max );
+  MDAL_CloseMesh( m );
+
+  // changed source file invalidates the cache
+  std::ofstream datOut( datFile, std::ofstream::app );
+  datOut << "\n";
+  datOut.close();
+
+  m = lines_mesh();
+  MDAL_M_LoadDatasets( m, datFile.c_str() );
+  ds = MDAL_G_dataset( MDAL_M_datasetGroup( m, 1 ), 0 );
+  MDAL_D_minimumMaximum( ds, &min, &max );
+  EXPECT_DOUBLE_EQ( 1, min );
+  EXPECT_DOUBLE_EQ( 3, max );
+  MDAL_CloseMesh( m );
+
+  MDAL_SetStatisticsCache( false, nullptr );
+  MDAL_SetLazyStatistics( false );
+  deleteFile( cacheFile );
+  deleteFile( datFile );
+  deleteFile( test_file( "/2dm/lines.2dm.mdalstats" ) );
+}
+
+//! Returns values and active flags of all datasets of the last group
+static std::vector<double> load_all_values( MDAL_MeshH m, const std::string &path )
+{
+  MDAL_M_LoadDatasets( m, path.c_str() );
+  EXPECT_EQ( MDAL_Status::None, MDAL_LastStatus() );
+  MDAL_DatasetGroupH g = MDAL_M_datasetGroup( m, MDAL_M_datasetGroupCount( m ) - 1 );
+  std::vector<double> ret;
+  for ( int i = 0; i < MDAL_G_datasetCount( g ); ++i )
+  {
+    MDAL_DatasetH ds = MDAL_G_dataset( g, i );
+    const int count = MDAL_D_valueCount( ds );
+    std::vector<double> values( MDAL_G_hasScalarData( g ) ? count : 2 * count );
+    EXPECT_EQ( count, MDAL_D_data( ds, 0, count, MDAL_G_hasScalarData( g ) ? MDAL_DataType::SCALAR_DOUBLE : MDAL_DataType::VECTOR_2D_DOUBLE, values.data() ) );
+    ret.insert( ret.end(), values.begin(), values.end() );
+
+    if ( MDAL_D_hasActiveFlagCapability( ds ) )
+    {
+      const int facesCount = MDAL_M_faceCount( m );
+      std::vector<int> active( facesCount );
+      EXPECT_EQ( facesCount, MDAL_D_data( ds, 0, facesCount, MDAL_DataType::ACTIVE_INTEGER, active.data() ) );
+      ret.insert( ret.end(), active.begin(), active.end() );
+    }
+
+    double min, max;
+    MDAL_D_minimumMaximum( ds, &min, &max );
+    ret.push_back( min );
+    ret.push_back( max );
+  }
+  return ret;
+}
+
+TEST( MeshAsciiDatTest, IndexedMode )
+{
+  const std::vector<std::string> files =
+  {
+    "/ascii_dat/quad_and_triangle_vertex_vector.dat",
+    "/ascii_dat/quad_and_triangle_vertex_scalar.dat",
+    "/ascii_dat/quad_and_triangle_vertex_vector_old.dat",
+    "/ascii_dat/quad_and_triangle_els_scalar.dat"
+  };
+
+  for ( const std::string &file : files )
+  {
+    MDAL_MeshH m = mesh();
+    MDAL_SetAsciiDatIndexedMode( false );
+    const std::vector<double> inMemory = load_all_values( m, test_file( file ) );
+    MDAL_SetAsciiDatIndexedMode( true );
+    EXPECT_TRUE( MDAL_AsciiDatIndexedMode() );
+    const std::vector<double> indexed = load_all_values( m, test_file( file ) );
+    MDAL_SetAsciiDatIndexedMode( false );
+    EXPECT_FALSE( MDAL_AsciiDatIndexedMode() );
+
+    ASSERT_FALSE( inMemory.empty() );
+    ASSERT_EQ( inMemory.size(), indexed.size() ) << file;
+    for ( size_t i = 0; i < inMemory.size(); ++i )
+    {
+      if ( std::isnan( inMemory[i] ) )
+        EXPECT_TRUE( std::isnan( indexed[i] ) ) << file;
+      else
+        EXPECT_DOUBLE_EQ( inMemory[i], indexed[i] ) << file;
+    }
+    MDAL_CloseMesh( m );
+  }
+}
+
+TEST( MeshAsciiDatTest, DataPointer )
+{
+  MDAL_MeshH m = mesh();
+  std::string path = test_file( "/ascii_dat/quad_and_triangle_vertex_vector.dat" );
+  MDAL_M_LoadDatasets( m, path.c_str() );
+  ASSERT_EQ( 2, MDAL_M_datasetGroupCount( m ) );
+
+  MDAL_DatasetH ds = MDAL_G_dataset( MDAL_M_datasetGroup( m, 1 ), 0 );
+  ASSERT_NE( ds, nullptr );
+  EXPECT_TRUE( MDAL_D_hasDataPtrCapability( ds, MDAL_DataType::VECTOR_2D_DOUBLE ) );
+  EXPECT_FALSE( MDAL_D_hasDataPtrCapability( ds, MDAL_DataType::ACTIVE_INTEGER ) );
+  EXPECT_FALSE( MDAL_D_hasDataPtrCapability( ds, MDAL_DataType::SCALAR_DOUBLE ) );
+  EXPECT_EQ( nullptr, MDAL_D_dataPtr( ds, MDAL_DataType::SCALAR_DOUBLE, nullptr ) );
+  EXPECT_EQ( MDAL_Status::Err_IncompatibleDataset, MDAL_LastStatus() );
+
+  int stride = 0;
+  const double *values = static_cast<const double *>( MDAL_D_dataPtr( ds, MDAL_DataType::VECTOR_2D_DOUBLE, &stride ) );
+  ASSERT_NE( values, nullptr );
+  EXPECT_EQ( 2, stride );
+  for ( int i = 0; i < MDAL_D_valueCount( ds ); ++i )
+  {
+    EXPECT_DOUBLE_EQ( getValueX( ds, i ), values[i * stride] );
+    EXPECT_DOUBLE_EQ( getValueY( ds, i ), values[i * stride + 1] );
+  }
+
+  MDAL_CloseMesh( m );
+
+  // values are not in memory in indexed mode
+  m = mesh();
+  MDAL_SetAsciiDatIndexedMode( true );
+  MDAL_M_LoadDatasets( m, path.c_str() );
+  MDAL_SetAsciiDatIndexedMode( false );
+  ds = MDAL_G_dataset( MDAL_M_datasetGroup( m, 1 ), 0 );
+  ASSERT_NE( ds, nullptr );
+  EXPECT_FALSE( MDAL_D_hasDataPtrCapability( ds, MDAL_DataType::VECTOR_2D_DOUBLE ) );
+  MDAL_CloseMesh( m );
+}
+
+TEST( MeshAsciiDatTest, TimeSeries )
+{
+  // in-memory datasets are gathered from the values, indexed ones read dataset by dataset
+  for ( bool indexed : { false, true } )
+  {
+    MDAL_SetAsciiDatIndexedMode( indexed );
+    MDAL_MeshH m = mesh();
+    std::string path = test_file( "/ascii_dat/quad_and_triangle_vertex_scalar.dat" );
+    MDAL_M_LoadDatasets( m, path.c_str() );
+    path = test_file( "/ascii_dat/quad_and_triangle_vertex_vector.dat" );
+    MDAL_M_LoadDatasets( m, path.c_str() );
+
+    for ( int i = 0; i < MDAL_M_datasetGroupCount( m ); ++i )
+    {
+      MDAL_DatasetGroupH g = MDAL_M_datasetGroup( m, i );
+      EXPECT_TRUE( compareTimeSeries( g, {4, 0, 2} ) );
+    }
+
+    MDAL_CloseMesh( m );
+  }
+  MDAL_SetAsciiDatIndexedMode( false );
+}
+
 int main( int argc, char **argv )
 {
   testing::InitGoogleTest( &argc, argv );
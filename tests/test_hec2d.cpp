@@ -12,6 +12,70 @@
 #include "mdal.h"
 #include "mdal_utils.hpp"
 #include "mdal_testutils.hpp"
+#include "frmts/mdal_hec2d.hpp"
+
+//! Face to cell interpolation as it was done before Hec2DFaceToCellOperator, normals computed for each pair
+static std::vector<double> referenceFaceToCell( size_t cellCount,
+    const std::vector<int> &cellFaceInfo,
+    const std::vector<int> &cellFaceOrValues,
+    const std::vector<int> &facePointIndex,
+    const std::vector<double> &coords,
+    const std::vector<double> &faceValues )
+{
+  std::vector<double> result( 2 * cellCount, std::numeric_limits<double>::quiet_NaN() );
+  for ( size_t cell = 0; cell < cellCount; ++cell )
+  {
+    size_t firstPosition = static_cast<size_t>( cellFaceInfo[cell * 2] );
+    size_t faceCount = static_cast<size_t>( cellFaceInfo[cell * 2 + 1] );
+    double valx = 0;
+    double valy = 0;
+    size_t consideredValueCount = 0;
+    for ( size_t f = 0; f < faceCount; ++f )
+    {
+      size_t faceIndex1 = static_cast<size_t>( cellFaceOrValues[( firstPosition + f ) * 2] );
+      size_t faceIndex2 = static_cast<size_t>( cellFaceOrValues[( firstPosition + ( f + 1 ) % faceCount ) * 2] );
+      double val1 = faceValues[faceIndex1];
+      double val2 = faceValues[faceIndex2];
+      if ( std::isnan( val1 ) || std::isnan( val2 ) )
+        continue;
+
+      size_t indexPoint11 = facePointIndex[faceIndex1 * 2];
+      size_t indexPoint12 = facePointIndex[faceIndex1 * 2 + 1];
+      size_t indexPoint21 = facePointIndex[faceIndex2 * 2];
+      size_t indexPoint22 = facePointIndex[faceIndex2 * 2 + 1];
+      if ( indexPoint11 != indexPoint21 && indexPoint11 != indexPoint22 &&
+           indexPoint12 != indexPoint21 && indexPoint12 != indexPoint22 )
+        continue;
+
+      double dx1 = coords[indexPoint11 * 2] - coords[indexPoint12 * 2];
+      double dy1 = coords[indexPoint11 * 2 + 1] - coords[indexPoint12 * 2 + 1];
+      double dx2 = coords[indexPoint21 * 2] - coords[indexPoint22 * 2];
+      double dy2 = coords[indexPoint21 * 2 + 1] - coords[indexPoint22 * 2 + 1];
+      double l1 = sqrt( dx1 * dx1 + dy1 * dy1 );
+      double l2 = sqrt( dx2 * dx2 + dy2 * dy2 );
+      if ( l1 == 0 || l2 == 0 )
+        continue;
+      double nx1 = -dy1 / l1;
+      double ny1 = dx1 / l1;
+      double nx2 = -dy2 / l2;
+      double ny2 = dx2 / l2;
+      double deter = nx1 * ny2 - nx2 * ny1;
+      if ( deter == 0 )
+        continue;
+
+      valx += ( ny2 * val1 - ny1 * val2 ) / deter;
+      valy += ( nx1 * val2 - nx2 * val1 ) / deter;
+      consideredValueCount++;
+    }
+
+    if ( consideredValueCount != 0 )
+    {
+      result[2 * cell] = valx / consideredValueCount;
+      result[2 * cell + 1] = valy / consideredValueCount;
+    }
+  }
+  return result;
+}
 
 TEST( MeshHec2dTest, simpleArea )
 {
@@ -301,6 +365,32 @@ TEST( MeshHec2dTest, MultiAreas )
 
   EXPECT_TRUE( compareReferenceTime( g, "1999-01-01T12:00:00" ) );
 
+  // ///////////
+  // Vector Dataset, values are read by flow areas on request
+  // ///////////
+  g = MDAL_M_datasetGroup( m, 5 );
+  ASSERT_NE( g, nullptr );
+  EXPECT_EQ( std::string( "Velocity" ), std::string( MDAL_G_name( g ) ) );
+  EXPECT_FALSE( MDAL_G_hasScalarData( g ) );
+  ds = MDAL_G_dataset( g, 5 );
+  ASSERT_NE( ds, nullptr );
+
+  std::vector<double> allValues( 2 * 725 );
+  EXPECT_EQ( 725, MDAL_D_data( ds, 0, 725, MDAL_DataType::VECTOR_2D_DOUBLE, allValues.data() ) );
+  // without the cache only the faces of the requested cells are read
+  const long long cacheSize = MDAL_BlockCacheSize();
+  MDAL_SetBlockCacheSize( 0 );
+  std::vector<double> partValues( 2 * 400 );
+  EXPECT_EQ( 400, MDAL_D_data( ds, 300, 400, MDAL_DataType::VECTOR_2D_DOUBLE, partValues.data() ) );
+  MDAL_SetBlockCacheSize( cacheSize );
+  for ( size_t i = 0; i < partValues.size(); ++i )
+  {
+    if ( std::isnan( allValues[600 + i] ) )
+      EXPECT_TRUE( std::isnan( partValues[i] ) );
+    else
+      EXPECT_DOUBLE_EQ( allValues[600 + i], partValues[i] );
+  }
+
   MDAL_CloseMesh( m );
 }
 
@@ -697,6 +787,78 @@ TEST( MeshHec2dTest, geometryFile )
 }
 
 
+TEST( MeshHec2dTest, FaceToCellOperator )
+{
+  // 3x3 distorted grid of face points, 2x2 quad cells and one extra cell with a face of zero length
+  std::vector<double> coords;
+  for ( int j = 0; j < 3; ++j )
+    for ( int i = 0; i < 3; ++i )
+    {
+      coords.push_back( i * 10.0 + i * j * 0.7 );
+      coords.push_back( j * 10.0 + ( ( i + j ) % 2 ) * 1.3 );
+    }
+  coords.push_back( coords[0] );
+  coords.push_back( coords[1] );
+
+  std::vector<int> facePointIndex;
+  for ( int j = 0; j < 3; ++j )
+    for ( int i = 0; i < 2; ++i )
+      facePointIndex.insert( facePointIndex.end(), {j * 3 + i, j * 3 + i + 1} );
+  for ( int j = 0; j < 2; ++j )
+    for ( int i = 0; i < 3; ++i )
+      facePointIndex.insert( facePointIndex.end(), {j * 3 + i, ( j + 1 ) * 3 + i} );
+  facePointIndex.insert( facePointIndex.end(), {0, 9} );
+  const size_t faceCount = facePointIndex.size() / 2;
+
+  std::vector<int> cellFaceInfo;
+  std::vector<int> cellFaceOrValues;
+  auto addCell = [&]( std::vector<int> faces )
+  {
+    cellFaceInfo.push_back( static_cast<int>( cellFaceOrValues.size() / 2 ) );
+    cellFaceInfo.push_back( static_cast<int>( faces.size() ) );
+    for ( int face : faces )
+      cellFaceOrValues.insert( cellFaceOrValues.end(), {face, 1} );
+  };
+  for ( int j = 0; j < 2; ++j )
+    for ( int i = 0; i < 2; ++i )
+      addCell( {j * 2 + i, 6 + j * 3 + i + 1, ( j + 1 ) * 2 + i, 6 + j * 3 + i} );
+  addCell( {0, 12, 6} );
+  const size_t cellCount = cellFaceInfo.size() / 2;
+
+  std::vector<double> faceValues( faceCount );
+  for ( size_t i = 0; i < faceCount; ++i )
+    faceValues[i] = 0.5 + 0.37 * static_cast<double>( i * i % 7 ) - 0.8 * static_cast<double>( i % 3 );
+  faceValues[5] = std::numeric_limits<double>::quiet_NaN();
+
+  const std::vector<double> expected = referenceFaceToCell( cellCount, cellFaceInfo, cellFaceOrValues, facePointIndex, coords, faceValues );
+
+  MDAL::Hec2DFaceToCellOperator faceToCell( cellCount, faceCount, cellFaceInfo, cellFaceOrValues, facePointIndex, coords );
+  EXPECT_EQ( cellCount, faceToCell.cellCount() );
+  EXPECT_EQ( faceCount, faceToCell.faceCount() );
+
+  std::vector<double> values( 2 * cellCount, std::numeric_limits<double>::quiet_NaN() );
+  size_t firstFace = 0;
+  size_t endFace = 0;
+  faceToCell.faceRange( 0, cellCount, firstFace, endFace );
+  EXPECT_EQ( 0, firstFace );
+  EXPECT_EQ( faceCount - 1, endFace ); // the face of zero length is not used
+  faceToCell.apply( faceValues.data(), 0, 0, cellCount, values.data() );
+  for ( size_t i = 0; i < values.size(); ++i )
+  {
+    EXPECT_FALSE( std::isnan( values[i] ) );
+    EXPECT_DOUBLE_EQ( expected[i], values[i] );
+  }
+
+  // part of the cells only, with values of their faces only
+  faceToCell.faceRange( 2, 2, firstFace, endFace );
+  EXPECT_EQ( 2, firstFace );
+  EXPECT_EQ( 12, endFace );
+  std::vector<double> partValues( 4, std::numeric_limits<double>::quiet_NaN() );
+  faceToCell.apply( faceValues.data() + firstFace, firstFace, 2, 2, partValues.data() );
+  for ( size_t i = 0; i < partValues.size(); ++i )
+    EXPECT_DOUBLE_EQ( expected[4 + i], partValues[i] );
+}
+
 int main( int argc, char **argv )
 {
   testing::InitGoogleTest( &argc, argv );
@@ -6,6 +6,8 @@
 #include "gtest/gtest.h"
 #include <string>
 #include <vector>
+#include <fstream>
+#include <iterator>
 
 //mdal
 #include "mdal.h"
@@ -359,6 +361,8 @@ static void testVectorDatasetGroupAdded( MDAL_DatasetGroupH r )
   double value = getValueX( ds, 8667 );
   EXPECT_TRUE( MDAL::equals( 4.66666, value, 0.0001 ) );
 
+  value = getValueY( ds, 8667 );
+  EXPECT_TRUE( MDAL::equals( 5, value, 0.0001 ) );
 }
 
 TEST( MeshSLFTest, WriteDatasetInExistingFile )
@@ -896,6 +900,126 @@ TEST( MeshSLFTest, FudaaFileSimplePrecision )
   MDAL_CloseMesh( m );
 }
 
+TEST( MeshSLFTest, IrregularRecords )
+{
+  const std::string original = test_file( "/slf/example_res_fr.slf" );
+  std::ifstream in( original, std::ifstream::binary );
+  std::string content( ( std::istreambuf_iterator<char>( in ) ), std::istreambuf_iterator<char>() );
+  in.close();
+  ASSERT_GT( content.size(), 8 );
+
+  // big-endian length of the last record from its trailing marker
+  size_t lastRecordSize = 0;
+  for ( size_t i = content.size() - 4; i < content.size(); ++i )
+    lastRecordSize = ( lastRecordSize << 8 ) | static_cast<unsigned char>( content[i] );
+  ASSERT_LT( lastRecordSize + 8, content.size() );
+
+  // wrong trailing marker of the last frame, timesteps are indexed by the sequential pass
+  const std::string path = tmp_file( "/slf_irregular_records.slf" );
+  std::string modified = content;
+  modified[modified.size() - 1] ^= 0x7f;
+  std::ofstream out( path, std::ofstream::binary | std::ofstream::trunc );
+  out << modified;
+  out.close();
+
+  MDAL_MeshH m = MDAL_LoadMesh( path.c_str() );
+  ASSERT_NE( m, nullptr );
+  EXPECT_EQ( MDAL_Status::None, MDAL_LastStatus() );
+  ASSERT_EQ( 4, MDAL_M_datasetGroupCount( m ) );
+  testPreExistingScalarDatasetGroup( MDAL_M_datasetGroup( m, 2 ) );
+  testPreExisitingVectorDatasetGroup( MDAL_M_datasetGroup( m, 0 ) );
+  MDAL_CloseMesh( m );
+
+  // wrong leading marker of the last record, the file is rejected
+  modified = content;
+  modified[modified.size() - lastRecordSize - 5] ^= 0x7f;
+  out.open( path, std::ofstream::binary | std::ofstream::trunc );
+  out << modified;
+  out.close();
+
+  m = MDAL_LoadMesh( path.c_str() );
+  EXPECT_EQ( m, nullptr );
+  EXPECT_NE( MDAL_Status::None, MDAL_LastStatus() );
+  MDAL_CloseMesh( m );
+
+  deleteFile( path );
+}
+
+TEST( MeshSLFTest, TimeSeries )
+{
+  std::string path = test_file( "/slf/example_res_fr.slf" );
+  MDAL_MeshH m = MDAL_LoadMesh( path.c_str() );
+  ASSERT_NE( m, nullptr );
+
+  for ( int i = 0; i < MDAL_M_datasetGroupCount( m ); ++i )
+  {
+    MDAL_DatasetGroupH g = MDAL_M_datasetGroup( m, i );
+    EXPECT_TRUE( compareTimeSeries( g, {0, 20, 13540} ) );
+  }
+
+  MDAL_CloseMesh( m );
+}
+
+TEST( MeshSLFTest, PrefetchTimesteps )
+{
+  std::string path = test_file( "/slf/example_res_fr.slf" );
+  MDAL_MeshH m = MDAL_LoadMesh( path.c_str() );
+  ASSERT_NE( m, nullptr );
+
+  MDAL_DatasetGroupH g = MDAL_M_datasetGroup( m, 2 );
+  ASSERT_NE( g, nullptr );
+  ASSERT_TRUE( MDAL_G_datasetCount( g ) > 1 );
+  EXPECT_EQ( 0, MDAL_G_prefetchWindow( g ) );
+
+  // expected values read without prefetching
+  MDAL_DatasetH ds1 = MDAL_G_dataset( g, 1 );
+  const int count = MDAL_D_valueCount( ds1 );
+  std::vector<double> expected( count );
+  EXPECT_EQ( count, MDAL_D_data( ds1, 0, count, MDAL_DataType::SCALAR_DOUBLE, expected.data() ) );
+
+  MDAL_ClearBlockCache();
+  MDAL_G_setPrefetchWindow( g, 2 );
+  EXPECT_EQ( 2, MDAL_G_prefetchWindow( g ) );
+
+  std::vector<double> values( count );
+  MDAL_DatasetH ds0 = MDAL_G_dataset( g, 0 );
+  EXPECT_EQ( count, MDAL_D_data( ds0, 0, count, MDAL_DataType::SCALAR_DOUBLE, values.data() ) );
+
+  // the next timesteps are scheduled by MDAL_D_data, wait until they are read and stop
+  // prefetching, so the counters only change by the following request
+  MDAL_WaitForPrefetching();
+  MDAL_G_setPrefetchWindow( g, 0 );
+  EXPECT_EQ( 0, MDAL_G_prefetchWindow( g ) );
+
+  // prefetched timestep is read from the cache
+  long long hits = 0;
+  long long misses = 0;
+  MDAL_BlockCacheCounters( &hits, &misses );
+  const long long hitsBefore = hits;
+  const long long missesBefore = misses;
+  EXPECT_EQ( count, MDAL_D_data( ds1, 0, count, MDAL_DataType::SCALAR_DOUBLE, values.data() ) );
+  MDAL_BlockCacheCounters( &hits, &misses );
+  EXPECT_GT( hits, hitsBefore );
+  EXPECT_EQ( missesBefore, misses );
+  EXPECT_EQ( expected, values );
+
+  // background thread stopped with the last group is started again
+  MDAL_ClearBlockCache();
+  MDAL_G_setPrefetchWindow( g, 1 );
+  EXPECT_EQ( count, MDAL_D_data( ds0, 0, count, MDAL_DataType::SCALAR_DOUBLE, values.data() ) );
+  MDAL_WaitForPrefetching();
+  MDAL_G_setPrefetchWindow( g, 0 );
+
+  MDAL_BlockCacheCounters( &hits, &misses );
+  const long long missesAfterRestart = misses;
+  EXPECT_EQ( count, MDAL_D_data( ds1, 0, count, MDAL_DataType::SCALAR_DOUBLE, values.data() ) );
+  MDAL_BlockCacheCounters( &hits, &misses );
+  EXPECT_EQ( missesAfterRestart, misses );
+
+  // closing the mesh cancels prefetching of its groups
+  MDAL_CloseMesh( m );
+}
+
 int main( int argc, char **argv )
 {
   testing::InitGoogleTest( &argc, argv );
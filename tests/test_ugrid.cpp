@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include <math.h>
+#include <netcdf.h>
 
 //mdal
 #include "mdal.h"
@@ -45,6 +46,59 @@ TEST( MeshUgridTest, SaveQuadAndTriangle )
   );
 }
 
+TEST( MeshUgridTest, SaveQuadAndTriangleUncompressed )
+{
+  const int level = MDAL_NetCDFCompressionLevel();
+  MDAL_SetNetCDFCompression( 0, false );
+  saveAndCompareMesh(
+    test_file( "/2dm/quad_and_triangle.2dm" ),
+    tmp_file( "/quad_and_triangle_saveTestUncompressed.nc" ),
+    "Ugrid"
+  );
+  MDAL_SetNetCDFCompression( level, true );
+}
+
+TEST( MeshUgridTest, SaveQuadAndTriangleCompressed )
+{
+  const int level = MDAL_NetCDFCompressionLevel();
+  MDAL_SetNetCDFCompression( 5, true );
+  EXPECT_EQ( 5, MDAL_NetCDFCompressionLevel() );
+
+  const std::string savedFile = tmp_file( "/quad_and_triangle_saveTestCompressed.nc" );
+  saveAndCompareMesh(
+    test_file( "/2dm/quad_and_triangle.2dm" ),
+    savedFile,
+    "Ugrid"
+  );
+
+  int ncid;
+  ASSERT_EQ( NC_NOERR, nc_open( savedFile.c_str(), NC_NOWRITE, &ncid ) );
+  int format = 0;
+  EXPECT_EQ( NC_NOERR, nc_inq_format( ncid, &format ) );
+  EXPECT_EQ( NC_FORMAT_NETCDF4, format );
+
+  for ( const char *varName : { "mesh2d_node_x", "mesh2d_node_y", "mesh2d_node_z", "mesh2d_face_nodes" } )
+  {
+    int varid;
+    ASSERT_EQ( NC_NOERR, nc_inq_varid( ncid, varName, &varid ) );
+
+    int storage = NC_CONTIGUOUS;
+    size_t chunks[2] = {0, 0};
+    EXPECT_EQ( NC_NOERR, nc_inq_var_chunking( ncid, varid, &storage, chunks ) );
+    EXPECT_EQ( NC_CHUNKED, storage );
+    EXPECT_GT( chunks[0], 0 );
+
+    int shuffle = 0, deflate = 0, deflateLevel = 0;
+    EXPECT_EQ( NC_NOERR, nc_inq_var_deflate( ncid, varid, &shuffle, &deflate, &deflateLevel ) );
+    EXPECT_EQ( 1, shuffle );
+    EXPECT_EQ( 1, deflate );
+    EXPECT_EQ( 5, deflateLevel );
+  }
+  nc_close( ncid );
+
+  MDAL_SetNetCDFCompression( level, true );
+}
+
 TEST( MeshUgridTest, DFlow11Manzese )
 {
   std::string path = test_file( "/ugrid/D-Flow1.1/manzese_1d2d_small_map.nc" );
@@ -3,6 +3,8 @@
  Copyright (C) 2019 Peter Petrik (zilolv at gmail dot com)
 */
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
 
 //mdal
 #include "mdal.h"
@@ -312,6 +314,18 @@ TEST( XdmfTest, Basement3Slopes )
     double value = getValue( ds, 7493 );
     EXPECT_DOUBLE_EQ( 7.0036239300095486, value );
 
+    // function evaluated from the file in chunks gives the same values as the cached full read
+    std::vector<double> values( count );
+    ASSERT_EQ( count, MDAL_D_data( ds, 0, count, MDAL_DataType::SCALAR_DOUBLE, values.data() ) );
+    const long long cacheSize = MDAL_BlockCacheSize();
+    MDAL_SetBlockCacheSize( 0 );
+    std::vector<double> chunk( 1000 );
+    ASSERT_EQ( 1000, MDAL_D_data( ds, 7000, 1000, MDAL_DataType::SCALAR_DOUBLE, chunk.data() ) );
+    MDAL_SetBlockCacheSize( cacheSize );
+    EXPECT_TRUE( std::equal( chunk.begin(), chunk.end(), values.begin() + 7000,
+                             []( double a, double b ) { return ( std::isnan( a ) && std::isnan( b ) ) || a == b; } ) );
+    EXPECT_DOUBLE_EQ( 7.0036239300095486, chunk[493] );
+
     double min, max;
     MDAL_D_minimumMaximum( ds, &min, &max );
     EXPECT_DOUBLE_EQ( 1.4142135623730951, min );
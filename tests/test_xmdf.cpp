@@ -101,6 +101,56 @@ TEST( MeshXmdfTest, RegularGridScalarDataset )
     EXPECT_DOUBLE_EQ( 0.17372334003448486, value );
   }
 
+  {
+    // values and active flags of the whole timestep at once
+    int facesCount = MDAL_M_faceCount( m );
+    std::vector<double> values( count );
+    std::vector<int> active( facesCount );
+    ASSERT_EQ( count, MDAL_D_dataWithActive( ds, MDAL_DataType::SCALAR_DOUBLE, values.data(), active.data() ) );
+
+    std::vector<double> expectedValues( count );
+    std::vector<int> expectedActive( facesCount );
+    ASSERT_EQ( count, MDAL_D_data( ds, 0, count, MDAL_DataType::SCALAR_DOUBLE, expectedValues.data() ) );
+    ASSERT_EQ( facesCount, MDAL_D_data( ds, 0, facesCount, MDAL_DataType::ACTIVE_INTEGER, expectedActive.data() ) );
+    EXPECT_EQ( values, expectedValues );
+    EXPECT_EQ( active, expectedActive );
+    EXPECT_DOUBLE_EQ( 0.17372334003448486, values[60] );
+
+    EXPECT_EQ( 0, MDAL_D_dataWithActive( ds, MDAL_DataType::VECTOR_2D_DOUBLE, values.data(), active.data() ) );
+    EXPECT_EQ( MDAL_Status::Err_IncompatibleDataset, MDAL_LastStatus() );
+
+    // without budget the flags are not cached and are read from the file for each request
+    const long long budget = MDAL_BlockCacheSize();
+    MDAL_SetBlockCacheSize( 0 );
+    MDAL_DatasetH ds49 = MDAL_G_dataset( g, 49 );
+    ASSERT_EQ( count, MDAL_D_dataWithActive( ds49, MDAL_DataType::SCALAR_DOUBLE, values.data(), active.data() ) );
+    ASSERT_EQ( facesCount, MDAL_D_data( ds49, 0, facesCount, MDAL_DataType::ACTIVE_INTEGER, expectedActive.data() ) );
+    EXPECT_EQ( active, expectedActive );
+    std::vector<int> partActive( 5 );
+    ASSERT_EQ( 5, MDAL_D_data( ds49, 60, 5, MDAL_DataType::ACTIVE_INTEGER, partActive.data() ) );
+    EXPECT_EQ( partActive, std::vector<int>( active.begin() + 60, active.begin() + 65 ) );
+
+    // active flags of more timesteps than the budget holds are evicted, values are still cached
+    MDAL_SetBlockCacheSize( count * sizeof( double ) + 4096 );
+    for ( int i = 0; i < MDAL_M_datasetGroupCount( m ); ++i )
+    {
+      MDAL_DatasetGroupH group = MDAL_M_datasetGroup( m, i );
+      for ( int j = 0; j < MDAL_G_datasetCount( group ); ++j )
+        MDAL_D_data( MDAL_G_dataset( group, j ), 0, facesCount, MDAL_DataType::ACTIVE_INTEGER, active.data() );
+    }
+
+    long long hits = 0;
+    long long misses = 0;
+    ASSERT_EQ( count, MDAL_D_data( ds, 0, count, MDAL_DataType::SCALAR_DOUBLE, values.data() ) );
+    MDAL_BlockCacheCounters( &hits, &misses );
+    const long long hitsBefore = hits;
+    ASSERT_EQ( count, MDAL_D_data( ds, 0, count, MDAL_DataType::SCALAR_DOUBLE, values.data() ) );
+    MDAL_BlockCacheCounters( &hits, &misses );
+    EXPECT_GT( hits, hitsBefore );
+    EXPECT_EQ( values, expectedValues );
+    MDAL_SetBlockCacheSize( budget );
+  }
+
   double min, max;
   MDAL_D_minimumMaximum( ds, &min, &max );
   EXPECT_DOUBLE_EQ( 0, min );
@@ -645,6 +695,38 @@ TEST( MeshXmdfTest, MultipleMeshes )
   EXPECT_DOUBLE_EQ( 3, maxY );
 }
 
+TEST( MeshXmdfTest, TimeSeries )
+{
+  std::string path = test_file( "/2dm/regular_grid.2dm" );
+  MDAL_MeshH m = MDAL_LoadMesh( path.c_str() );
+  ASSERT_NE( m, nullptr );
+  path = test_file( "/xmdf/regular_grid.xmdf" );
+  MDAL_M_LoadDatasets( m, path.c_str() );
+  EXPECT_EQ( MDAL_Status::None, MDAL_LastStatus() );
+
+  for ( int i = 0; i < MDAL_M_datasetGroupCount( m ); ++i )
+  {
+    MDAL_DatasetGroupH g = MDAL_M_datasetGroup( m, i );
+    EXPECT_TRUE( compareTimeSeries( g, {0, 1, 1000, 1975} ) );
+  }
+
+  // depth at one vertex
+  MDAL_DatasetGroupH g = MDAL_M_datasetGroup( m, 4 );
+  std::vector<double> hydrograph( 61 );
+  EXPECT_EQ( 61, MDAL_G_timeSeries( g, 1000, 0, 61, hydrograph.data() ) );
+  EXPECT_DOUBLE_EQ( getValue( MDAL_G_dataset( g, 50 ), 1000 ), hydrograph[50] );
+
+  // range of datasets
+  EXPECT_EQ( 11, MDAL_G_timeSeries( g, 1000, 50, 100, hydrograph.data() ) );
+  EXPECT_DOUBLE_EQ( getValue( MDAL_G_dataset( g, 50 ), 1000 ), hydrograph[0] );
+
+  // invalid element
+  EXPECT_EQ( 0, MDAL_G_timeSeries( g, 1976, 0, 61, hydrograph.data() ) );
+  EXPECT_EQ( MDAL_Status::Err_IncompatibleDataset, MDAL_LastStatus() );
+
+  MDAL_CloseMesh( m );
+}
+
 int main( int argc, char **argv )
 {
   testing::InitGoogleTest( &argc, argv );
@@ -7,10 +7,15 @@
 #include <cmath>
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <memory>
 
 //mdal
 #include "mdal.h"
 #include "mdal_utils.hpp"
+#include "mdal_block_cache.hpp"
+#include "mdal_regular_grid_mesh.hpp"
 #include "mdal_testutils.hpp"
 
 struct SplitTestData
@@ -359,3 +364,300 @@ TEST( MdalUtilsTest, LibraryTest )
   std::function<void ( int )> funct = library.getSymbol<int, int>( "function" );
   EXPECT_FALSE( funct );
 }
+
+TEST( MdalUtilsTest, Statistics )
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  // scalar with NaN and inactive values
+  std::vector<double> scalars = {nan, 2.0, -1.0, 5.0, 7.0, nan, 3.0};
+  std::vector<int> active = {1, 1, 1, 1, 0, 1, 1};
+  MDAL::Statistics stats = MDAL::calculateStatistics( scalars.data(), scalars.size(), false, nullptr );
+  EXPECT_DOUBLE_EQ( stats.minimum, -1.0 );
+  EXPECT_DOUBLE_EQ( stats.maximum, 7.0 );
+  stats = MDAL::calculateStatistics( scalars.data(), scalars.size(), false, active.data() );
+  EXPECT_DOUBLE_EQ( stats.minimum, -1.0 );
+  EXPECT_DOUBLE_EQ( stats.maximum, 5.0 );
+
+  // vector magnitudes, NaN in one of the components invalidates the value
+  std::vector<double> vectors = {3.0, 4.0, nan, 1.0, 0.0, -1.0, 6.0, 8.0, 1.0, nan};
+  stats = MDAL::calculateStatistics( vectors.data(), vectors.size() / 2, true, nullptr );
+  EXPECT_DOUBLE_EQ( stats.minimum, 1.0 );
+  EXPECT_DOUBLE_EQ( stats.maximum, 10.0 );
+
+  // only invalid values
+  std::vector<double> invalid = {nan, nan, nan};
+  stats = MDAL::calculateStatistics( invalid.data(), invalid.size(), false, nullptr );
+  EXPECT_TRUE( std::isnan( stats.minimum ) );
+  EXPECT_TRUE( std::isnan( stats.maximum ) );
+
+  // large buffer split between threads
+  std::vector<double> large( 1000003 );
+  std::vector<int> largeActive( large.size(), 1 );
+  for ( size_t i = 0; i < large.size(); ++i )
+    large[i] = ( i % 7 == 0 ) ? nan : static_cast<double>( i % 1000 );
+  large[500000] = -10.0;
+  large[999999] = 2000.0;
+  largeActive[999999] = 0;
+  stats = MDAL::calculateStatistics( large.data(), large.size(), false, largeActive.data() );
+  EXPECT_DOUBLE_EQ( stats.minimum, -10.0 );
+  EXPECT_DOUBLE_EQ( stats.maximum, 999.0 );
+}
+
+TEST( MdalUtilsTest, ParallelFor )
+{
+  std::vector<int> visited( 100000, 0 );
+  MDAL::parallelFor( visited.size(), 1000, [&]( size_t begin, size_t end )
+  {
+    for ( size_t i = begin; i < end; ++i )
+      visited[i] += 1;
+  } );
+
+  EXPECT_EQ( std::count( visited.begin(), visited.end(), 1 ), static_cast<long>( visited.size() ) );
+
+  // nested call processes the whole range in the block of the outer call
+  std::vector<int> innerBlocks( 16, 0 );
+  MDAL::parallelFor( innerBlocks.size(), 1, [&]( size_t begin, size_t end )
+  {
+    for ( size_t i = begin; i < end; ++i )
+    {
+      MDAL::parallelFor( 100000, 1, [&]( size_t innerBegin, size_t innerEnd )
+      {
+        if ( innerBegin == 0 && innerEnd == 100000 )
+          innerBlocks[i] += 1;
+        else
+          innerBlocks[i] += 100;
+      } );
+    }
+  } );
+
+  EXPECT_EQ( std::count( innerBlocks.begin(), innerBlocks.end(), 1 ), static_cast<long>( innerBlocks.size() ) );
+
+  // exception of any block is rethrown on the calling thread
+  EXPECT_THROW( MDAL::parallelFor( visited.size(), 1000, [&]( size_t, size_t end )
+  {
+    if ( end == visited.size() )
+      throw std::runtime_error( "last block" );
+  } ), std::runtime_error );
+
+  // threads are reused by following calls
+  MDAL::parallelFor( visited.size(), 1000, [&]( size_t begin, size_t end )
+  {
+    for ( size_t i = begin; i < end; ++i )
+      visited[i] += 1;
+  } );
+  EXPECT_EQ( std::count( visited.begin(), visited.end(), 2 ), static_cast<long>( visited.size() ) );
+}
+
+TEST( MdalUtilsTest, ParseInPlace )
+{
+  const std::string line = "ND  12 1.5e3 -0.125 2.0000000000000000000001\r";
+  std::vector<MDAL::StringView> tokens;
+  MDAL::split( line.data(), line.data() + line.size(), ' ', tokens );
+  ASSERT_EQ( tokens.size(), 5 );
+  EXPECT_EQ( std::string( tokens[0].first, tokens[0].second ), "ND" );
+  EXPECT_EQ( MDAL::toSizeT( tokens[1].first, tokens[1].second ), 12 );
+  EXPECT_DOUBLE_EQ( MDAL::toDouble( tokens[2].first, tokens[2].second ), 1500 );
+  EXPECT_DOUBLE_EQ( MDAL::toDouble( tokens[3].first, tokens[3].second ), -0.125 );
+  // last token contains carriage return and too many digits for the fast path
+  EXPECT_DOUBLE_EQ( MDAL::toDouble( tokens[4].first, tokens[4].second ), 2.0 );
+
+  const char *values[] = {"0.1", "3.14159265358979", "-1e-30", "123456789012345678901", "1.7976931348623157e308", "4.5abc"};
+  for ( const char *value : values )
+    EXPECT_EQ( MDAL::toDouble( value, value + strlen( value ) ), atof( value ) ) << value;
+
+  const std::string negative = "-5";
+  EXPECT_EQ( MDAL::toSizeT( negative.data(), negative.data() + negative.size() ), 0 );
+}
+
+TEST( MdalUtilsTest, BlockCache )
+{
+  MDAL::BlockCache::setBudget( 16 * 1024 * 1024 );
+  MDAL::BlockCache::clear();
+
+  // the dataset is used only as a key
+  int key = 0;
+  const MDAL::Dataset *dataset = reinterpret_cast<const MDAL::Dataset *>( &key );
+  const size_t valuesCount = 200000;
+  size_t readCalls = 0;
+  MDAL::BlockCache::ReadFunction read = [&]( size_t indexStart, size_t count, double * buffer )
+  {
+    ++readCalls;
+    for ( size_t i = 0; i < count; ++i )
+    {
+      buffer[2 * i] = static_cast<double>( indexStart + i );
+      buffer[2 * i + 1] = -static_cast<double>( indexStart + i );
+    }
+    return count;
+  };
+
+  std::vector<double> buffer( 2 * 1000 );
+  EXPECT_EQ( 1000, MDAL::BlockCache::read( dataset, valuesCount, 2, 65000, 1000, buffer.data(), read ) );
+  EXPECT_EQ( 1, readCalls ); // two blocks read at once
+  EXPECT_DOUBLE_EQ( 65000, buffer[0] );
+  EXPECT_DOUBLE_EQ( -65999, buffer[1999] );
+
+  EXPECT_EQ( 10, MDAL::BlockCache::read( dataset, valuesCount, 2, 65530, 10, buffer.data(), read ) );
+  EXPECT_EQ( 1, readCalls );
+  EXPECT_DOUBLE_EQ( 65530, buffer[0] );
+  EXPECT_EQ( 2, MDAL::BlockCache::misses() );
+  EXPECT_EQ( 2, MDAL::BlockCache::hits() );
+  const size_t usedBytes = MDAL::BlockCache::usedBytes();
+  EXPECT_GT( usedBytes, 0 );
+
+  // one-off scan is not inserted, only the values after the cached blocks are read
+  const size_t largeCount = 400000;
+  std::vector<double> large( 2 * largeCount );
+  readCalls = 0;
+  {
+    MDAL::BlockCache::ScanScope scan;
+    EXPECT_EQ( largeCount, MDAL::BlockCache::read( dataset, largeCount, 2, 0, largeCount, large.data(), read ) );
+  }
+  EXPECT_EQ( 1, readCalls );
+  EXPECT_EQ( 2, MDAL::BlockCache::misses() );
+  EXPECT_EQ( 4, MDAL::BlockCache::hits() );
+  EXPECT_EQ( usedBytes, MDAL::BlockCache::usedBytes() );
+  bool largeMatches = true;
+  for ( size_t i = 0; i < largeCount; ++i )
+    largeMatches &= large[2 * i] == static_cast<double>( i ) && large[2 * i + 1] == -static_cast<double>( i );
+  EXPECT_TRUE( largeMatches );
+
+  // large request within the budget inserts its blocks, repeated request is read from the cache
+  readCalls = 0;
+  EXPECT_EQ( largeCount, MDAL::BlockCache::read( dataset, largeCount, 2, 0, largeCount, large.data(), read ) );
+  EXPECT_EQ( 1, readCalls );
+  EXPECT_EQ( 7, MDAL::BlockCache::misses() );
+  EXPECT_EQ( largeCount, MDAL::BlockCache::read( dataset, largeCount, 2, 0, largeCount, large.data(), read ) );
+  EXPECT_EQ( 1, readCalls );
+  EXPECT_EQ( 13, MDAL::BlockCache::hits() );
+  largeMatches = true;
+  for ( size_t i = 0; i < largeCount; ++i )
+    largeMatches &= large[2 * i] == static_cast<double>( i ) && large[2 * i + 1] == -static_cast<double>( i );
+  EXPECT_TRUE( largeMatches );
+
+  // blocks above the budget evict the least recently used ones
+  MDAL::BlockCache::setBudget( 4 * 1024 * 1024 );
+  EXPECT_LE( MDAL::BlockCache::usedBytes(), 4 * 1024 * 1024 );
+  EXPECT_EQ( 10, MDAL::BlockCache::read( dataset, largeCount, 2, largeCount - 10, 10, buffer.data(), read ) );
+  EXPECT_EQ( 1, readCalls );
+  EXPECT_EQ( 10, MDAL::BlockCache::read( dataset, largeCount, 2, 0, 10, buffer.data(), read ) );
+  EXPECT_EQ( 2, readCalls );
+
+  // active flags are cached as blocks and evicted with them
+  const std::vector<uint64_t> flags( 3 * 1024 * 1024 / sizeof( uint64_t ), 5 );
+  EXPECT_EQ( nullptr, MDAL::BlockCache::activeFlags( dataset, 1 ) );
+  MDAL::BlockCache::insertActiveFlags( dataset, 1, std::make_shared<std::vector<uint64_t>>( flags ) );
+  ASSERT_NE( nullptr, MDAL::BlockCache::activeFlags( dataset, 1 ) );
+  EXPECT_EQ( flags, *MDAL::BlockCache::activeFlags( dataset, 1 ) );
+  EXPECT_EQ( nullptr, MDAL::BlockCache::activeFlags( dataset, 2 ) );
+  EXPECT_LE( MDAL::BlockCache::usedBytes(), 4 * 1024 * 1024 );
+  MDAL::BlockCache::insertActiveFlags( dataset, 2, std::make_shared<std::vector<uint64_t>>( flags ) );
+  EXPECT_EQ( nullptr, MDAL::BlockCache::activeFlags( dataset, 1 ) );
+  ASSERT_NE( nullptr, MDAL::BlockCache::activeFlags( dataset, 2 ) );
+
+  // values are still cached after the flags
+  readCalls = 0;
+  EXPECT_EQ( 10, MDAL::BlockCache::read( dataset, largeCount, 2, 0, 10, buffer.data(), read ) );
+  EXPECT_EQ( 10, MDAL::BlockCache::read( dataset, largeCount, 2, 0, 10, buffer.data(), read ) );
+  EXPECT_EQ( 1, readCalls );
+  MDAL::BlockCache::setBudget( 16 * 1024 * 1024 );
+
+  // out of range
+  EXPECT_EQ( 0, MDAL::BlockCache::read( dataset, valuesCount, 2, valuesCount, 10, buffer.data(), read ) );
+  EXPECT_EQ( 5, MDAL::BlockCache::read( dataset, valuesCount, 2, valuesCount - 5, 10, buffer.data(), read ) );
+  EXPECT_DOUBLE_EQ( valuesCount - 1, buffer[8] );
+
+  MDAL::BlockCache::removeDataset( dataset );
+  EXPECT_EQ( 0, MDAL::BlockCache::usedBytes() );
+
+  // disabled cache reads directly
+  MDAL::BlockCache::setBudget( 0 );
+  readCalls = 0;
+  EXPECT_EQ( 10, MDAL::BlockCache::read( dataset, valuesCount, 2, 0, 10, buffer.data(), read ) );
+  EXPECT_EQ( 10, MDAL::BlockCache::read( dataset, valuesCount, 2, 0, 10, buffer.data(), read ) );
+  EXPECT_EQ( 2, readCalls );
+  EXPECT_EQ( 0, MDAL::BlockCache::usedBytes() );
+
+  MDAL::BlockCache::setBudget( 64 * 1024 * 1024 );
+  MDAL::BlockCache::clear();
+}
+
+TEST( MdalUtilsTest, ChunkCacheSize )
+{
+  size_t chunkBytes = 0;
+  // 100 timesteps x 10000 faces in chunks of 10 timesteps x 1000 faces
+  const std::vector<size_t> dims = {100, 10000};
+  const std::vector<size_t> chunks = {10, 1000};
+  EXPECT_EQ( 10 * 80000, MDAL::chunkCacheSize( dims, chunks, 8, 32 * 1024 * 1024, chunkBytes ) );
+  EXPECT_EQ( 80000, chunkBytes );
+
+  // limited by the budget, but at least one chunk
+  EXPECT_EQ( 200000, MDAL::chunkCacheSize( dims, chunks, 8, 200000, chunkBytes ) );
+  EXPECT_EQ( 80000, MDAL::chunkCacheSize( dims, chunks, 8, 1000, chunkBytes ) );
+
+  // time series of variable with only time dimension
+  EXPECT_EQ( 10 * 800, MDAL::chunkCacheSize( {1000}, {100}, 8, 32 * 1024 * 1024, chunkBytes ) );
+
+  EXPECT_EQ( 0, MDAL::chunkCacheSize( dims, {10}, 8, 1000, chunkBytes ) );
+}
+
+TEST( MdalUtilsTest, Setting )
+{
+  MDAL::Setting setting( "MDAL_TEST_SETTING_NOT_SET", 1024, 5 );
+  EXPECT_EQ( 5, setting.value() );
+  setting.setValue( 10 );
+  EXPECT_EQ( 10, setting.value() );
+  setting.setValue( -10 );
+  EXPECT_EQ( 0, setting.value() );
+}
+
+TEST( MdalUtilsTest, RegularGridMesh )
+{
+  const double gt[6] = {100, 10, 0, 50, 0, -5};
+  MDAL::RegularGridMesh mesh( "test", "test.tif", 4, 3, gt );
+  EXPECT_EQ( 12, mesh.verticesCount() );
+  EXPECT_EQ( 6, mesh.facesCount() );
+  EXPECT_FALSE( mesh.isLongitudeShifted() );
+
+  MDAL::BBox extent = mesh.extent();
+  EXPECT_DOUBLE_EQ( 105, extent.minX );
+  EXPECT_DOUBLE_EQ( 135, extent.maxX );
+  EXPECT_DOUBLE_EQ( 37.5, extent.minY );
+  EXPECT_DOUBLE_EQ( 47.5, extent.maxY );
+
+  std::vector<double> coordinates( 3 * 12 );
+  std::unique_ptr<MDAL::MeshVertexIterator> vertices = mesh.readVertices();
+  EXPECT_EQ( 5, vertices->next( 5, coordinates.data() ) );
+  EXPECT_EQ( 7, vertices->next( 10, coordinates.data() + 15 ) );
+  EXPECT_EQ( 0, vertices->next( 10, coordinates.data() ) );
+  EXPECT_DOUBLE_EQ( 115, coordinates[15] ); // vertex 5
+  EXPECT_DOUBLE_EQ( 42.5, coordinates[16] );
+  EXPECT_DOUBLE_EQ( 135, coordinates[33] ); // vertex 11
+  EXPECT_DOUBLE_EQ( 37.5, coordinates[34] );
+
+  std::vector<int> offsets( 6 );
+  std::vector<int> indices( 24 );
+  std::unique_ptr<MDAL::MeshFaceIterator> faces = mesh.readFaces();
+  EXPECT_EQ( 6, faces->next( 6, offsets.data(), 24, indices.data() ) );
+  EXPECT_EQ( 24, offsets[5] );
+  std::vector<int> face4( indices.begin() + 16, indices.begin() + 20 );
+  EXPECT_EQ( std::vector<int>( {10, 9, 5, 6} ), face4 );
+
+  // whole earth with longitudes 0 - 360
+  const double globalGt[6] = {0, 90, 0, 90, 0, -90};
+  MDAL::RegularGridMesh globalMesh( "test", "test.tif", 4, 2, globalGt );
+  EXPECT_TRUE( globalMesh.isLongitudeShifted() );
+  EXPECT_EQ( 3, globalMesh.facesCount() );
+  EXPECT_DOUBLE_EQ( -135, globalMesh.vertex( 2, 0 ).x );
+  extent = globalMesh.extent();
+  EXPECT_DOUBLE_EQ( -135, extent.minX );
+  EXPECT_DOUBLE_EQ( 135, extent.maxX );
+
+  size_t faceVertices[4];
+  globalMesh.faceVertices( 0, faceVertices ); // added over prime meridian
+  EXPECT_EQ( std::vector<size_t>( {4, 7, 3, 0} ), std::vector<size_t>( faceVertices, faceVertices + 4 ) );
+  globalMesh.faceVertices( 1, faceVertices );
+  EXPECT_EQ( std::vector<size_t>( {5, 4, 0, 1} ), std::vector<size_t>( faceVertices, faceVertices + 4 ) );
+  globalMesh.faceVertices( 2, faceVertices ); // face over antimeridian is omitted
+  EXPECT_EQ( std::vector<size_t>( {7, 6, 2, 3} ), std::vector<size_t>( faceVertices, faceVertices + 4 ) );
+}